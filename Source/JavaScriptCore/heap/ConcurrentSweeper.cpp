@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2015 Lauri Kasanen
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ConcurrentSweeper.h"
+
+#include "Heap.h"
+#include "JSCInlines.h"
+#include "MarkedBlock.h"
+#include <wtf/CurrentTime.h>
+#include <wtf/DataLog.h>
+
+namespace JSC {
+
+ConcurrentSweeper::ConcurrentSweeper(Heap* heap)
+    : m_heap(heap)
+{
+}
+
+ConcurrentSweeper::~ConcurrentSweeper()
+{
+    if (!m_threadID)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_shouldStop = true;
+        m_shouldExit = true;
+        m_condition.notify_all();
+    }
+    waitForThreadCompletion(m_threadID);
+}
+
+void ConcurrentSweeper::startSweeping()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    ASSERT(!m_isSweeping);
+
+    m_blocks.clear();
+    m_nextBlock = 0;
+    m_heap->objectSpace().blocksToSweepConcurrently(m_blocks);
+    if (m_blocks.isEmpty())
+        return;
+
+    if (!m_threadID)
+        m_threadID = createThread(threadStartFunc, this, "JSC::Sweeping");
+    m_condition.notify_all();
+}
+
+void ConcurrentSweeper::stopSweeping()
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    if (!m_isSweeping && m_nextBlock >= m_blocks.size())
+        return;
+
+    m_shouldStop = true;
+    m_condition.wait(lock, [this] { return !m_isSweeping; });
+    m_shouldStop = false;
+
+    m_blocks.clear();
+    m_nextBlock = 0;
+}
+
+void ConcurrentSweeper::logSweepTimes()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    dataLogF("swept %zu blocks on the mutator (%.2f ms), %zu concurrently (%.2f ms), ",
+        m_mutatorBlocksSwept, m_mutatorSweepTime * 1000, m_helperBlocksSwept, m_helperSweepTime * 1000);
+
+    m_mutatorSweepTime = 0;
+    m_mutatorBlocksSwept = 0;
+    m_helperSweepTime = 0;
+    m_helperBlocksSwept = 0;
+}
+
+void ConcurrentSweeper::threadStartFunc(void* data)
+{
+    static_cast<ConcurrentSweeper*>(data)->threadMain();
+}
+
+void ConcurrentSweeper::threadMain()
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    for (;;) {
+        m_condition.wait(lock, [this] { return m_shouldExit || m_nextBlock < m_blocks.size(); });
+        if (m_shouldExit)
+            return;
+
+        m_isSweeping = true;
+        double start = WTF::monotonicallyIncreasingTime();
+        size_t blocksSwept = 0;
+
+        // The mutator only waits for us between blocks, so a block is never
+        // left half swept.
+        while (!m_shouldStop && m_nextBlock < m_blocks.size()) {
+            MarkedBlock* block = m_blocks[m_nextBlock++];
+            lock.unlock();
+            if (block->sweepConcurrently())
+                blocksSwept++;
+            lock.lock();
+        }
+
+        m_helperSweepTime += WTF::monotonicallyIncreasingTime() - start;
+        m_helperBlocksSwept += blocksSwept;
+        m_blocks.clear();
+        m_nextBlock = 0;
+        m_isSweeping = false;
+        m_condition.notify_all();
+    }
+}
+
+} // namespace JSC
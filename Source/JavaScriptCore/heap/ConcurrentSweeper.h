@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2015 Lauri Kasanen
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ConcurrentSweeper_h
+#define ConcurrentSweeper_h
+
+#include <condition_variable>
+#include <mutex>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+class Heap;
+class MarkedBlock;
+
+// Sweeps blocks of objects without destructors into free lists on a helper
+// thread, after a collection has finished marking. The allocators pick the
+// free lists up as they reach each block; only the weak sets are still swept
+// on the mutator. Blocks with destructors are left to the mutator, since
+// destructors can call back into code that isn't thread safe.
+class ConcurrentSweeper {
+    WTF_MAKE_NONCOPYABLE(ConcurrentSweeper);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    explicit ConcurrentSweeper(Heap*);
+    ~ConcurrentSweeper();
+
+    void startSweeping();
+
+    // Waits until the helper is no longer touching any block. This has to be
+    // called before blocks are freed or their mark bits change.
+    void stopSweeping();
+
+    void didSweepOnMutator(double seconds)
+    {
+        m_mutatorSweepTime += seconds;
+        m_mutatorBlocksSwept++;
+    }
+
+    void logSweepTimes();
+
+private:
+    static void threadStartFunc(void*);
+    void threadMain();
+
+    Heap* m_heap;
+    ThreadIdentifier m_threadID { 0 };
+
+    std::mutex m_lock;
+    std::condition_variable m_condition;
+    Vector<MarkedBlock*> m_blocks;
+    size_t m_nextBlock { 0 };
+    bool m_isSweeping { false };
+    bool m_shouldStop { false };
+    bool m_shouldExit { false };
+
+    double m_helperSweepTime { 0 };
+    size_t m_helperBlocksSwept { 0 };
+    double m_mutatorSweepTime { 0 };
+    size_t m_mutatorBlocksSwept { 0 };
+};
+
+} // namespace JSC
+
+#endif // ConcurrentSweeper_h
@@ -22,6 +22,7 @@
 #include "Heap.h"
 
 #include "CodeBlock.h"
+#include "ConcurrentSweeper.h"
 #include "ConservativeRoots.h"
 #include "CopiedSpace.h"
 #include "CopiedSpaceInlines.h"
@@ -357,6 +358,7 @@ Heap::Heap(VM* vm, HeapType heapType)
 #else
     , m_sweeper(std::make_unique<IncrementalSweeper>(this->vm()))
 #endif
+    , m_concurrentSweeper(std::make_unique<ConcurrentSweeper>(this))
     , m_deferralDepth(0)
 #if USE(CF)
     , m_delayedReleaseRecursionCount(0)
@@ -1035,6 +1037,7 @@ NEVER_INLINE void Heap::collectImpl(HeapOperation collectionType, void* stackOri
     RELEASE_ASSERT(m_operationInProgress == NoOperation);
 
     suspendCompilerThreads();
+    stopConcurrentSweeping();
     willStartCollection(collectionType);
     GCPHASE(Collect);
 
@@ -1082,6 +1085,7 @@ NEVER_INLINE void Heap::collectImpl(HeapOperation collectionType, void* stackOri
     updateAllocationLimits();
     didFinishCollection(gcStartTime);
     resumeCompilerThreads();
+    startConcurrentSweeping();
 
     if (m_verifier) {
         m_verifier->trimDeadObjects();
@@ -1239,6 +1243,24 @@ void Heap::notifyIncrementalSweeper()
     }
 }
 
+void Heap::stopConcurrentSweeping()
+{
+    GCPHASE(StopConcurrentSweeping);
+    m_concurrentSweeper->stopSweeping();
+    if (Options::logGC())
+        m_concurrentSweeper->logSweepTimes();
+}
+
+void Heap::startConcurrentSweeping()
+{
+    // Zombie mode and immortal objects write to dead cells themselves.
+    if (!Options::useConcurrentSweeping() || Options::useZombieMode() || Options::objectsAreImmortal())
+        return;
+
+    GCPHASE(StartConcurrentSweeping);
+    m_concurrentSweeper->startSweeping();
+}
+
 void Heap::rememberCurrentlyExecutingCodeBlocks()
 {
     GCPHASE(RememberCurrentlyExecutingCodeBlocks);
@@ -57,6 +57,7 @@ class GlobalCodeBlock;
 class Heap;
 class HeapRootVisitor;
 class HeapVerifier;
+class ConcurrentSweeper;
 class IncrementalSweeper;
 class JITStubRoutine;
 class JSCell;
@@ -130,6 +131,7 @@ public:
 
     JS_EXPORT_PRIVATE IncrementalSweeper* sweeper();
     JS_EXPORT_PRIVATE void setIncrementalSweeper(std::unique_ptr<IncrementalSweeper>);
+    ConcurrentSweeper* concurrentSweeper() { return m_concurrentSweeper.get(); }
 
     // true if collection is in progress
     bool isCollecting();
@@ -313,6 +315,8 @@ private:
     void snapshotMarkedSpace();
     void deleteSourceProviderCaches();
     void notifyIncrementalSweeper();
+    void stopConcurrentSweeping();
+    void startConcurrentSweeping();
     void rememberCurrentlyExecutingCodeBlocks();
     void resetAllocators();
     void copyBackingStores();
@@ -397,6 +401,7 @@ private:
     RefPtr<GCActivityCallback> m_fullActivityCallback;
     RefPtr<GCActivityCallback> m_edenActivityCallback;
     std::unique_ptr<IncrementalSweeper> m_sweeper;
+    std::unique_ptr<ConcurrentSweeper> m_concurrentSweeper;
     Vector<MarkedBlock*> m_blockSnapshot;
     
     unsigned m_deferralDepth;
@@ -26,6 +26,7 @@
 #include "config.h"
 #include "MarkedAllocator.h"
 
+#include "ConcurrentSweeper.h"
 #include "GCActivityCallback.h"
 #include "Heap.h"
 #include "IncrementalSweeper.h"
@@ -71,7 +72,10 @@ inline void* MarkedAllocator::tryAllocateHelper(size_t bytes)
     for (MarkedBlock*& block = m_nextBlockToSweep; block; block = next) {
         next = block->next();
 
+        double sweepStart = Options::logGC() ? WTF::monotonicallyIncreasingTime() : 0;
         MarkedBlock::FreeList freeList = block->sweep(MarkedBlock::SweepToFreeList);
+        if (sweepStart)
+            m_heap->concurrentSweeper()->didSweepOnMutator(WTF::monotonicallyIncreasingTime() - sweepStart);
         
         double utilization = ((double)MarkedBlock::blockSize - (double)freeList.bytes) / (double)MarkedBlock::blockSize;
         if (utilization >= Options::minMarkedBlockUtilization()) {
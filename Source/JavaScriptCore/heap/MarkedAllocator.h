@@ -29,6 +29,7 @@ public:
     bool needsDestruction() { return m_needsDestruction; }
     void* allocate(size_t);
     Heap* heap() { return m_heap; }
+    MarkedBlock* nextBlockToSweep() const { return m_nextBlockToSweep; }
     MarkedBlock* takeLastActiveBlock()
     {
         MarkedBlock* block = m_lastActiveBlock;
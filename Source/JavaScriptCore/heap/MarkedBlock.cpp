@@ -30,6 +30,7 @@
 #include "JSCell.h"
 #include "JSDestructibleObject.h"
 #include "JSCInlines.h"
+#include <thread>
 
 namespace JSC {
 
@@ -52,6 +53,7 @@ MarkedBlock::MarkedBlock(MarkedAllocator* allocator, size_t capacity, size_t cel
     , m_needsDestruction(needsDestruction)
     , m_allocator(allocator)
     , m_state(New) // All cells start out unmarked.
+    , m_concurrentSweepState(NotSwept)
     , m_weakSet(allocator->heap()->vm(), *this)
 {
     ASSERT(allocator);
@@ -79,7 +81,21 @@ MarkedBlock::FreeList MarkedBlock::specializedSweep()
     ASSERT(!(!callDestructors && sweepMode == SweepOnly));
 
     SamplingRegion samplingRegion((!callDestructors && blockState != New) ? "Calling destructors" : "sweeping");
-    
+
+    FreeList freeList = sweepCells<blockState, sweepMode, callDestructors>();
+
+    // We only want to discard the newlyAllocated bits if we're creating a FreeList,
+    // otherwise we would lose information on what's currently alive.
+    if (sweepMode == SweepToFreeList && m_newlyAllocated)
+        m_newlyAllocated = nullptr;
+
+    m_state = ((sweepMode == SweepToFreeList) ? FreeListed : Marked);
+    return freeList;
+}
+
+template<MarkedBlock::BlockState blockState, MarkedBlock::SweepMode sweepMode, bool callDestructors>
+MarkedBlock::FreeList MarkedBlock::sweepCells()
+{
     // This produces a free list that is ordered in reverse through the block.
     // This is fine, since the allocation code makes no assumptions about the
     // order of the free list.
@@ -102,15 +118,51 @@ MarkedBlock::FreeList MarkedBlock::specializedSweep()
         }
     }
 
-    // We only want to discard the newlyAllocated bits if we're creating a FreeList,
-    // otherwise we would lose information on what's currently alive.
-    if (sweepMode == SweepToFreeList && m_newlyAllocated)
-        m_newlyAllocated = nullptr;
-
-    m_state = ((sweepMode == SweepToFreeList) ? FreeListed : Marked);
     return FreeList(head, count * cellSize());
 }
 
+bool MarkedBlock::sweepConcurrently()
+{
+    ASSERT(!m_needsDestruction);
+
+    uint8_t expected = NotSwept;
+    if (!m_concurrentSweepState.compare_exchange_strong(expected, Sweeping))
+        return false;
+
+    // Only blocks that the last collection left Marked, and that nothing has
+    // allocated in since, have liveness data we can sweep from.
+    if (m_state != Marked || m_newlyAllocated) {
+        m_concurrentSweepState.store(NotSwept);
+        return false;
+    }
+
+    m_concurrentlySweptFreeList = sweepCells<Marked, SweepToFreeList, false>();
+    m_concurrentSweepState.store(Swept);
+    return true;
+}
+
+bool MarkedBlock::takeConcurrentlySweptFreeList(FreeList& freeList)
+{
+    uint8_t state = NotSwept;
+    if (m_concurrentSweepState.compare_exchange_strong(state, Claimed))
+        return false;
+
+    // The helper is in the middle of this block. It's a short wait, and
+    // sweeping it again here would take as long.
+    while (state == Sweeping) {
+        std::this_thread::yield();
+        state = m_concurrentSweepState.load();
+    }
+
+    if (state != Swept)
+        return false;
+
+    m_concurrentSweepState.store(Claimed);
+    freeList = m_concurrentlySweptFreeList;
+    m_concurrentlySweptFreeList = FreeList();
+    return true;
+}
+
 MarkedBlock::FreeList MarkedBlock::sweep(SweepMode sweepMode)
 {
     HEAP_LOG_BLOCK_STATE_TRANSITION(this);
@@ -141,6 +193,14 @@ MarkedBlock::FreeList MarkedBlock::sweepHelper(SweepMode sweepMode)
         RELEASE_ASSERT_NOT_REACHED();
         return FreeList();
     case Marked:
+        if (!callDestructors && sweepMode == SweepToFreeList) {
+            FreeList freeList;
+            if (takeConcurrentlySweptFreeList(freeList)) {
+                ASSERT(!m_newlyAllocated);
+                m_state = FreeListed;
+                return freeList;
+            }
+        }
         return sweepMode == SweepToFreeList
             ? specializedSweep<Marked, SweepToFreeList, callDestructors>()
             : specializedSweep<Marked, SweepOnly, callDestructors>();
@@ -229,6 +289,10 @@ void MarkedBlock::clearMarksWithCollectionType()
     ASSERT(collectionType == FullCollection || collectionType == EdenCollection);
     HEAP_LOG_BLOCK_STATE_TRANSITION(this);
 
+    // A free list swept ahead of time is stale once the marks change.
+    m_concurrentSweepState.store(NotSwept, std::memory_order_relaxed);
+    m_concurrentlySweptFreeList = FreeList();
+
     ASSERT(m_state != New && m_state != FreeListed);
     if (collectionType == FullCollection) {
         m_marks.clearAll();
@@ -27,6 +27,7 @@
 #include "HeapOperation.h"
 #include "IterationStatus.h"
 #include "WeakSet.h"
+#include <atomic>
 #include <wtf/Bitmap.h>
 #include <wtf/DataLog.h>
 #include <wtf/DoublyLinkedList.h>
@@ -129,6 +130,11 @@ namespace JSC {
         enum SweepMode { SweepOnly, SweepToFreeList };
         FreeList sweep(SweepMode = SweepOnly);
 
+        // Called by the ConcurrentSweeper. Builds the free list that the next
+        // sweep(SweepToFreeList) returns, without touching the block's state.
+        // Returns false if the mutator claimed the block first.
+        bool sweepConcurrently();
+
         void shrink();
 
         void visitWeakSet(HeapRootVisitor&);
@@ -192,7 +198,9 @@ namespace JSC {
         static const size_t atomAlignmentMask = atomSize - 1; // atomSize must be a power of two.
 
         enum BlockState { New, FreeListed, Allocated, Marked, Retired };
+        enum ConcurrentSweepState : uint8_t { NotSwept, Sweeping, Swept, Claimed };
         template<bool callDestructors> FreeList sweepHelper(SweepMode = SweepOnly);
+        bool takeConcurrentlySweptFreeList(FreeList&);
 
         typedef char Atom[atomSize];
 
@@ -201,6 +209,7 @@ namespace JSC {
         size_t atomNumber(const void*);
         void callDestructor(JSCell*);
         template<BlockState, SweepMode, bool callDestructors> FreeList specializedSweep();
+        template<BlockState, SweepMode, bool callDestructors> FreeList sweepCells();
         
         MarkedBlock* m_prev;
         MarkedBlock* m_next;
@@ -220,6 +229,8 @@ namespace JSC {
         bool m_needsDestruction;
         MarkedAllocator* m_allocator;
         BlockState m_state;
+        std::atomic<uint8_t> m_concurrentSweepState;
+        FreeList m_concurrentlySweptFreeList;
         WeakSet m_weakSet;
     };
 
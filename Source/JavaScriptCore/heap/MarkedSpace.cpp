@@ -21,6 +21,7 @@
 #include "config.h"
 #include "MarkedSpace.h"
 
+#include "ConcurrentSweeper.h"
 #include "IncrementalSweeper.h"
 #include "JSGlobalObject.h"
 #include "JSLock.h"
@@ -109,12 +110,14 @@ struct LastChanceToFinalize {
 
 void MarkedSpace::lastChanceToFinalize()
 {
+    m_heap->concurrentSweeper()->stopSweeping();
     stopAllocating();
     forEachAllocator<LastChanceToFinalize>();
 }
 
 void MarkedSpace::sweep()
 {
+    m_heap->concurrentSweeper()->stopSweeping();
     m_heap->sweeper()->willFinishSweeping();
     forEachBlock<Sweep>();
 }
@@ -123,6 +126,7 @@ void MarkedSpace::zombifySweep()
 {
     if (Options::logGC())
         dataLog("Zombifying sweep...");
+    m_heap->concurrentSweeper()->stopSweeping();
     m_heap->sweeper()->willFinishSweeping();
     forEachBlock<ZombifySweep>();
 }
@@ -147,6 +151,35 @@ void MarkedSpace::resetAllocators()
 #endif
 }
 
+// Blocks of objects without destructors, interleaved across the allocators in
+// the order each of them will sweep its own, so the helper stays ahead of all.
+void MarkedSpace::blocksToSweepConcurrently(Vector<MarkedBlock*>& blocks)
+{
+    Vector<MarkedBlock*, preciseCount + impreciseCount + 1> cursors;
+    for (size_t i = 0; i < preciseCount; ++i) {
+        if (MarkedBlock* block = m_normalSpace.preciseAllocators[i].nextBlockToSweep())
+            cursors.append(block);
+    }
+    for (size_t i = 0; i < impreciseCount; ++i) {
+        if (MarkedBlock* block = m_normalSpace.impreciseAllocators[i].nextBlockToSweep())
+            cursors.append(block);
+    }
+    if (MarkedBlock* block = m_normalSpace.largeAllocator.nextBlockToSweep())
+        cursors.append(block);
+
+    while (!cursors.isEmpty()) {
+        for (size_t i = 0; i < cursors.size();) {
+            blocks.append(cursors[i]);
+            if (MarkedBlock* next = cursors[i]->next()) {
+                cursors[i++] = next;
+                continue;
+            }
+            cursors[i] = cursors.last();
+            cursors.removeLast();
+        }
+    }
+}
+
 void MarkedSpace::visitWeakSets(HeapRootVisitor& heapRootVisitor)
 {
     VisitWeakSet visitWeakSet(heapRootVisitor);
@@ -246,6 +279,7 @@ void MarkedSpace::freeOrShrinkBlock(MarkedBlock* block)
         return;
     }
 
+    m_heap->concurrentSweeper()->stopSweeping();
     freeBlock(block);
 }
 
@@ -255,6 +289,7 @@ struct Shrink : MarkedBlock::VoidFunctor {
 
 void MarkedSpace::shrink()
 {
+    m_heap->concurrentSweeper()->stopSweeping();
     Free freeOrShrink(Free::FreeOrShrink, this);
     forEachBlock(freeOrShrink);
 }
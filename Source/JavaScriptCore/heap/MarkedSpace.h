@@ -141,6 +141,8 @@ public:
     void didConsumeFreeList(MarkedBlock*);
     void didAllocateInBlock(MarkedBlock*);
 
+    void blocksToSweepConcurrently(Vector<MarkedBlock*>&);
+
     void clearMarks();
     void clearRememberedSet();
     void clearNewlyAllocated();
@@ -31,12 +31,14 @@
 #if HAVE(LLVM)
 
 #include "InitializeLLVMPOSIX.h"
+#include "Options.h"
 
 namespace JSC {
 
 LLVMInitializerFunction getLLVMInitializerFunction(bool verbose)
 {
-    return getLLVMInitializerFunctionPOSIX("libllvmForJSC.so", verbose);
+    const char* libraryPath = Options::llvmLibraryPath();
+    return getLLVMInitializerFunctionPOSIX(libraryPath ? libraryPath : "libllvmForJSC.so", verbose);
 }
 
 } // namespace JSC
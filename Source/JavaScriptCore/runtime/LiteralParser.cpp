@@ -37,8 +37,13 @@
 #include "StrongInlines.h"
 #include <wtf/ASCIICType.h>
 #include <wtf/dtoa.h>
+#include <wtf/text/ASCIIFastPath.h>
 #include <wtf/text/StringBuilder.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace JSC {
 
 template <typename CharType>
@@ -49,6 +54,54 @@ static inline bool isJSONWhiteSpace(const CharType& c)
     return c == ' ' || c == 0x9 || c == 0xA || c == 0xD;
 }
 
+#if defined(__SSE2__)
+static inline const LChar* skipJSONWhiteSpaceSSE2(const LChar* ptr, const LChar* end)
+{
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8(0x9);
+    const __m128i lineFeed = _mm_set1_epi8(0xA);
+    const __m128i carriageReturn = _mm_set1_epi8(0xD);
+    for (; end - ptr >= 16; ptr += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        __m128i white = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, lineFeed), _mm_cmpeq_epi8(chunk, carriageReturn)));
+        if (unsigned mask = ~_mm_movemask_epi8(white) & 0xFFFF)
+            return ptr + __builtin_ctz(mask);
+    }
+    return ptr;
+}
+
+static inline const UChar* skipJSONWhiteSpaceSSE2(const UChar* ptr, const UChar* end)
+{
+    const __m128i space = _mm_set1_epi16(' ');
+    const __m128i tab = _mm_set1_epi16(0x9);
+    const __m128i lineFeed = _mm_set1_epi16(0xA);
+    const __m128i carriageReturn = _mm_set1_epi16(0xD);
+    for (; end - ptr >= 8; ptr += 8) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        __m128i white = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(chunk, space), _mm_cmpeq_epi16(chunk, tab)),
+            _mm_or_si128(_mm_cmpeq_epi16(chunk, lineFeed), _mm_cmpeq_epi16(chunk, carriageReturn)));
+        if (unsigned mask = ~_mm_movemask_epi8(white) & 0xFFFF)
+            return ptr + (__builtin_ctz(mask) >> 1);
+    }
+    return ptr;
+}
+#endif
+
+template <typename CharType>
+static ALWAYS_INLINE const CharType* skipJSONWhiteSpace(const CharType* ptr, const CharType* end)
+{
+#if defined(__SSE2__)
+    // Minified JSON has no white space between tokens and ", " is a single step,
+    // so only switch to the vector scan once the run looks like indentation.
+    if (end - ptr >= 2 && isJSONWhiteSpace(ptr[0]) && isJSONWhiteSpace(ptr[1]))
+        ptr = skipJSONWhiteSpaceSSE2(ptr + 2, end);
+#endif
+    while (ptr < end && isJSONWhiteSpace(*ptr))
+        ++ptr;
+    return ptr;
+}
+
 template <typename CharType>
 bool LiteralParser<CharType>::tryJSONPParse(Vector<JSONPData>& results, bool needsFullSourceInfo)
 {
@@ -172,8 +225,7 @@ ALWAYS_INLINE const Identifier LiteralParser<CharType>::makeIdentifier(const UCh
 template <typename CharType>
 template <ParserMode mode> TokenType LiteralParser<CharType>::Lexer::lex(LiteralParserToken<CharType>& token)
 {
-    while (m_ptr < m_end && isJSONWhiteSpace(*m_ptr))
-        ++m_ptr;
+    m_ptr = skipJSONWhiteSpace(m_ptr, m_end);
 
     ASSERT(m_ptr <= m_end);
     if (m_ptr >= m_end) {
@@ -345,6 +397,25 @@ template <ParserMode mode, typename CharType, UChar terminator> static inline bo
     return (c >= ' ' && (mode == StrictJSON || c <= 0xff) && c != '\\' && c != terminator) || (c == '\t' && mode != StrictJSON);
 }
 
+template <ParserMode mode, typename CharType, char terminator>
+static ALWAYS_INLINE const CharType* skipSafeStringCharacters(const CharType* ptr, const CharType* end)
+{
+    // Outside strict JSON a UChar above 0xFF also ends the run, which
+    // findControlCharacterOr() does not look for.
+    if (sizeof(CharType) == 1 || mode == StrictJSON) {
+        while (true) {
+            ptr = WTF::findControlCharacterOr<CharType>(ptr, end, '\\', terminator);
+            // The scan stops on every control character, but tabs are allowed outside strict JSON.
+            if (ptr == end || !isSafeStringCharacter<mode, CharType, terminator>(*ptr))
+                return ptr;
+            ++ptr;
+        }
+    }
+    while (ptr < end && isSafeStringCharacter<mode, CharType, terminator>(*ptr))
+        ++ptr;
+    return ptr;
+}
+
 template <typename CharType>
 template <ParserMode mode, char terminator> ALWAYS_INLINE TokenType LiteralParser<CharType>::Lexer::lexString(LiteralParserToken<CharType>& token)
 {
@@ -353,8 +424,7 @@ template <ParserMode mode, char terminator> ALWAYS_INLINE TokenType LiteralParse
     StringBuilder builder;
     do {
         runStart = m_ptr;
-        while (m_ptr < m_end && isSafeStringCharacter<mode, CharType, terminator>(*m_ptr))
-            ++m_ptr;
+        m_ptr = skipSafeStringCharacters<mode, CharType, terminator>(m_ptr, m_end);
         if (builder.length())
             builder.append(runStart, m_ptr - runStart);
         if ((mode != NonStrictJSON) && m_ptr < m_end && *m_ptr == '\\') {
@@ -157,6 +157,7 @@ typedef const char* optionString;
     v(bool, enableOSREntryToFTL, true, nullptr) \
     \
     v(bool, useFTLJIT, true, "allows the FTL JIT to be used if true") \
+    v(optionString, llvmLibraryPath, nullptr, "path of the LLVM library the FTL loads; searched for in the library path if unset") \
     v(bool, useFTLTBAA, true, nullptr) \
     v(bool, enableLLVMFastISel, false, nullptr) \
     v(bool, useLLVMSmallCodeModel, false, nullptr) \
@@ -287,6 +288,7 @@ typedef const char* optionString;
     \
     v(bool, useZombieMode, false, "debugging option to scribble over dead objects with 0xdeadbeef") \
     v(bool, objectsAreImmortal, false, "debugging option to keep all objects alive forever") \
+    v(bool, useConcurrentSweeping, false, "sweeps blocks of objects without destructors on a helper thread after each collection") \
     v(bool, showObjectStatistics, false, nullptr) \
     \
     v(gcLogLevel, logGC, GCLogging::None, "debugging option to log GC activity (0 = None, 1 = Basic, 2 = Verbose)") \
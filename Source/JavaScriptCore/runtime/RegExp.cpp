@@ -226,6 +226,7 @@ RegExp::RegExp(VM& vm, const String& patternString, RegExpFlags flags)
     , m_flags(flags)
     , m_constructionError(0)
     , m_numSubpatterns(0)
+    , m_containsBackreferences(false)
 #if ENABLE(REGEXP_TRACING)
     , m_rtMatchOnlyTotalSubjectStringLen(0.0)
     , m_rtMatchTotalSubjectStringLen(0.0)
@@ -243,8 +244,10 @@ void RegExp::finishCreation(VM& vm)
     Yarr::YarrPattern pattern(m_patternString, ignoreCase(), multiline(), &m_constructionError);
     if (m_constructionError)
         m_state = ParseError;
-    else
+    else {
         m_numSubpatterns = pattern.m_numSubpatterns;
+        m_containsBackreferences = pattern.m_containsBackreferences;
+    }
 }
 
 void RegExp::destroy(JSCell* cell)
@@ -287,7 +290,7 @@ void RegExp::compile(VM* vm, Yarr::YarrCharSize charSize)
     }
 
 #if ENABLE(YARR_JIT)
-    if (!pattern.m_containsBackreferences && !pattern.containsUnsignedLengthPattern() && vm->canUseRegExpJIT()) {
+    if (!pattern.containsUnsignedLengthPattern() && vm->canUseRegExpJIT()) {
         Yarr::jitCompile(pattern, charSize, vm, m_regExpJITCode);
 #if ENABLE(YARR_JIT_DEBUG)
         if (!m_regExpJITCode.isFallBack())
@@ -308,6 +311,23 @@ void RegExp::compile(VM* vm, Yarr::YarrCharSize charSize)
     m_regExpBytecode = Yarr::byteCompile(pattern, &vm->m_regExpAllocator);
 }
 
+void RegExp::byteCodeCompileIfNecessary(VM* vm)
+{
+    if (m_regExpBytecode)
+        return;
+
+    Yarr::YarrPattern pattern(m_patternString, ignoreCase(), multiline(), &m_constructionError);
+    if (m_constructionError) {
+        RELEASE_ASSERT_NOT_REACHED();
+#if COMPILER_QUIRK(CONSIDERS_UNREACHABLE_CODE)
+        m_state = ParseError;
+        return;
+#endif
+    }
+
+    m_regExpBytecode = Yarr::byteCompile(pattern, &vm->m_regExpAllocator);
+}
+
 void RegExp::compileIfNecessary(VM& vm, Yarr::YarrCharSize charSize)
 {
     if (hasCode()) {
@@ -347,6 +367,12 @@ int RegExp::match(VM& vm, const String& s, unsigned startOffset, Vector<int, 32>
             result = m_regExpJITCode.execute(s.characters8(), startOffset, s.length(), offsetVector).start;
         else
             result = m_regExpJITCode.execute(s.characters16(), startOffset, s.length(), offsetVector).start;
+
+        // The JIT gives up on matches that need more backtracking state than it keeps.
+        if (result == Yarr::JSRegExpJITCodeFailure) {
+            byteCodeCompileIfNecessary(&vm);
+            result = Yarr::interpret(m_regExpBytecode.get(), s, startOffset, reinterpret_cast<unsigned*>(offsetVector));
+        }
 #if ENABLE(YARR_JIT_DEBUG)
         matchCompareWithInterpreter(s, startOffset, offsetVector, result);
 #endif
@@ -395,6 +421,14 @@ int RegExp::match(VM& vm, const String& s, unsigned startOffset, Vector<int, 32>
 
 void RegExp::compileMatchOnly(VM* vm, Yarr::YarrCharSize charSize)
 {
+#if ENABLE(YARR_JIT_BACKREFERENCES)
+    // Backreferences need the captures, so match-only calls run the full matcher.
+    if (m_containsBackreferences && !ignoreCase()) {
+        compile(vm, charSize);
+        return;
+    }
+#endif
+
     Yarr::YarrPattern pattern(m_patternString, ignoreCase(), multiline(), &m_constructionError);
     if (m_constructionError) {
         RELEASE_ASSERT_NOT_REACHED();
@@ -443,6 +477,12 @@ void RegExp::compileIfNecessaryMatchOnly(VM& vm, Yarr::YarrCharSize charSize)
             return;
         if ((charSize == Yarr::Char16) && (m_regExpJITCode.has16BitCodeMatchOnly()))
             return;
+#if ENABLE(YARR_JIT_BACKREFERENCES)
+        if (m_containsBackreferences && (charSize == Yarr::Char8) && (m_regExpJITCode.has8BitCode()))
+            return;
+        if (m_containsBackreferences && (charSize == Yarr::Char16) && (m_regExpJITCode.has16BitCode()))
+            return;
+#endif
 #else
         return;
 #endif
@@ -463,14 +503,31 @@ MatchResult RegExp::match(VM& vm, const String& s, unsigned startOffset)
 
 #if ENABLE(YARR_JIT)
     if (m_state == JITCode) {
-        MatchResult result = s.is8Bit() ?
-            m_regExpJITCode.execute(s.characters8(), startOffset, s.length()) :
-            m_regExpJITCode.execute(s.characters16(), startOffset, s.length());
+        MatchResult result = MatchResult::failed();
+#if ENABLE(YARR_JIT_BACKREFERENCES)
+        // Backreferences need the captures, so match-only calls run the full matcher.
+        if (m_containsBackreferences) {
+            Vector<int, 32> ovector;
+            ovector.resize((m_numSubpatterns + 1) * 2);
+            result = s.is8Bit() ?
+                m_regExpJITCode.execute(s.characters8(), startOffset, s.length(), ovector.data()) :
+                m_regExpJITCode.execute(s.characters16(), startOffset, s.length(), ovector.data());
+        } else
+#endif
+            result = s.is8Bit() ?
+                m_regExpJITCode.execute(s.characters8(), startOffset, s.length()) :
+                m_regExpJITCode.execute(s.characters16(), startOffset, s.length());
+
+        if (result.start != static_cast<size_t>(Yarr::JSRegExpJITCodeFailure)) {
 #if ENABLE(REGEXP_TRACING)
-        if (!result)
-            m_rtMatchOnlyFoundCount++;
+            if (!result)
+                m_rtMatchOnlyFoundCount++;
 #endif
-        return result;
+            return result;
+        }
+
+        // The JIT gave up on this match; rerun it in the interpreter.
+        byteCodeCompileIfNecessary(&vm);
     }
 #endif
 
@@ -103,6 +103,7 @@ private:
     RegExpState m_state;
 
     void compile(VM*, Yarr::YarrCharSize);
+    void byteCodeCompileIfNecessary(VM*);
     void compileIfNecessary(VM&, Yarr::YarrCharSize);
 
     void compileMatchOnly(VM*, Yarr::YarrCharSize);
@@ -116,6 +117,7 @@ private:
     RegExpFlags m_flags;
     const char* m_constructionError;
     unsigned m_numSubpatterns;
+    bool m_containsBackreferences;
 #if ENABLE(REGEXP_TRACING)
     double m_rtMatchOnlyTotalSubjectStringLen;
     double m_rtMatchTotalSubjectStringLen;
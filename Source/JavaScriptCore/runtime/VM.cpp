@@ -104,6 +104,10 @@
 #include "RegExp.h"
 #endif
 
+#if ENABLE(YARR_JIT)
+#include "YarrJIT.h"
+#endif
+
 #if USE(CF)
 #include <CoreFoundation/CoreFoundation.h>
 #endif
@@ -695,6 +699,16 @@ void logSanitizeStack(VM* vm)
     }
 }
 
+#if ENABLE(YARR_JIT)
+Yarr::YarrParenContextPool& VM::regExpParenContextPool()
+{
+    // Allocated on first use; most pages never compile a pattern that needs it.
+    if (!m_regExpParenContextPool)
+        m_regExpParenContextPool = std::make_unique<Yarr::YarrParenContextPool>();
+    return *m_regExpParenContextPool;
+}
+#endif
+
 #if ENABLE(REGEXP_TRACING)
 void VM::addRegExpToTrace(RegExp* regExp)
 {
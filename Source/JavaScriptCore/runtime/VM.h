@@ -124,6 +124,9 @@ struct ArityCheckData;
 namespace Profiler {
 class Database;
 }
+namespace Yarr {
+class YarrParenContextPool;
+}
 
 struct HashTable;
 struct Instruction;
@@ -463,6 +466,9 @@ public:
     RefPtr<TypedArrayController> m_typedArrayController;
     RegExpCache* m_regExpCache;
     BumpPointerAllocator m_regExpAllocator;
+#if ENABLE(YARR_JIT)
+    std::unique_ptr<Yarr::YarrParenContextPool> m_regExpParenContextPool;
+#endif
 
 #if ENABLE(REGEXP_TRACING)
     typedef ListHashSet<RegExp*> RTTraceList;
@@ -479,6 +485,9 @@ public:
     JS_EXPORT_PRIVATE void stopSampling();
     JS_EXPORT_PRIVATE void dumpSampleData(ExecState*);
     RegExpCache* regExpCache() { return m_regExpCache; }
+#if ENABLE(YARR_JIT)
+    Yarr::YarrParenContextPool& regExpParenContextPool();
+#endif
 #if ENABLE(REGEXP_TRACING)
     void addRegExpToTrace(RegExp*);
 #endif
@@ -25,6 +25,7 @@
 #include "InitializeThreading.h"
 #include "JSCInlines.h"
 #include "JSGlobalObject.h"
+#include "YarrInterpreter.h"
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -50,6 +51,7 @@ WTF_IMPORT extern const struct HashTable globalObjectTable;
 }
 
 const int MaxLineLength = 100 * 1024;
+const unsigned BenchmarkIterations = 1000;
 
 using namespace JSC;
 using namespace WTF;
@@ -58,11 +60,13 @@ struct CommandLine {
     CommandLine()
         : interactive(false)
         , verbose(false)
+        , benchmark(false)
     {
     }
 
     bool interactive;
     bool verbose;
+    bool benchmark;
     Vector<String> arguments;
     Vector<String> files;
 };
@@ -106,6 +110,22 @@ struct RegExpTest {
     Vector<int, 32> expectVector;
 };
 
+// Accumulates the time spent matching one pattern's tests with RegExp, which uses the
+// JIT where it can, and with the interpreter alone.
+struct RegExpBenchmark {
+    RegExpBenchmark()
+        : regexp(0)
+        , jitTime(0)
+        , interpreterTime(0)
+    {
+    }
+
+    RegExp* regexp;
+    std::unique_ptr<Yarr::BytecodePattern> bytecode;
+    double jitTime;
+    double interpreterTime;
+};
+
 class GlobalObject : public JSGlobalObject {
 private:
     GlobalObject(VM&, Structure*, const Vector<String>& arguments);
@@ -263,6 +283,49 @@ static bool testOneRegExp(VM& vm, RegExp* regexp, RegExpTest* regExpTest, bool v
     return result;
 }
 
+static void startBenchmark(VM& vm, RegExp* regexp, RegExpBenchmark& benchmark)
+{
+    benchmark.regexp = regexp;
+    benchmark.bytecode = nullptr;
+    benchmark.jitTime = 0;
+    benchmark.interpreterTime = 0;
+    if (!regexp || !regexp->isValid())
+        return;
+
+    const char* error = 0;
+    Yarr::YarrPattern pattern(regexp->pattern(), regexp->ignoreCase(), regexp->multiline(), &error);
+    if (!error)
+        benchmark.bytecode = Yarr::byteCompile(pattern, &vm.m_regExpAllocator);
+}
+
+static void benchmarkOneRegExp(VM& vm, RegExpBenchmark& benchmark, RegExpTest* regExpTest)
+{
+    if (!benchmark.bytecode)
+        return;
+
+    Vector<int, 32> outVector;
+    double startTime = monotonicallyIncreasingTime();
+    for (unsigned i = 0; i < BenchmarkIterations; ++i)
+        benchmark.regexp->match(vm, regExpTest->subject, regExpTest->offset, outVector);
+    benchmark.jitTime += monotonicallyIncreasingTime() - startTime;
+
+    outVector.resize((benchmark.regexp->numSubpatterns() + 1) * 2);
+    unsigned* offsetVector = reinterpret_cast<unsigned*>(outVector.data());
+    startTime = monotonicallyIncreasingTime();
+    for (unsigned i = 0; i < BenchmarkIterations; ++i)
+        Yarr::interpret(benchmark.bytecode.get(), regExpTest->subject, regExpTest->offset, offsetVector);
+    benchmark.interpreterTime += monotonicallyIncreasingTime() - startTime;
+}
+
+static void printBenchmark(const RegExpBenchmark& benchmark)
+{
+    if (!benchmark.bytecode || !benchmark.jitTime)
+        return;
+
+    printf("%10.3f ms %10.3f ms %8.2fx  /%s/\n", benchmark.jitTime * 1000, benchmark.interpreterTime * 1000,
+        benchmark.interpreterTime / benchmark.jitTime, benchmark.regexp->pattern().utf8().data());
+}
+
 static int scanString(char* buffer, int bufferLength, StringBuilder& builder, char termChar)
 {
     bool escape = false;
@@ -418,7 +481,7 @@ static RegExpTest* parseTestLine(char* line, int lineLength)
     return result;
 }
 
-static bool runFromFiles(GlobalObject* globalObject, const Vector<String>& files, bool verbose)
+static bool runFromFiles(GlobalObject* globalObject, const Vector<String>& files, bool verbose, bool benchmark)
 {
     String script;
     String fileName;
@@ -428,6 +491,10 @@ static bool runFromFiles(GlobalObject* globalObject, const Vector<String>& files
     char* lineBuffer = new char[MaxLineLength + 1];
 
     VM& vm = globalObject->vm();
+    RegExpBenchmark regExpBenchmark;
+
+    if (benchmark)
+        printf("  RegExp JIT  Interpreter    Ratio  Pattern\n");
 
     bool success = true;
     for (size_t i = 0; i < files.size(); i++) {
@@ -456,6 +523,10 @@ static bool runFromFiles(GlobalObject* globalObject, const Vector<String>& files
 
             if (linePtr[0] == '/') {
                 regexp = parseRegExpLine(vm, linePtr, lineLength);
+                if (benchmark) {
+                    printBenchmark(regExpBenchmark);
+                    startBenchmark(vm, regexp, regExpBenchmark);
+                }
             } else if (linePtr[0] == ' ') {
                 RegExpTest* regExpTest = parseTestLine(linePtr, lineLength);
                 
@@ -465,6 +536,8 @@ static bool runFromFiles(GlobalObject* globalObject, const Vector<String>& files
                         failures++;
                         printf("Failure on line %u\n", lineNumber);
                     }
+                    if (benchmark)
+                        benchmarkOneRegExp(vm, regExpBenchmark, regExpTest);
                 }
                 
                 if (regExpTest)
@@ -475,6 +548,9 @@ static bool runFromFiles(GlobalObject* globalObject, const Vector<String>& files
         fclose(testCasesFile);
     }
 
+    if (benchmark)
+        printBenchmark(regExpBenchmark);
+
     if (failures)
         printf("%u tests run, %u failures\n", tests, failures);
     else
@@ -496,6 +572,7 @@ static NO_RETURN void printUsageStatement(bool help = false)
     fprintf(stderr, "Usage: regexp_test [options] file\n");
     fprintf(stderr, "  -h|--help  Prints this help message\n");
     fprintf(stderr, "  -v|--verbose  Verbose output\n");
+    fprintf(stderr, "  -b|--benchmark  Time each pattern's tests with the JIT and the interpreter, and report the ratio\n");
 
     exit(help ? EXIT_SUCCESS : EXIT_FAILURE);
 }
@@ -509,6 +586,8 @@ static void parseArguments(int argc, char** argv, CommandLine& options)
             printUsageStatement(true);
         if (!strcmp(arg, "-v") || !strcmp(arg, "--verbose"))
             options.verbose = true;
+        else if (!strcmp(arg, "-b") || !strcmp(arg, "--benchmark"))
+            options.benchmark = true;
         else
             options.files.append(argv[i]);
     }
@@ -526,7 +605,7 @@ int realMain(int argc, char** argv)
     parseArguments(argc, argv, options);
 
     GlobalObject* globalObject = GlobalObject::create(*vm, GlobalObject::createStructure(*vm, jsNull()), options.arguments);
-    bool success = runFromFiles(globalObject, options.files, options.verbose);
+    bool success = runFromFiles(globalObject, options.files, options.verbose, options.benchmark);
 
     return success ? 0 : 3;
 }
@@ -0,0 +1,85 @@
+// Hot numeric and object kernels that run long enough to tier up into the FTL.
+// Compare the tiers with: sh compare-ftl.sh path/to/jsc
+(function () {
+    function nbody(steps) {
+        var bodies = [];
+        for (var i = 0; i < 5; ++i)
+            bodies.push({ x: i, y: i * 0.5, z: -i, vx: 0, vy: 0, vz: 0, mass: 1 + i * 0.1 });
+
+        for (var s = 0; s < steps; ++s) {
+            for (var i = 0; i < bodies.length; ++i) {
+                var a = bodies[i];
+                for (var j = i + 1; j < bodies.length; ++j) {
+                    var b = bodies[j];
+                    var dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+                    var d2 = dx * dx + dy * dy + dz * dz + 0.01;
+                    var mag = 0.001 / (d2 * Math.sqrt(d2));
+                    a.vx -= dx * b.mass * mag; a.vy -= dy * b.mass * mag; a.vz -= dz * b.mass * mag;
+                    b.vx += dx * a.mass * mag; b.vy += dy * a.mass * mag; b.vz += dz * a.mass * mag;
+                }
+            }
+            for (var i = 0; i < bodies.length; ++i) {
+                var b = bodies[i];
+                b.x += 0.01 * b.vx; b.y += 0.01 * b.vy; b.z += 0.01 * b.vz;
+            }
+        }
+        return bodies[0].x;
+    }
+
+    function matmul(n, rounds) {
+        var a = new Float64Array(n * n), b = new Float64Array(n * n), c = new Float64Array(n * n);
+        for (var i = 0; i < n * n; ++i) {
+            a[i] = i % 7;
+            b[i] = i % 11;
+        }
+        for (var r = 0; r < rounds; ++r) {
+            for (var i = 0; i < n; ++i) {
+                for (var j = 0; j < n; ++j) {
+                    var sum = 0;
+                    for (var k = 0; k < n; ++k)
+                        sum += a[i * n + k] * b[k * n + j];
+                    c[i * n + j] = sum;
+                }
+            }
+        }
+        return c[n + 1];
+    }
+
+    function sieve(max, rounds) {
+        var count = 0;
+        for (var r = 0; r < rounds; ++r) {
+            var composite = new Uint8Array(max);
+            count = 0;
+            for (var i = 2; i < max; ++i) {
+                if (composite[i])
+                    continue;
+                ++count;
+                for (var j = i * 2; j < max; j += i)
+                    composite[j] = 1;
+            }
+        }
+        return count;
+    }
+
+    function strings(rounds) {
+        var total = 0;
+        for (var r = 0; r < rounds; ++r) {
+            var parts = [];
+            for (var i = 0; i < 1000; ++i)
+                parts.push("item" + i);
+            total += parts.join(",").split(",").length;
+        }
+        return total;
+    }
+
+    function run(label, f) {
+        var start = preciseTime();
+        var result = f();
+        print(label + ": " + ((preciseTime() - start) * 1000).toFixed(1) + " ms (" + result + ")");
+    }
+
+    run("nbody", function () { return nbody(2000000); });
+    run("matmul", function () { return matmul(160, 20); });
+    run("sieve", function () { return sieve(1000000, 30); });
+    run("strings", function () { return strings(3000); });
+})();
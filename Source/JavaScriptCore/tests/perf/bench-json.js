@@ -0,0 +1,57 @@
+// Measures JSON.parse and JSON.stringify throughput in MB/s on a payload shaped
+// like a dashboard response. Run with: jsc bench-json.js
+(function () {
+    var targetSize = 8 * 1024 * 1024;
+    var iterations = 10;
+
+    function makeRecord(i) {
+        return {
+            id: i,
+            name: "series-" + i + "-" + "abcdefghijklmnopqrstuvwxyz".substring(i % 26),
+            description: "Sample \"quoted\" text with a path C:\\data\\" + i + " and a tab\tin it",
+            timestamp: 1420070400000 + i * 1000,
+            value: i * 1.5,
+            ok: !(i % 7),
+            tags: ["alpha", "beta", "gamma", "delta"],
+            points: [i, i + 1, i + 2, i + 3, i + 4, i + 5, i + 6, i + 7],
+            meta: { unit: "ms", source: "collector-" + (i % 16), comment: null }
+        };
+    }
+
+    function makePayload(indent) {
+        var records = [];
+        var text = "";
+        for (var i = 0; text.length < targetSize; i += 1000) {
+            for (var j = 0; j < 1000; ++j)
+                records.push(makeRecord(i + j));
+            text = JSON.stringify(records, null, indent);
+        }
+        return text;
+    }
+
+    function megabytesPerSecond(length, milliseconds) {
+        return (length * iterations / (1024 * 1024) / (milliseconds / 1000)).toFixed(1);
+    }
+
+    function run(label, indent) {
+        var text = makePayload(indent);
+        var value = JSON.parse(text);
+
+        var start = preciseTime();
+        for (var i = 0; i < iterations; ++i)
+            JSON.parse(text);
+        var parseTime = (preciseTime() - start) * 1000;
+
+        start = preciseTime();
+        for (var i = 0; i < iterations; ++i)
+            JSON.stringify(value, null, indent);
+        var stringifyTime = (preciseTime() - start) * 1000;
+
+        print(label + " (" + (text.length / (1024 * 1024)).toFixed(1) + " MB): parse "
+            + megabytesPerSecond(text.length, parseTime) + " MB/s, stringify "
+            + megabytesPerSecond(text.length, stringifyTime) + " MB/s");
+    }
+
+    run("minified", undefined);
+    run("indented", 4);
+})();
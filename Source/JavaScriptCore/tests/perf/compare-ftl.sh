@@ -0,0 +1,12 @@
+#!/bin/sh
+# Runs bench-ftl.js on a jsc built with FTL=1, once with the FTL tier
+# and once capped at the DFG, so the difference is the FTL's gain.
+
+JSC=${1:-../../jsc}
+DIR=`dirname $0`
+
+echo "DFG only:"
+$JSC --useFTLJIT=false $DIR/bench-ftl.js
+echo
+echo "With FTL:"
+$JSC --useFTLJIT=true $DIR/bench-ftl.js
@@ -0,0 +1,72 @@
+//@ run("concurrent-sweeping", "--useConcurrentSweeping=true")
+
+// Allocates through collections while the helper thread sweeps, mixing
+// objects without destructors (swept concurrently) with objects that have
+// them (swept on the mutator), and weak map entries whose keys die. Any
+// cell handed out twice or freed while live shows up as a corrupt survivor.
+
+function assert(b, message) {
+    if (!b)
+        throw new Error(message);
+}
+
+var weakMap = new WeakMap();
+var weakSet = new WeakSet();
+var survivors = [];
+
+function makeObject(i) {
+    var o = { id: i, next: null, items: [i, i + 1, i + 2] };
+    o.name = "object" + i;
+    return o;
+}
+
+function makeWithDestructors(i) {
+    var map = new Map();
+    map.set(i, "value" + i);
+    var set = new Set([i]);
+    var bytes = new Uint8Array(16);
+    bytes[0] = i & 0xff;
+    return { map: map, set: set, bytes: bytes, string: ("s" + i).repeat(3) };
+}
+
+function check(o) {
+    assert(o.items.length == 3 && o.items[0] == o.id && o.items[2] == o.id + 2, "bad items for " + o.id);
+    assert(o.name == "object" + o.id, "bad name for " + o.id);
+    assert(weakMap.get(o) === o.id * 2, "bad weak map entry for " + o.id);
+    assert(weakSet.has(o), "missing weak set entry for " + o.id);
+    var d = o.destructors;
+    assert(d.map.get(o.id) == "value" + o.id, "bad map for " + o.id);
+    assert(d.set.has(o.id), "bad set for " + o.id);
+    assert(d.bytes[0] == (o.id & 0xff), "bad bytes for " + o.id);
+    assert(d.string == ("s" + o.id).repeat(3), "bad string for " + o.id);
+}
+
+var id = 0;
+for (var round = 0; round < 20; ++round) {
+    for (var i = 0; i < 20000; ++i) {
+        var o = makeObject(id);
+        o.destructors = makeWithDestructors(id);
+        weakMap.set(o, id * 2);
+        weakSet.add(o);
+        // Keep every tenth object, let the rest die with their weak entries.
+        if (!(id % 10))
+            survivors.push(o);
+        ++id;
+    }
+
+    if (round % 3 == 0)
+        fullGC();
+    else if (round % 3 == 1)
+        edenGC();
+
+    // Drop the oldest survivors so that blocks empty out and get reused.
+    if (survivors.length > 10000)
+        survivors.splice(0, 5000);
+
+    for (var j = 0; j < survivors.length; ++j)
+        check(survivors[j]);
+}
+
+gc();
+for (var j = 0; j < survivors.length; ++j)
+    check(survivors[j]);
@@ -0,0 +1,138 @@
+// JSON.parse and JSON.stringify scan strings and white space a block at a
+// time. These check the results around the block edges, and the cases that
+// leave the fast paths.
+
+function shouldBe(actual, expected, message)
+{
+    if (actual !== expected)
+        throw new Error((message || "") + ": expected " + JSON.stringify(expected) + " but got " + JSON.stringify(actual));
+}
+
+function shouldThrow(func, errorType, message)
+{
+    var error;
+    try {
+        func();
+    } catch (e) {
+        error = e;
+    }
+    if (!(error instanceof errorType))
+        throw new Error(message + ": expected " + errorType.name + " but got " + error);
+}
+
+// What JSON.stringify makes of a string, a character at a time.
+function quote(string)
+{
+    var result = "\"";
+    for (var i = 0; i < string.length; ++i) {
+        var c = string.charCodeAt(i);
+        switch (c) {
+        case 0x8: result += "\\b"; break;
+        case 0x9: result += "\\t"; break;
+        case 0xA: result += "\\n"; break;
+        case 0xC: result += "\\f"; break;
+        case 0xD: result += "\\r"; break;
+        case 0x22: result += "\\\""; break;
+        case 0x5C: result += "\\\\"; break;
+        default:
+            if (c < 0x20)
+                result += "\\u" + ("000" + c.toString(16)).slice(-4);
+            else
+                result += string[i];
+        }
+    }
+    return result + "\"";
+}
+
+// Characters needing an escape, at every position around the 16 character blocks.
+var special = [];
+for (var c = 0; c < 0x20; ++c)
+    special.push(String.fromCharCode(c));
+special.push("\"", "\\", "\u007f", "é", "✓");
+
+var fillers = ["abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJ", "àáâãäåæçèéêëìíîïðñòóôõö÷ø", "абвгдежзийклмнопрстуфхцч"];
+for (var f = 0; f < fillers.length; ++f) {
+    var filler = fillers[f];
+    for (var s = 0; s < special.length; ++s) {
+        for (var position = 0; position <= 20; ++position) {
+            var string = filler.slice(0, position) + special[s] + filler.slice(position);
+            var json = JSON.stringify(string);
+            shouldBe(json, quote(string), "stringify of character " + special[s].charCodeAt(0) + " at " + position);
+            shouldBe(JSON.parse(json), string, "parse of character " + special[s].charCodeAt(0) + " at " + position);
+        }
+    }
+}
+
+// Escapes in the source, including the ones JSON.stringify never writes.
+shouldBe(JSON.parse("\"\\u00e9\\u2713\\ud83d\\ude00\\/\\b\\f\\n\\r\\t\\\"\\\\\""), "é✓😀/\b\f\n\r\t\"\\");
+shouldBe(JSON.parse("\"0123456789abcdef\\u0041\\u0042 0123456789abcdef\""), "0123456789abcdefAB 0123456789abcdef");
+shouldBe(JSON.stringify("héllo wörld ✓ 😀"), "\"héllo wörld ✓ 😀\"");
+
+// Control characters may not appear unescaped in strict JSON.
+for (var c = 0; c < 0x20; ++c) {
+    shouldThrow(function() { JSON.parse("\"0123456789abcdef" + String.fromCharCode(c) + "\""); }, SyntaxError, "raw character " + c);
+    shouldThrow(function() { JSON.parse("\"✓123456789abcdef" + String.fromCharCode(c) + "\""); }, SyntaxError, "raw 16-bit character " + c);
+}
+shouldThrow(function() { JSON.parse("\"0123456789abcdef"); }, SyntaxError, "unterminated string");
+shouldThrow(function() { JSON.parse("\"0123456789abcdef\\x41\""); }, SyntaxError, "bad escape");
+
+// White space runs, only the four JSON white space characters.
+var blanks = [" ", "\t", "\n", "\r"];
+for (var length = 0; length <= 40; ++length) {
+    var run = "";
+    for (var i = 0; i < length; ++i)
+        run += blanks[(i * 7 + length) % 4];
+    shouldBe(JSON.parse(run + "[" + run + "1" + run + "," + run + "{" + run + "\"a\"" + run + ":" + run + "2" + run + "}" + run + "]" + run)[1].a, 2, "white space run of " + length);
+    shouldThrow(function() { JSON.parse(run + "\u000b1"); }, SyntaxError, "vertical tab after " + length);
+    shouldThrow(function() { JSON.parse(run + " 1"); }, SyntaxError, "no-break space after " + length);
+}
+var indented = JSON.stringify({ a: [1, { b: "c" }], d: { e: { f: null } } }, null, 16);
+shouldBe(JSON.stringify(JSON.parse(indented)), "{\"a\":[1,{\"b\":\"c\"}],\"d\":{\"e\":{\"f\":null}}}");
+
+// Numbers around the int32 and exact double limits.
+shouldBe(JSON.parse("2147483647"), 2147483647);
+shouldBe(JSON.parse("2147483648"), 2147483648);
+shouldBe(JSON.parse("-2147483648"), -2147483648);
+shouldBe(JSON.parse("-2147483649"), -2147483649);
+shouldBe(JSON.parse("4294967296"), 4294967296);
+shouldBe(JSON.parse("9007199254740993"), 9007199254740992);
+shouldBe(1 / JSON.parse("-0"), -Infinity);
+shouldBe(JSON.parse("1e400"), Infinity);
+shouldBe(JSON.parse("2147483647.5"), 2147483647.5);
+shouldBe(JSON.parse("1E2"), 100);
+shouldBe(JSON.parse("-1.5e-3"), -0.0015);
+shouldBe(JSON.stringify([2147483647, 2147483648, -2147483649, -0, 0.1, 1e21, 1e-7, NaN, Infinity]), "[2147483647,2147483648,-2147483649,0,0.1,1e+21,1e-7,null,null]");
+shouldThrow(function() { JSON.parse("01"); }, SyntaxError, "leading zero");
+shouldThrow(function() { JSON.parse("1."); }, SyntaxError, "missing fraction");
+shouldThrow(function() { JSON.parse("+1"); }, SyntaxError, "plus sign");
+
+// A "__proto__" key is an own property, it doesn't set the prototype.
+var parsed = JSON.parse("{\"__proto__\": {\"x\": 1}, \"y\": 2}");
+shouldBe(Object.getPrototypeOf(parsed), Object.prototype);
+shouldBe(Object.prototype.hasOwnProperty.call(parsed, "__proto__"), true);
+shouldBe(parsed.x, undefined);
+shouldBe(Object.keys(parsed).join(), "__proto__,y");
+shouldBe(JSON.stringify(parsed), "{\"__proto__\":{\"x\":1},\"y\":2}");
+
+// toJSON, replacers and indentation leave the fast path.
+var withToJSON = { a: 1, toJSON: function(key) { return "key:" + key; } };
+shouldBe(JSON.stringify({ x: withToJSON, y: [withToJSON] }), "{\"x\":\"key:x\",\"y\":[\"key:0\"]}");
+shouldBe(JSON.stringify(new Date(0)), "\"1970-01-01T00:00:00.000Z\"");
+shouldBe(JSON.stringify({ a: 1, b: "téxt\n", c: [1, 2] }, function(key, value) { return typeof value === "number" ? value * 10 : value; }), "{\"a\":10,\"b\":\"téxt\\n\",\"c\":[10,20]}");
+shouldBe(JSON.stringify({ a: 1, b: 2, c: { a: 3, d: 4 } }, ["a", "c"]), "{\"a\":1,\"c\":{\"a\":3}}");
+shouldBe(JSON.stringify({ a: [1, "✓"] }, null, 2), "{\n  \"a\": [\n    1,\n    \"✓\"\n  ]\n}");
+shouldBe(JSON.stringify({ a: 1 }, null, "--"), "{\n--\"a\": 1\n}");
+shouldBe(JSON.stringify({ a: 1 }, null, 20), "{\n          \"a\": 1\n}");
+shouldBe(JSON.stringify(JSON.parse("{\"a\": [1, 2], \"b\": {\"c\": \"d\"}}", function(key, value) { return key === "c" ? value.toUpperCase() : value; })), "{\"a\":[1,2],\"b\":{\"c\":\"D\"}}");
+
+// Cycles still throw, shared references don't.
+var cyclic = { a: 1 };
+cyclic.self = cyclic;
+shouldThrow(function() { JSON.stringify(cyclic); }, TypeError, "cyclic object");
+var cyclicArray = [1, 2];
+cyclicArray.push([cyclicArray]);
+shouldThrow(function() { JSON.stringify(cyclicArray); }, TypeError, "cyclic array");
+shouldThrow(function() { JSON.stringify({ a: { toJSON: function() { return cyclic; } } }); }, TypeError, "cycle from toJSON");
+shouldThrow(function() { JSON.stringify(cyclic, null, 2); }, TypeError, "cyclic object with indentation");
+var shared = { s: "shared" };
+shouldBe(JSON.stringify([shared, shared, { x: shared }]), "[{\"s\":\"shared\"},{\"s\":\"shared\"},{\"x\":{\"s\":\"shared\"}}]");
@@ -0,0 +1,50 @@
+// Each iteration of quantified parentheses saves a context in the JIT's
+// context pool. Long inputs run out of it, and the match is rerun in the
+// interpreter, which must find exactly what the JIT finds for short inputs.
+
+function shouldBe(actual, expected, message)
+{
+    if (actual !== expected)
+        throw new Error(message + ": expected " + expected + " but got " + actual);
+}
+
+function check(regexp, input, expected)
+{
+    var match = regexp.exec(input);
+    var message = regexp + " on " + input.length + " characters";
+    if (!expected) {
+        shouldBe(match, null, message);
+        return;
+    }
+    if (!match)
+        throw new Error(message + ": no match");
+    shouldBe(match.index, expected.index, message + ", index");
+    shouldBe(match.length, expected.captures.length, message + ", captures");
+    for (var i = 0; i < match.length; ++i)
+        shouldBe(match[i], expected.captures[i], message + ", capture " + i);
+}
+
+function test(count)
+{
+    var ab = "ab".repeat(count);
+    check(/(?:(a)|(b))+c/, ab + "c", { index: 0, captures: [ab + "c", undefined, "b"] });
+    check(/((a)|b)+$/, ab + "a", { index: 0, captures: [ab + "a", "a", "a"] });
+    check(/(?:(a)|b){2,}?c/, "x" + ab + "c", { index: 1, captures: [ab + "c", undefined] });
+    check(/^(?:(a)|(b))+d/, ab + "c", null);
+
+    var pairs = "aabb".repeat(count);
+    check(/((\w)\2)+/, pairs + "xy", { index: 0, captures: [pairs, "bb", "b"] });
+    check(/(?:(a)\1|(b)\2)+$/, pairs, { index: 0, captures: [pairs, undefined, "b"] });
+    check(/(?:(A)\1|(b)\2)+$/i, pairs.toUpperCase(), { index: 0, captures: [pairs.toUpperCase(), undefined, "B"] });
+    check(/^(?:(a)\1|(b)\2)+x/, pairs + "y", null);
+
+    var xy = "xyx".repeat(count);
+    check(/(?:(x)y\1)+?z/, xy + "z", { index: 0, captures: [xy + "z", "x"] });
+}
+
+// Alternate short and long inputs, so that the JIT runs again after every fallback.
+for (var i = 0; i < 5; ++i) {
+    test(1);
+    test(10);
+    test(20000);
+}
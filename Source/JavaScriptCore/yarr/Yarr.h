@@ -55,7 +55,8 @@ enum JSRegExpResult {
     JSRegExpErrorNoMatch = -1,
     JSRegExpErrorHitLimit = -2,
     JSRegExpErrorNoMemory = -3,
-    JSRegExpErrorInternal = -4
+    JSRegExpErrorInternal = -4,
+    JSRegExpJITCodeFailure = -5
 };
 
 enum YarrCharSize {
@@ -61,6 +61,7 @@ class YarrGenerator : private MacroAssembler {
 
     static const RegisterID regT0 = ARM64Registers::x4;
     static const RegisterID regT1 = ARM64Registers::x5;
+    static const RegisterID regT2 = ARM64Registers::x6;
 
     static const RegisterID returnRegister = ARM64Registers::x0;
     static const RegisterID returnRegister2 = ARM64Registers::x1;
@@ -72,6 +73,7 @@ class YarrGenerator : private MacroAssembler {
 
     static const RegisterID regT0 = MIPSRegisters::t4;
     static const RegisterID regT1 = MIPSRegisters::t5;
+    static const RegisterID regT2 = MIPSRegisters::t6;
 
     static const RegisterID returnRegister = MIPSRegisters::v0;
     static const RegisterID returnRegister2 = MIPSRegisters::v1;
@@ -115,6 +117,9 @@ class YarrGenerator : private MacroAssembler {
 
     static const RegisterID regT0 = X86Registers::eax;
     static const RegisterID regT1 = X86Registers::ebx;
+#if !OS(WINDOWS)
+    static const RegisterID regT2 = X86Registers::r8;
+#endif
 
     static const RegisterID returnRegister = X86Registers::eax;
     static const RegisterID returnRegister2 = X86Registers::edx;
@@ -318,6 +323,11 @@ class YarrGenerator : private MacroAssembler {
         poke(imm, frameLocation);
     }
 
+    void storeToFrame(TrustedImmPtr imm, unsigned frameLocation)
+    {
+        poke(imm, frameLocation);
+    }
+
     DataLabelPtr storeToFrameWithPatch(unsigned frameLocation)
     {
         return storePtrWithPatch(TrustedImmPtr(0), Address(stackPointerRegister, frameLocation * sizeof(void*)));
@@ -402,6 +412,123 @@ class YarrGenerator : private MacroAssembler {
             move(output, reg);
     }
 
+    // Parentheses that are neither 'Once' nor 'Terminal' keep a stack of contexts, one
+    // per iteration, in the VM's YarrParenContextPool. Their frame holds the index at
+    // the start of the current iteration (used to reject empty iterations) followed
+    // by the innermost context, with the subpattern's own frame laid out after these.
+    // Each context records the state from before its iteration: the index, the count
+    // of iterations already matched, the subpattern's captures and its frame slots.
+    enum ParenContextSlot {
+        ParenContextNext,
+        ParenContextBegin,
+        ParenContextCount,
+        ParenContextHeaderSize
+    };
+
+    bool isIteratedParentheses(PatternTerm* term)
+    {
+        return term->type == PatternTerm::TypeParenthesesSubpattern
+            && (term->quantityCount != 1 || term->parentheses.isCopy)
+            && !term->parentheses.isTerminal;
+    }
+
+    unsigned alternativeFrameLocation(PatternTerm* term)
+    {
+        if (isIteratedParentheses(term))
+            return term->frameLocation + YarrStackSpaceForBackTrackInfoParentheses;
+        if (term->quantityType != QuantifierFixedCount)
+            return term->frameLocation + YarrStackSpaceForBackTrackInfoParenthesesOnce;
+        return term->frameLocation;
+    }
+
+    unsigned parenContextCaptureCount(PatternTerm* term)
+    {
+        if (compileMode != IncludeSubpatterns)
+            return 0;
+        return (term->parentheses.lastSubpatternId + 1 - term->parentheses.subpatternId) << 1;
+    }
+
+    unsigned parenContextSize(PatternTerm* term)
+    {
+        unsigned frameSlots = term->parentheses.disjunction->m_callFrameSize - alternativeFrameLocation(term);
+        return (ParenContextHeaderSize + parenContextCaptureCount(term) + frameSlots) * sizeof(void*);
+    }
+
+    // Pushes a context for a new iteration, leaving it in 'context'. The captures
+    // within the subpattern are cleared for the iteration, as in the interpreter.
+    void pushParenContext(PatternTerm* term, RegisterID context, RegisterID temp)
+    {
+        unsigned parenthesesFrameLocation = term->frameLocation;
+        unsigned size = parenContextSize(term);
+
+        move(TrustedImmPtr(m_parenContextPool->addressOfRemainingIterations()), temp);
+        load32(Address(temp), context);
+        m_abortToInterpreter.append(branchSub32(Zero, TrustedImm32(1), context));
+        store32(context, Address(temp));
+
+        move(TrustedImmPtr(m_parenContextPool->addressOfFree()), temp);
+        loadPtr(Address(temp), context);
+        addPtr(TrustedImm32(size), context);
+        m_abortToInterpreter.append(branchPtr(Above, context, TrustedImmPtr(m_parenContextPool->end())));
+        storePtr(context, Address(temp));
+        subPtr(TrustedImm32(size), context);
+
+        loadFromFrame(parenthesesFrameLocation + 1, temp);
+        storePtr(temp, Address(context, ParenContextNext * sizeof(void*)));
+        Jump firstIteration = branchTestPtr(Zero, temp);
+        load32(Address(temp, ParenContextCount * sizeof(void*)), temp);
+        add32(TrustedImm32(1), temp);
+        firstIteration.link(this);
+        store32(temp, Address(context, ParenContextCount * sizeof(void*)));
+        store32(index, Address(context, ParenContextBegin * sizeof(void*)));
+
+        unsigned slot = ParenContextHeaderSize;
+        unsigned firstCapture = term->parentheses.subpatternId << 1;
+        for (unsigned i = 0; i < parenContextCaptureCount(term); ++i, ++slot) {
+            load32(Address(output, (firstCapture + i) * sizeof(int)), temp);
+            store32(temp, Address(context, slot * sizeof(void*)));
+            store32(TrustedImm32(-1), Address(output, (firstCapture + i) * sizeof(int)));
+        }
+        for (unsigned frameLocation = alternativeFrameLocation(term); frameLocation < term->parentheses.disjunction->m_callFrameSize; ++frameLocation, ++slot) {
+            loadFromFrame(frameLocation, temp);
+            storePtr(temp, Address(context, slot * sizeof(void*)));
+        }
+
+        storeToFrame(context, parenthesesFrameLocation + 1);
+        storeToFrame(index, parenthesesFrameLocation);
+    }
+
+    // Pops the innermost context, restoring the state from before its iteration,
+    // and leaves the new innermost context (null if there is none) in 'context'.
+    void popParenContext(PatternTerm* term, RegisterID context, RegisterID temp)
+    {
+        unsigned parenthesesFrameLocation = term->frameLocation;
+
+        loadFromFrame(parenthesesFrameLocation + 1, context);
+        load32(Address(context, ParenContextBegin * sizeof(void*)), index);
+
+        unsigned slot = ParenContextHeaderSize;
+        unsigned firstCapture = term->parentheses.subpatternId << 1;
+        for (unsigned i = 0; i < parenContextCaptureCount(term); ++i, ++slot) {
+            load32(Address(context, slot * sizeof(void*)), temp);
+            store32(temp, Address(output, (firstCapture + i) * sizeof(int)));
+        }
+        for (unsigned frameLocation = alternativeFrameLocation(term); frameLocation < term->parentheses.disjunction->m_callFrameSize; ++frameLocation, ++slot) {
+            loadPtr(Address(context, slot * sizeof(void*)), temp);
+            storeToFrame(temp, frameLocation);
+        }
+
+        move(TrustedImmPtr(m_parenContextPool->addressOfFree()), temp);
+        storePtr(context, Address(temp));
+        loadPtr(Address(context, ParenContextNext * sizeof(void*)), context);
+        storeToFrame(context, parenthesesFrameLocation + 1);
+
+        Jump noIterations = branchTestPtr(Zero, context);
+        load32(Address(context, ParenContextBegin * sizeof(void*)), temp);
+        storeToFrame(temp, parenthesesFrameLocation);
+        noIterations.link(this);
+    }
+
     enum YarrOpCode {
         // These nodes wrap body alternatives - those in the main disjunction,
         // rather than subpatterns or assertions. These are chained together in
@@ -430,6 +557,10 @@ class YarrGenerator : private MacroAssembler {
         // Used to wrap 'Terminal' subpattern matches (at the end of the regexp).
         OpParenthesesSubpatternTerminalBegin,
         OpParenthesesSubpatternTerminalEnd,
+        // Used to wrap all other quantified subpatterns, saving the state of the
+        // subpattern on each iteration so that it can be backtracked into.
+        OpParenthesesSubpatternBegin,
+        OpParenthesesSubpatternEnd,
         // Used to wrap parenthetical assertions.
         OpParentheticalAssertionBegin,
         OpParentheticalAssertionEnd,
@@ -1225,7 +1356,187 @@ class YarrGenerator : private MacroAssembler {
     {
         backtrackTermDefault(opIndex);
     }
-    
+
+#if ENABLE(YARR_JIT_BACKREFERENCES)
+    // Backreferences are matched against the capture recorded in the output vector,
+    // so they are only compiled when subpatterns are included, and only case-sensitively
+    // (see opCompileAlternative).
+    // The term's frame holds the index on entry (or, for greedy terms, after the last
+    // complete copy), followed by the number of copies matched.
+
+    // Loads the start of the referenced capture into patternIndex and its length into
+    // patternLength. If emptyCapture is provided, jumps there if the subpattern did not
+    // participate in the match or captured the empty string.
+    void loadBackReference(PatternTerm* term, RegisterID patternIndex, RegisterID patternLength, JumpList* emptyCapture = 0)
+    {
+        unsigned subpatternId = term->backReferenceSubpatternId;
+
+        load32(Address(output, (subpatternId << 1) * sizeof(int)), patternIndex);
+        load32(Address(output, ((subpatternId << 1) + 1) * sizeof(int)), patternLength);
+        sub32(patternIndex, patternLength);
+        if (emptyCapture) {
+            emptyCapture->append(branch32(Equal, patternIndex, TrustedImm32(-1)));
+            emptyCapture->append(branch32(LessThanOrEqual, patternLength, TrustedImm32(0)));
+        }
+    }
+
+    // Matches one copy of the capture loaded by loadBackReference, advancing index past
+    // it. On failure index may have been partially advanced; callers restore it from the
+    // frame.
+    void matchBackReference(PatternTerm* term, JumpList& failures)
+    {
+        const RegisterID character = regT0;
+        const RegisterID patternIndex = regT1;
+        const RegisterID patternCharacter = regT2;
+
+        // Check the whole copy is available before comparing any characters. Like
+        // any input check this applies to index, which already includes the input
+        // checked for the terms that follow.
+        add32(index, patternCharacter);
+        failures.append(branch32(Above, patternCharacter, length));
+
+        int inputOffset = term->inputPosition - m_checked;
+
+        Label loop(this);
+        if (m_charSize == Char8)
+            load8(BaseIndex(input, patternIndex, TimesOne, 0), patternCharacter);
+        else
+            load16(BaseIndex(input, patternIndex, TimesTwo, 0), patternCharacter);
+        readCharacter(inputOffset, character);
+        failures.append(branch32(NotEqual, character, patternCharacter));
+
+        add32(TrustedImm32(1), index);
+        add32(TrustedImm32(1), patternIndex);
+        branch32(NotEqual, patternIndex, Address(output, ((term->backReferenceSubpatternId << 1) + 1) * sizeof(int))).linkTo(loop, this);
+    }
+
+    void generateBackReference(size_t opIndex)
+    {
+        YarrOp& op = m_ops[opIndex];
+        PatternTerm* term = op.m_term;
+
+        const RegisterID countRegister = regT0;
+        const RegisterID patternIndex = regT1;
+        const RegisterID patternLength = regT2;
+
+        unsigned beginFrameLocation = term->frameLocation;
+        unsigned countFrameLocation = term->frameLocation + 1;
+
+        storeToFrame(index, beginFrameLocation);
+
+        switch (term->quantityType) {
+        case QuantifierFixedCount: {
+            // An empty capture matches without consuming input, however many copies are required.
+            JumpList emptyCapture;
+            loadBackReference(term, patternIndex, patternLength, &emptyCapture);
+            if (term->quantityCount == 1)
+                matchBackReference(term, op.m_jumps);
+            else {
+                storeToFrame(TrustedImm32(0), countFrameLocation);
+                Label loop(this);
+                matchBackReference(term, op.m_jumps);
+                loadFromFrame(countFrameLocation, countRegister);
+                add32(TrustedImm32(1), countRegister);
+                storeToFrame(countRegister, countFrameLocation);
+                Jump done = branch32(Equal, countRegister, Imm32(term->quantityCount.unsafeGet()));
+                loadBackReference(term, patternIndex, patternLength);
+                jump(loop);
+                done.link(this);
+            }
+            emptyCapture.link(this);
+            break;
+        }
+
+        case QuantifierGreedy: {
+            JumpList done;
+            JumpList incomplete;
+
+            storeToFrame(TrustedImm32(0), countFrameLocation);
+            Label loop(this);
+            loadBackReference(term, patternIndex, patternLength, &done);
+            matchBackReference(term, incomplete);
+            loadFromFrame(countFrameLocation, countRegister);
+            add32(TrustedImm32(1), countRegister);
+            storeToFrame(countRegister, countFrameLocation);
+            storeToFrame(index, beginFrameLocation);
+            if (term->quantityCount == quantifyInfinite)
+                jump(loop);
+            else {
+                branch32(NotEqual, countRegister, Imm32(term->quantityCount.unsafeGet())).linkTo(loop, this);
+                done.append(jump());
+            }
+
+            // A partial copy is discarded; rewind to the end of the last complete one.
+            incomplete.link(this);
+            loadFromFrame(beginFrameLocation, index);
+
+            done.link(this);
+            op.m_reentry = label();
+            break;
+        }
+
+        case QuantifierNonGreedy:
+            storeToFrame(TrustedImm32(0), countFrameLocation);
+            op.m_reentry = label();
+            break;
+        }
+    }
+
+    void backtrackBackReference(size_t opIndex)
+    {
+        YarrOp& op = m_ops[opIndex];
+        PatternTerm* term = op.m_term;
+
+        const RegisterID countRegister = regT0;
+        const RegisterID patternIndex = regT1;
+        const RegisterID patternLength = regT2;
+
+        unsigned beginFrameLocation = term->frameLocation;
+        unsigned countFrameLocation = term->frameLocation + 1;
+
+        m_backtrackingState.link(this);
+
+        switch (term->quantityType) {
+        case QuantifierFixedCount:
+            op.m_jumps.link(this);
+            loadFromFrame(beginFrameLocation, index);
+            m_backtrackingState.fallthrough();
+            break;
+
+        case QuantifierGreedy:
+            // Give back one copy of the capture.
+            loadFromFrame(countFrameLocation, countRegister);
+            m_backtrackingState.append(branchTest32(Zero, countRegister));
+            sub32(TrustedImm32(1), countRegister);
+            storeToFrame(countRegister, countFrameLocation);
+            loadBackReference(term, patternIndex, patternLength);
+            sub32(patternLength, index);
+            jump(op.m_reentry);
+            break;
+
+        case QuantifierNonGreedy: {
+            // Try to match one more copy of the capture.
+            JumpList nonGreedyFailures;
+            if (term->quantityCount != quantifyInfinite) {
+                loadFromFrame(countFrameLocation, countRegister);
+                nonGreedyFailures.append(branch32(Equal, countRegister, Imm32(term->quantityCount.unsafeGet())));
+            }
+            loadBackReference(term, patternIndex, patternLength, &nonGreedyFailures);
+            matchBackReference(term, nonGreedyFailures);
+            loadFromFrame(countFrameLocation, countRegister);
+            add32(TrustedImm32(1), countRegister);
+            storeToFrame(countRegister, countFrameLocation);
+            jump(op.m_reentry);
+
+            nonGreedyFailures.link(this);
+            loadFromFrame(beginFrameLocation, index);
+            m_backtrackingState.fallthrough();
+            break;
+        }
+        }
+    }
+#endif
+
     // Code generation/backtracking for simple terms
     // (pattern characters, character classes, and assertions).
     // These methods farm out work to the set of functions above.
@@ -1288,7 +1599,11 @@ class YarrGenerator : private MacroAssembler {
         case PatternTerm::TypeParentheticalAssertion:
             RELEASE_ASSERT_NOT_REACHED();
         case PatternTerm::TypeBackReference:
+#if ENABLE(YARR_JIT_BACKREFERENCES)
+            generateBackReference(opIndex);
+#else
             m_shouldFallBack = true;
+#endif
             break;
         case PatternTerm::TypeDotStarEnclosure:
             generateDotStarEnclosure(opIndex);
@@ -1359,7 +1674,11 @@ class YarrGenerator : private MacroAssembler {
             break;
 
         case PatternTerm::TypeBackReference:
+#if ENABLE(YARR_JIT_BACKREFERENCES)
+            backtrackBackReference(opIndex);
+#else
             m_shouldFallBack = true;
+#endif
             break;
         }
     }
@@ -1492,7 +1811,8 @@ class YarrGenerator : private MacroAssembler {
 
                 // Calculate how much input we need to check for, and if non-zero check.
                 op.m_checkAdjust = alternative->m_minimumSize;
-                if ((term->quantityType == QuantifierFixedCount) && (term->type != PatternTerm::TypeParentheticalAssertion))
+                // Fixed count 'Once' parentheses have their minimum size checked by the enclosing alternative.
+                if ((term->quantityType == QuantifierFixedCount) && (term->type != PatternTerm::TypeParentheticalAssertion) && !isIteratedParentheses(term))
                     op.m_checkAdjust -= disjunction->m_minimumSize;
                 if (op.m_checkAdjust)
                     op.m_jumps.append(jumpIfNoAvailableInput(op.m_checkAdjust));
@@ -1508,11 +1828,7 @@ class YarrGenerator : private MacroAssembler {
 
                 // In the non-simple case, store a 'return address' so we can backtrack correctly.
                 if (op.m_op == OpNestedAlternativeNext) {
-                    unsigned parenthesesFrameLocation = term->frameLocation;
-                    unsigned alternativeFrameLocation = parenthesesFrameLocation;
-                    if (term->quantityType != QuantifierFixedCount)
-                        alternativeFrameLocation += YarrStackSpaceForBackTrackInfoParenthesesOnce;
-                    op.m_returnAddress = storeToFrameWithPatch(alternativeFrameLocation);
+                    op.m_returnAddress = storeToFrameWithPatch(alternativeFrameLocation(term));
                 }
 
                 if (term->quantityType != QuantifierFixedCount && !m_ops[op.m_previousOp].m_alternative->m_minimumSize) {
@@ -1542,7 +1858,7 @@ class YarrGenerator : private MacroAssembler {
 
                 // Calculate how much input we need to check for, and if non-zero check.
                 op.m_checkAdjust = alternative->m_minimumSize;
-                if ((term->quantityType == QuantifierFixedCount) && (term->type != PatternTerm::TypeParentheticalAssertion))
+                if ((term->quantityType == QuantifierFixedCount) && (term->type != PatternTerm::TypeParentheticalAssertion) && !isIteratedParentheses(term))
                     op.m_checkAdjust -= disjunction->m_minimumSize;
                 if (op.m_checkAdjust)
                     op.m_jumps.append(jumpIfNoAvailableInput(op.m_checkAdjust));
@@ -1558,11 +1874,7 @@ class YarrGenerator : private MacroAssembler {
 
                 // In the non-simple case, store a 'return address' so we can backtrack correctly.
                 if (op.m_op == OpNestedAlternativeEnd) {
-                    unsigned parenthesesFrameLocation = term->frameLocation;
-                    unsigned alternativeFrameLocation = parenthesesFrameLocation;
-                    if (term->quantityType != QuantifierFixedCount)
-                        alternativeFrameLocation += YarrStackSpaceForBackTrackInfoParenthesesOnce;
-                    op.m_returnAddress = storeToFrameWithPatch(alternativeFrameLocation);
+                    op.m_returnAddress = storeToFrameWithPatch(alternativeFrameLocation(term));
                 }
 
                 if (term->quantityType != QuantifierFixedCount && !m_ops[op.m_previousOp].m_alternative->m_minimumSize) {
@@ -1714,6 +2026,79 @@ class YarrGenerator : private MacroAssembler {
                 break;
             }
 
+            // OpParenthesesSubpatternBegin/End
+            //
+            // These nodes support all other quantified subpatterns - counted and
+            // unbounded repeats, including the copies generated for range
+            // quantifiers. Each iteration pushes a context saving the state from
+            // before it, see pushParenContext(). The number of iterations matched is
+            // one more than the count in the innermost context.
+            case OpParenthesesSubpatternBegin: {
+                PatternTerm* term = op.m_term;
+                const RegisterID context = regT0;
+                const RegisterID indexTemporary = regT1;
+
+                // No iterations have been matched yet. NonGreedy parentheses first try
+                // to match the remainder of the expression, skipping the subpattern.
+                storeToFrame(TrustedImmPtr(0), term->frameLocation + 1);
+                if (term->quantityType == QuantifierNonGreedy)
+                    op.m_jumps.append(jump());
+
+                // Each iteration starts here.
+                op.m_reentry = label();
+                pushParenContext(term, context, indexTemporary);
+
+                if (term->capture() && compileMode == IncludeSubpatterns) {
+                    int inputOffset = term->inputPosition - m_checked;
+                    if (inputOffset) {
+                        move(index, indexTemporary);
+                        add32(Imm32(inputOffset), indexTemporary);
+                        setSubpatternStart(indexTemporary, term->parentheses.subpatternId);
+                    } else
+                        setSubpatternStart(index, term->parentheses.subpatternId);
+                }
+                break;
+            }
+            case OpParenthesesSubpatternEnd: {
+                PatternTerm* term = op.m_term;
+                YarrOp& beginOp = m_ops[op.m_previousOp];
+                const RegisterID context = regT0;
+                const RegisterID indexTemporary = regT1;
+
+                if (term->capture() && compileMode == IncludeSubpatterns) {
+                    int inputOffset = term->inputPosition - m_checked;
+                    if (inputOffset) {
+                        move(index, indexTemporary);
+                        add32(Imm32(inputOffset), indexTemporary);
+                        setSubpatternEnd(indexTemporary, term->parentheses.subpatternId);
+                    } else
+                        setSubpatternEnd(index, term->parentheses.subpatternId);
+                }
+
+                // Greedy parentheses loop back for another iteration until the maximum
+                // is reached, FixedCount ones until the count is. NonGreedy parentheses
+                // go on to the remainder of the expression, as did the initial skip.
+                if (term->quantityType == QuantifierGreedy) {
+                    if (term->quantityCount != quantifyInfinite) {
+                        loadFromFrame(term->frameLocation + 1, context);
+                        op.m_jumps.append(branch32(Equal, Address(context, ParenContextCount * sizeof(void*)), TrustedImm32((term->quantityCount - 1).unsafeGet())));
+                    }
+                    jump(beginOp.m_reentry);
+                } else if (term->quantityType == QuantifierFixedCount) {
+                    loadFromFrame(term->frameLocation + 1, context);
+                    branch32(NotEqual, Address(context, ParenContextCount * sizeof(void*)), TrustedImm32((term->quantityCount - 1).unsafeGet())).linkTo(beginOp.m_reentry, this);
+                } else {
+                    beginOp.m_jumps.link(this);
+                    beginOp.m_jumps.clear();
+                }
+
+                // This is the entry point to continue after the parentheses.
+                op.m_jumps.link(this);
+                op.m_jumps.clear();
+                op.m_reentry = label();
+                break;
+            }
+
             // OpParentheticalAssertionBegin/End
             case OpParentheticalAssertionBegin: {
                 PatternTerm* term = op.m_term;
@@ -2124,11 +2509,7 @@ class YarrGenerator : private MacroAssembler {
                     m_backtrackingState.link(this);
 
                     // Plant a jump to the return address.
-                    unsigned parenthesesFrameLocation = term->frameLocation;
-                    unsigned alternativeFrameLocation = parenthesesFrameLocation;
-                    if (term->quantityType != QuantifierFixedCount)
-                        alternativeFrameLocation += YarrStackSpaceForBackTrackInfoParenthesesOnce;
-                    loadFromFrameAndJump(alternativeFrameLocation);
+                    loadFromFrameAndJump(alternativeFrameLocation(term));
 
                     // Link the DataLabelPtr associated with the end of the last
                     // alternative to this point.
@@ -2237,6 +2618,61 @@ class YarrGenerator : private MacroAssembler {
                 m_backtrackingState.append(op.m_jumps);
                 break;
 
+            // OpParenthesesSubpatternBegin/End
+            //
+            // Backtracking from after the parentheses backtracks into the last
+            // iteration, except that Greedy parentheses with no iterations matched
+            // backtrack straight out, and NonGreedy ones first try another
+            // iteration. When an iteration fails its context is popped: Greedy
+            // parentheses then continue after the subpattern with one iteration
+            // fewer, the others backtrack into the previous iteration, or out of
+            // the parentheses if there is none.
+            case OpParenthesesSubpatternBegin: {
+                PatternTerm* term = op.m_term;
+                YarrOp& endOp = m_ops[op.m_nextOp];
+                const RegisterID context = regT0;
+                const RegisterID temp = regT1;
+
+                m_backtrackingState.link(this);
+                popParenContext(term, context, temp);
+                if (term->quantityType == QuantifierGreedy)
+                    jump(endOp.m_reentry);
+                else {
+                    op.m_jumps.append(branchTestPtr(Zero, context));
+                    jump(endOp.m_reentry);
+                }
+
+                // Backtrack out of the parentheses.
+                op.m_jumps.link(this);
+                m_backtrackingState.fallthrough();
+                break;
+            }
+            case OpParenthesesSubpatternEnd: {
+                PatternTerm* term = op.m_term;
+                YarrOp& beginOp = m_ops[op.m_previousOp];
+                const RegisterID context = regT0;
+
+                m_backtrackingState.link(this);
+                loadFromFrame(term->frameLocation + 1, context);
+                if (term->quantityType == QuantifierGreedy)
+                    beginOp.m_jumps.append(branchTestPtr(Zero, context));
+                else if (term->quantityType == QuantifierNonGreedy) {
+                    if (term->quantityCount != quantifyInfinite) {
+                        branchTestPtr(Zero, context).linkTo(beginOp.m_reentry, this);
+                        branch32(NotEqual, Address(context, ParenContextCount * sizeof(void*)), TrustedImm32((term->quantityCount - 1).unsafeGet())).linkTo(beginOp.m_reentry, this);
+                    } else
+                        jump(beginOp.m_reentry);
+                }
+
+                // Backtracking into the last iteration continues into the subpattern's
+                // own backtracking. Only Greedy parentheses continue forwards when an
+                // iteration fails, so the others reuse m_reentry to get back here.
+                if (term->quantityType != QuantifierGreedy)
+                    op.m_reentry = label();
+                m_backtrackingState.fallthrough();
+                break;
+            }
+
             // OpParentheticalAssertionBegin/End
             case OpParentheticalAssertionBegin: {
                 PatternTerm* term = op.m_term;
@@ -2296,9 +2732,9 @@ class YarrGenerator : private MacroAssembler {
     // Emits ops for a subpattern (set of parentheses). These consist
     // of a set of alternatives wrapped in an outer set of nodes for
     // the parentheses.
-    // Supported types of parentheses are 'Once' (quantityCount == 1)
-    // and 'Terminal' (non-capturing parentheses quantified as greedy
-    // and infinite).
+    // Parentheses are either 'Once' (quantityCount == 1), 'Terminal'
+    // (non-capturing parentheses quantified as greedy and infinite),
+    // or iterated, saving their state on each iteration.
     // Alternatives will use the 'Simple' set of ops if either the
     // subpattern is terminal (in which case we will never need to
     // backtrack), or if the subpattern only contains one alternative.
@@ -2310,13 +2746,12 @@ class YarrGenerator : private MacroAssembler {
         YarrOpCode alternativeNextOpCode = OpSimpleNestedAlternativeNext;
         YarrOpCode alternativeEndOpCode = OpSimpleNestedAlternativeEnd;
 
-        // We can currently only compile quantity 1 subpatterns that are
-        // not copies. We generate a copy in the case of a range quantifier,
+        // Quantity 1 subpatterns that are not copies need no state beyond
+        // their frame. We generate a copy in the case of a range quantifier,
         // e.g. /(?:x){3,9}/, or /(?:x)+/ (These are effectively expanded to
-        // /(?:x){3,3}(?:x){0,6}/ and /(?:x)(?:x)*/ repectively). The problem
-        // comes where the subpattern is capturing, in which case we would
-        // need to restore the capture from the first subpattern upon a
-        // failure in the second.
+        // /(?:x){3,3}(?:x){0,6}/ and /(?:x)(?:x)*/ repectively), and where
+        // the subpattern is capturing we need to restore the capture from the
+        // first subpattern upon a failure in the second.
         if (term->quantityCount == 1 && !term->parentheses.isCopy) {
             // Select the 'Once' nodes.
             parenthesesBeginOpCode = OpParenthesesSubpatternOnceBegin;
@@ -2333,9 +2768,17 @@ class YarrGenerator : private MacroAssembler {
             parenthesesBeginOpCode = OpParenthesesSubpatternTerminalBegin;
             parenthesesEndOpCode = OpParenthesesSubpatternTerminalEnd;
         } else {
-            // This subpattern is not supported by the JIT.
-            m_shouldFallBack = true;
-            return;
+            // Select the iterated nodes.
+            parenthesesBeginOpCode = OpParenthesesSubpatternBegin;
+            parenthesesEndOpCode = OpParenthesesSubpatternEnd;
+            m_containsIteratedParentheses = true;
+
+            // Iterations are backtracked into, so need the non-simple nodes for more than one alternative.
+            if (term->parentheses.disjunction->m_alternatives.size() != 1) {
+                alternativeBeginOpCode = OpNestedAlternativeBegin;
+                alternativeNextOpCode = OpNestedAlternativeNext;
+                alternativeEndOpCode = OpNestedAlternativeEnd;
+            }
         }
 
         size_t parenBegin = m_ops.size();
@@ -2448,6 +2891,19 @@ class YarrGenerator : private MacroAssembler {
                 opCompileParentheticalAssertion(term);
                 break;
 
+            case PatternTerm::TypeBackReference:
+                // Backreferences read the capture from the output vector, which match-only
+                // code does not have. Case-insensitive comparison would need the full
+                // canonicalization tables, so is left to the interpreter.
+#if ENABLE(YARR_JIT_BACKREFERENCES)
+                if (compileMode == MatchOnly || m_pattern.m_ignoreCase)
+                    m_shouldFallBack = true;
+#else
+                m_shouldFallBack = true;
+#endif
+                m_ops.append(term);
+                break;
+
             default:
                 m_ops.append(term);
             }
@@ -2619,6 +3075,8 @@ public:
         , m_charSize(charSize)
         , m_charScale(m_charSize == Char8 ? TimesOne: TimesTwo)
         , m_shouldFallBack(false)
+        , m_containsIteratedParentheses(false)
+        , m_parenContextPool(0)
         , m_checked(0)
     {
     }
@@ -2653,9 +3111,28 @@ public:
             return;
         }
 
+        // Contexts left over from a previous match are dead.
+        if (m_containsIteratedParentheses) {
+            m_parenContextPool = &vm->regExpParenContextPool();
+            move(TrustedImmPtr(m_parenContextPool->addressOfFree()), regT0);
+            storePtr(TrustedImmPtr(m_parenContextPool->begin()), Address(regT0));
+            move(TrustedImmPtr(m_parenContextPool->addressOfRemainingIterations()), regT0);
+            store32(TrustedImm32(matchLimit), Address(regT0));
+        }
+
         generate();
         backtrack();
 
+        // If the contexts or the iteration budget ran out, return to have the match
+        // rerun in the interpreter.
+        if (!m_abortToInterpreter.empty()) {
+            m_abortToInterpreter.link(this);
+            removeCallFrame();
+            move(TrustedImmPtr(reinterpret_cast<void*>(static_cast<intptr_t>(JSRegExpJITCodeFailure))), returnRegister);
+            move(TrustedImm32(0), returnRegister2);
+            generateReturn();
+        }
+
         // Link & finalize the code.
         LinkBuffer linkBuffer(*vm, *this, REGEXP_CODE_ID);
         m_backtrackingState.linkDataLabels(linkBuffer);
@@ -2685,6 +3162,12 @@ private:
     // supported in the JIT; fall back to the interpreter when this is detected.
     bool m_shouldFallBack;
 
+    // Iterated parentheses save their state in the VM's context pool, and
+    // bail out to the interpreter if it or the iteration budget runs out.
+    bool m_containsIteratedParentheses;
+    YarrParenContextPool* m_parenContextPool;
+    JumpList m_abortToInterpreter;
+
     // The regular expression expressed as a linear sequence of operations.
     Vector<YarrOp, 128> m_ops;
 
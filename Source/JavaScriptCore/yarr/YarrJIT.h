@@ -40,6 +40,11 @@
 #define YARR_CALL
 #endif
 
+// Backreferences need a third scratch register, which only these targets can spare.
+#if CPU(ARM64) || CPU(MIPS) || (CPU(X86_64) && !OS(WINDOWS))
+#define ENABLE_YARR_JIT_BACKREFERENCES 1
+#endif
+
 namespace JSC {
 
 class VM;
@@ -47,6 +52,39 @@ class ExecutablePool;
 
 namespace Yarr {
 
+// Holds the state saved for each iteration of quantified parentheses matched by the JIT.
+// Contexts are allocated and released in stack order while a match runs, so a bump
+// pointer suffices. Generated code embeds the buffer's address, so it is never moved.
+// A match that runs out of space, or tries more iterations than the interpreter's
+// matchLimit, returns JSRegExpJITCodeFailure and is rerun in the interpreter.
+class YarrParenContextPool {
+    WTF_MAKE_NONCOPYABLE(YarrParenContextPool); WTF_MAKE_FAST_ALLOCATED;
+public:
+    static const size_t size = 128 * 1024;
+
+    YarrParenContextPool()
+        : m_begin(static_cast<char*>(fastMalloc(size)))
+        , m_free(m_begin)
+        , m_remainingIterations(0)
+    {
+    }
+
+    ~YarrParenContextPool()
+    {
+        fastFree(m_begin);
+    }
+
+    char* begin() const { return m_begin; }
+    char* end() const { return m_begin + size; }
+    char** addressOfFree() { return &m_free; }
+    unsigned* addressOfRemainingIterations() { return &m_remainingIterations; }
+
+private:
+    char* m_begin;
+    char* m_free;
+    unsigned m_remainingIterations;
+};
+
 class YarrCodeBlock {
 #if CPU(X86_64) || CPU(ARM64)
     typedef MatchResult (*YarrJITCode8)(const LChar* input, unsigned start, unsigned length, int* output) YARR_CALL;
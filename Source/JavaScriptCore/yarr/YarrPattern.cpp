@@ -626,9 +626,11 @@ public:
                     currentCallFrameSize = setupDisjunctionOffsets(term.parentheses.disjunction, currentCallFrameSize, currentInputPosition.unsafeGet());
                     term.inputPosition = currentInputPosition.unsafeGet();
                 } else {
+                    // The nested disjunction is laid out inline, after the backtracking info, so the
+                    // JIT can address it within its own frame. The interpreter gives each iteration
+                    // a frame of the nested disjunction's size, so simply leaves the prefix unused.
                     term.inputPosition = currentInputPosition.unsafeGet();
-                    setupDisjunctionOffsets(term.parentheses.disjunction, 0, currentInputPosition.unsafeGet());
-                    currentCallFrameSize += YarrStackSpaceForBackTrackInfoParentheses;
+                    currentCallFrameSize = setupDisjunctionOffsets(term.parentheses.disjunction, currentCallFrameSize + YarrStackSpaceForBackTrackInfoParentheses, currentInputPosition.unsafeGet());
                 }
                 // Fixed count of 1 could be accepted, if they have a fixed size *AND* if all alternatives are of the same length.
                 alternative->m_hasFixedSize = false;
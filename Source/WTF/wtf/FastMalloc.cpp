@@ -171,6 +171,15 @@ FastMallocStatistics fastMallocStatistics()
     return statistics;
 }
 
+FastMallocHeapStatistics fastMallocHeapStatistics()
+{
+    FastMallocHeapStatistics statistics;
+    memset(&statistics, 0, sizeof(statistics));
+    return statistics;
+}
+
+void setFastMallocScavengerParameters(double, size_t) { }
+
 size_t fastMallocSize(const void* p)
 {
 #if OS(DARWIN)
@@ -266,11 +275,41 @@ void releaseFastMallocFreeMemory()
 
 FastMallocStatistics fastMallocStatistics()
 {
-    // FIXME: This is incorrect; needs an implementation or to be removed.
-    FastMallocStatistics statistics = { 0, 0, 0 };
+    const bmalloc::HeapStatistics heap = bmalloc::api::heapStatistics();
+
+    FastMallocStatistics statistics;
+    statistics.reservedVMBytes = heap.reserved;
+    statistics.committedVMBytes = heap.smallCommitted + heap.mediumCommitted
+        + heap.largeInUse + heap.largeFree + heap.xLargeInUse;
+    statistics.freeListBytes = heap.smallFree + heap.mediumFree + heap.largeFree;
     return statistics;
 }
 
+FastMallocHeapStatistics fastMallocHeapStatistics()
+{
+    const bmalloc::HeapStatistics heap = bmalloc::api::heapStatistics();
+    static_assert(std::tuple_size<decltype(heap.sizeClassInUse)>::value == fastMallocSizeClassCount, "size classes must match bmalloc");
+
+    FastMallocHeapStatistics statistics;
+    statistics.smallInUse = heap.smallInUse;
+    statistics.smallFree = heap.smallFree;
+    statistics.smallCommitted = heap.smallCommitted;
+    statistics.mediumInUse = heap.mediumInUse;
+    statistics.mediumFree = heap.mediumFree;
+    statistics.mediumCommitted = heap.mediumCommitted;
+    statistics.largeInUse = heap.largeInUse;
+    statistics.largeFree = heap.largeFree;
+    statistics.xLargeInUse = heap.xLargeInUse;
+    statistics.reserved = heap.reserved;
+    std::copy(heap.sizeClassInUse.begin(), heap.sizeClassInUse.end(), statistics.sizeClassInUse);
+    return statistics;
+}
+
+void setFastMallocScavengerParameters(double delay, size_t retainedBytes)
+{
+    bmalloc::api::setScavengerParameters(std::chrono::milliseconds(static_cast<long long>(delay * 1000)), retainedBytes);
+}
+
 } // namespace WTF
 
 #endif // defined(USE_SYSTEM_MALLOC) && USE_SYSTEM_MALLOC
@@ -68,6 +68,31 @@ struct FastMallocStatistics {
 };
 WTF_EXPORT_PRIVATE FastMallocStatistics fastMallocStatistics();
 
+// Objects up to 1 kB are grouped in 8-byte size classes.
+const size_t fastMallocSizeClassCount = 128;
+
+// A breakdown of the heap by object size, in bytes. Small objects are up to
+// 256 bytes, medium up to 1 kB. In-use small and medium bytes include objects
+// cached by threads' allocators. All zero with the system malloc.
+struct FastMallocHeapStatistics {
+    size_t smallInUse;
+    size_t smallFree;
+    size_t smallCommitted;
+    size_t mediumInUse;
+    size_t mediumFree;
+    size_t mediumCommitted;
+    size_t largeInUse;
+    size_t largeFree;
+    size_t xLargeInUse;
+    size_t reserved;
+    size_t sizeClassInUse[fastMallocSizeClassCount];
+};
+WTF_EXPORT_PRIVATE FastMallocHeapStatistics fastMallocHeapStatistics();
+
+// Free memory is returned to the OS once the heap has gone this many seconds
+// without growing, keeping retainedBytes of free pages for reuse.
+WTF_EXPORT_PRIVATE void setFastMallocScavengerParameters(double delay, size_t retainedBytes);
+
 // This defines a type which holds an unsigned integer and is the same
 // size as the minimally aligned memory allocation.
 typedef unsigned long long AllocAlignmentInteger;
@@ -40,6 +40,10 @@
 #include <wtf/DataLog.h>
 #endif
 
+#if USE(HASHTABLE_CONTROL_BYTES) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace WTF {
 
 // Enables internal WTF consistency checks that are invoked automatically. Non-WTF callers can call checkTableConsistency() even if internal checks are disabled.
@@ -437,6 +441,15 @@ namespace WTF {
         void removeAndInvalidate(ValueType*);
         void remove(ValueType*);
 
+#if USE(HASHTABLE_CONTROL_BYTES)
+        static uint8_t* controlBytes(ValueType* table, unsigned size) { return reinterpret_cast<uint8_t*>(table + size); }
+        uint8_t* controlBytes() const { return controlBytes(m_table, m_tableSize); }
+        void setControlByte(ValueType*, uint8_t);
+
+        template<typename HashTranslator, typename T> ValueType* controlLookup(const T&, unsigned hash);
+        template<typename HashTranslator, typename T> LookupType controlLookupForWriting(const T&, unsigned hash);
+#endif
+
         bool shouldExpand() const { return (m_keyCount + m_deletedCount) * m_maxLoad >= m_tableSize; }
         bool mustRehashInPlace() const { return m_keyCount * m_minLoad < m_tableSize * 2; }
         bool shouldShrink() const { return m_keyCount * m_minLoad < m_tableSize && m_tableSize > KeyTraits::minimumTableSize; }
@@ -557,6 +570,90 @@ namespace WTF {
         return key;
     }
 
+#if USE(HASHTABLE_CONTROL_BYTES)
+
+    // With control bytes, each bucket also has one byte in an array after the
+    // buckets: seven bits of its hash when full, or a marker with the high bit set
+    // when empty or deleted. Probing compares a group of 16 of them at once, and only
+    // touches the buckets whose byte matches, so a miss usually reads no bucket at all.
+    // The first group's bytes are repeated past the end, so a group can start anywhere.
+    static const unsigned hashTableGroupWidth = 16;
+    static const uint8_t hashTableControlEmpty = 0x80;
+    static const uint8_t hashTableControlDeleted = 0xfe;
+
+    inline uint8_t hashTableControlTag(unsigned hash)
+    {
+        // String hashes only have 24 bits, so mix the low bits into the top ones.
+        return (hash * 0x9e3779b1U) >> 25;
+    }
+
+    class HashTableControlGroup {
+    public:
+        explicit HashTableControlGroup(const uint8_t* control)
+#if defined(__SSE2__)
+            : m_bytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control)))
+#else
+            : m_control(control)
+#endif
+        {
+        }
+
+        // Bit i of the result is set when byte i matches.
+        unsigned match(uint8_t tag) const
+        {
+#if defined(__SSE2__)
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(m_bytes, _mm_set1_epi8(tag)));
+#else
+            unsigned mask = 0;
+            for (unsigned i = 0; i < hashTableGroupWidth; ++i) {
+                if (m_control[i] == tag)
+                    mask |= 1 << i;
+            }
+            return mask;
+#endif
+        }
+
+        unsigned matchEmpty() const { return match(hashTableControlEmpty); }
+        unsigned matchDeleted() const { return match(hashTableControlDeleted); }
+
+        static unsigned lowestBit(unsigned mask) { return __builtin_ctz(mask); }
+
+    private:
+#if defined(__SSE2__)
+        __m128i m_bytes;
+#else
+        const uint8_t* m_control;
+#endif
+    };
+
+    // Groups are probed at triangular offsets, which visits every bucket of a
+    // power of two sized table.
+    class HashTableControlProbe {
+    public:
+        HashTableControlProbe(unsigned hash, unsigned sizeMask)
+            : m_offset(hash & sizeMask)
+            , m_stride(0)
+            , m_sizeMask(sizeMask)
+        {
+        }
+
+        unsigned offset() const { return m_offset; }
+        unsigned offset(unsigned i) const { return (m_offset + i) & m_sizeMask; }
+
+        void next()
+        {
+            m_stride += hashTableGroupWidth;
+            m_offset = (m_offset + m_stride) & m_sizeMask;
+        }
+
+    private:
+        unsigned m_offset;
+        unsigned m_stride;
+        unsigned m_sizeMask;
+    };
+
+#endif
+
 #if ASSERT_DISABLED
 
     template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
@@ -589,6 +686,11 @@ namespace WTF {
     {
         checkKey<HashTranslator>(key);
 
+#if USE(HASHTABLE_CONTROL_BYTES)
+        if (!m_table)
+            return 0;
+        return controlLookup<HashTranslator>(key, HashTranslator::hash(key));
+#else
         unsigned k = 0;
         unsigned sizeMask = m_tableSizeMask;
         ValueType* table = m_table;
@@ -637,6 +739,7 @@ namespace WTF {
                 k = 1 | doubleHash(h);
             i = (i + k) & sizeMask;
         }
+#endif
     }
 
     template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
@@ -646,6 +749,9 @@ namespace WTF {
         ASSERT(m_table);
         checkKey<HashTranslator>(key);
 
+#if USE(HASHTABLE_CONTROL_BYTES)
+        return controlLookupForWriting<HashTranslator>(key, HashTranslator::hash(key));
+#else
         unsigned k = 0;
         ValueType* table = m_table;
         unsigned sizeMask = m_tableSizeMask;
@@ -698,6 +804,7 @@ namespace WTF {
                 k = 1 | doubleHash(h);
             i = (i + k) & sizeMask;
         }
+#endif
     }
 
     template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
@@ -707,6 +814,11 @@ namespace WTF {
         ASSERT(m_table);
         checkKey<HashTranslator>(key);
 
+#if USE(HASHTABLE_CONTROL_BYTES)
+        unsigned h = HashTranslator::hash(key);
+        LookupType result = controlLookupForWriting<HashTranslator>(key, h);
+        return makeLookupResult(result.first, result.second, h);
+#else
         unsigned k = 0;
         ValueType* table = m_table;
         unsigned sizeMask = m_tableSizeMask;
@@ -759,8 +871,117 @@ namespace WTF {
                 k = 1 | doubleHash(h);
             i = (i + k) & sizeMask;
         }
+#endif
+    }
+
+#if USE(HASHTABLE_CONTROL_BYTES)
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline void HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::setControlByte(ValueType* entry, uint8_t control)
+    {
+        unsigned i = entry - m_table;
+        uint8_t* controlBytes = this->controlBytes();
+        controlBytes[i] = control;
+
+        // Tables smaller than a group repeat more than once.
+        for (unsigned j = i; j < hashTableGroupWidth; j += m_tableSize)
+            controlBytes[m_tableSize + j] = control;
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    template<typename HashTranslator, typename T>
+    inline auto HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::controlLookup(const T& key, unsigned h) -> ValueType*
+    {
+        ValueType* table = m_table;
+        const uint8_t* controlBytes = this->controlBytes();
+        uint8_t tag = hashTableControlTag(h);
+        HashTableControlProbe probe(h, m_tableSizeMask);
+
+#if DUMP_HASHTABLE_STATS
+        ++HashTableStats::numAccesses;
+        unsigned probeCount = 0;
+#endif
+
+#if DUMP_HASHTABLE_STATS_PER_TABLE
+        ++m_stats->numAccesses;
+#endif
+
+        while (1) {
+            HashTableControlGroup group(controlBytes + probe.offset());
+
+            // Only full buckets can match the tag, so this never compares to the empty or deleted value.
+            for (unsigned matches = group.match(tag); matches; matches &= matches - 1) {
+                ValueType* entry = table + probe.offset(HashTableControlGroup::lowestBit(matches));
+                if (HashTranslator::equal(Extractor::extract(*entry), key))
+                    return entry;
+            }
+
+            if (group.matchEmpty())
+                return 0;
+#if DUMP_HASHTABLE_STATS
+            ++probeCount;
+            HashTableStats::recordCollisionAtCount(probeCount);
+#endif
+
+#if DUMP_HASHTABLE_STATS_PER_TABLE
+            m_stats->recordCollisionAtCount(probeCount);
+#endif
+
+            probe.next();
+        }
     }
 
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    template<typename HashTranslator, typename T>
+    inline auto HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::controlLookupForWriting(const T& key, unsigned h) -> LookupType
+    {
+        ValueType* table = m_table;
+        const uint8_t* controlBytes = this->controlBytes();
+        uint8_t tag = hashTableControlTag(h);
+        HashTableControlProbe probe(h, m_tableSizeMask);
+
+#if DUMP_HASHTABLE_STATS
+        ++HashTableStats::numAccesses;
+        unsigned probeCount = 0;
+#endif
+
+#if DUMP_HASHTABLE_STATS_PER_TABLE
+        ++m_stats->numAccesses;
+#endif
+
+        ValueType* deletedEntry = 0;
+
+        while (1) {
+            HashTableControlGroup group(controlBytes + probe.offset());
+
+            for (unsigned matches = group.match(tag); matches; matches &= matches - 1) {
+                ValueType* entry = table + probe.offset(HashTableControlGroup::lowestBit(matches));
+                if (HashTranslator::equal(Extractor::extract(*entry), key))
+                    return LookupType(entry, true);
+            }
+
+            if (!deletedEntry) {
+                if (unsigned deleted = group.matchDeleted())
+                    deletedEntry = table + probe.offset(HashTableControlGroup::lowestBit(deleted));
+            }
+
+            if (unsigned empty = group.matchEmpty())
+                return LookupType(deletedEntry ? deletedEntry : table + probe.offset(HashTableControlGroup::lowestBit(empty)), false);
+#if DUMP_HASHTABLE_STATS
+            ++probeCount;
+            HashTableStats::recordCollisionAtCount(probeCount);
+#endif
+
+#if DUMP_HASHTABLE_STATS_PER_TABLE
+            m_stats->recordCollisionAtCount(probeCount);
+#endif
+
+            probe.next();
+        }
+    }
+
+#endif
+
     template<bool emptyValueIsZero> struct HashTableBucketInitializer;
 
     template<> struct HashTableBucketInitializer<false> {
@@ -801,6 +1022,20 @@ namespace WTF {
 
         ASSERT(m_table);
 
+#if USE(HASHTABLE_CONTROL_BYTES)
+        unsigned h = HashTranslator::hash(key);
+        LookupType lookupResult = controlLookupForWriting<HashTranslator>(key, h);
+        ValueType* entry = lookupResult.first;
+        if (lookupResult.second)
+            return AddResult(makeKnownGoodIterator(entry), false);
+
+        if (isDeletedBucket(*entry)) {
+            initializeBucket(*entry);
+            --m_deletedCount;
+        }
+
+        setControlByte(entry, hashTableControlTag(h));
+#else
         unsigned k = 0;
         ValueType* table = m_table;
         unsigned sizeMask = m_tableSizeMask;
@@ -859,6 +1094,7 @@ namespace WTF {
             entry = deletedEntry;
             --m_deletedCount; 
         }
+#endif
 
         HashTranslator::translate(*entry, std::forward<T>(key), std::forward<Extra>(extra));
         ++m_keyCount;
@@ -898,6 +1134,10 @@ namespace WTF {
             --m_deletedCount;
         }
 
+#if USE(HASHTABLE_CONTROL_BYTES)
+        setControlByte(entry, hashTableControlTag(h));
+#endif
+
         HashTranslator::translate(*entry, std::forward<T>(key), std::forward<Extra>(extra), h);
         ++m_keyCount;
 
@@ -922,7 +1162,13 @@ namespace WTF {
         ++m_stats->numReinserts;
 #endif
 
+#if USE(HASHTABLE_CONTROL_BYTES)
+        unsigned h = IdentityTranslatorType::hash(Extractor::extract(entry));
+        Value* newEntry = controlLookupForWriting<IdentityTranslatorType>(Extractor::extract(entry), h).first;
+        setControlByte(newEntry, hashTableControlTag(h));
+#else
         Value* newEntry = lookupForWriting(Extractor::extract(entry)).first;
+#endif
         newEntry->~Value();
         new (NotNull, newEntry) ValueType(WTF::move(entry));
 
@@ -993,6 +1239,9 @@ namespace WTF {
 #endif
 
         deleteBucket(*pos);
+#if USE(HASHTABLE_CONTROL_BYTES)
+        setControlByte(pos, hashTableControlDeleted);
+#endif
         ++m_deletedCount;
         --m_keyCount;
 
@@ -1047,6 +1296,9 @@ namespace WTF {
                 continue;
             
             deleteBucket(m_table[i]);
+#if USE(HASHTABLE_CONTROL_BYTES)
+            setControlByte(&m_table[i], hashTableControlDeleted);
+#endif
             ++m_deletedCount;
             --m_keyCount;
         }
@@ -1060,13 +1312,25 @@ namespace WTF {
     template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
     auto HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::allocateTable(unsigned size) -> ValueType*
     {
+#if USE(HASHTABLE_CONTROL_BYTES)
+        // The control bytes share the allocation, right after the buckets.
+        size_t allocationSize = size * sizeof(ValueType) + size + hashTableGroupWidth;
+#else
+        size_t allocationSize = size * sizeof(ValueType);
+#endif
         // would use a template member function with explicit specializations here, but
         // gcc doesn't appear to support that
+        ValueType* result;
         if (Traits::emptyValueIsZero)
-            return static_cast<ValueType*>(fastZeroedMalloc(size * sizeof(ValueType)));
-        ValueType* result = static_cast<ValueType*>(fastMalloc(size * sizeof(ValueType)));
-        for (unsigned i = 0; i < size; i++)
-            initializeBucket(result[i]);
+            result = static_cast<ValueType*>(fastZeroedMalloc(allocationSize));
+        else {
+            result = static_cast<ValueType*>(fastMalloc(allocationSize));
+            for (unsigned i = 0; i < size; i++)
+                initializeBucket(result[i]);
+        }
+#if USE(HASHTABLE_CONTROL_BYTES)
+        memset(controlBytes(result, size), hashTableControlEmpty, size + hashTableGroupWidth);
+#endif
         return result;
     }
 
@@ -1259,14 +1523,25 @@ namespace WTF {
         unsigned deletedCount = 0;
         for (unsigned j = 0; j < m_tableSize; ++j) {
             ValueType* entry = m_table + j;
-            if (isEmptyBucket(*entry))
+            if (isEmptyBucket(*entry)) {
+#if USE(HASHTABLE_CONTROL_BYTES)
+                ASSERT(controlBytes()[j] == hashTableControlEmpty);
+#endif
                 continue;
+            }
 
             if (isDeletedBucket(*entry)) {
+#if USE(HASHTABLE_CONTROL_BYTES)
+                ASSERT(controlBytes()[j] == hashTableControlDeleted);
+#endif
                 ++deletedCount;
                 continue;
             }
 
+#if USE(HASHTABLE_CONTROL_BYTES)
+            ASSERT(controlBytes()[j] == hashTableControlTag(HashFunctions::hash(Extractor::extract(*entry))));
+#endif
+
             const_iterator it = find(Extractor::extract(*entry));
             ASSERT(entry == it.m_position);
             ++count;
@@ -1274,6 +1549,11 @@ namespace WTF {
             ValueCheck<Key>::checkConsistency(it->key);
         }
 
+#if USE(HASHTABLE_CONTROL_BYTES)
+        for (unsigned j = 0; j < hashTableGroupWidth; ++j)
+            ASSERT(controlBytes()[m_tableSize + j] == controlBytes()[j & m_tableSizeMask]);
+#endif
+
         ASSERT(count == m_keyCount);
         ASSERT(deletedCount == m_deletedCount);
         ASSERT(m_tableSize >= KeyTraits::minimumTableSize);
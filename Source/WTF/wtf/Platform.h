@@ -698,7 +698,7 @@
 #define HAVE_LLVM 1
 #endif
 
-#if PLATFORM(GTK) && HAVE(LLVM) && ENABLE(JIT) && !defined(ENABLE_FTL_JIT) && CPU(X86_64)
+#if (PLATFORM(GTK) || PLATFORM(FLTK)) && HAVE(LLVM) && ENABLE(JIT) && !defined(ENABLE_FTL_JIT) && CPU(X86_64)
 #define ENABLE_FTL_JIT 1
 #endif
 
@@ -767,6 +767,12 @@
 #define ENABLE_CONCURRENT_JIT 1
 #endif
 
+/* LLVM compiles are too slow to run on the main thread, so the FTL build of the
+   FLTK port compiles in the background. */
+#if PLATFORM(FLTK) && ENABLE(FTL_JIT) && !defined(ENABLE_CONCURRENT_JIT)
+#define ENABLE_CONCURRENT_JIT 1
+#endif
+
 /* If the baseline jit is not available, then disable upper tiers as well: */
 #if !ENABLE(JIT)
 #undef ENABLE_DFG_JIT      /* Undef so that we can redefine it. */
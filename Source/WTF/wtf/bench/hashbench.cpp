@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2015 Lauri Kasanen
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Microbenchmarks for HashMap/HashSet: inserting, finding present and absent keys,
+// removing and adding back, and iterating, at sizes from in-cache to far out of it.
+// Build both table layouts with "make bench/hashbench" and "make HASHCONTROL=1 bench/hashbench"
+// (after a clean, so libwtf matches) and compare the ns/op columns.
+
+#include "config.h"
+
+#include <stdio.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/HashMap.h>
+#include <wtf/HashSet.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+#include <wtf/text/StringHash.h>
+#include <wtf/text/WTFString.h>
+
+using namespace WTF;
+
+static unsigned sink;
+
+static unsigned nextRandom(unsigned& state)
+{
+    // xorshift, so the keys don't depend on the libc.
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+template<typename Key> struct KeyMaker;
+
+template<> struct KeyMaker<unsigned> {
+    static const char* name() { return "int"; }
+    static unsigned make(unsigned i) { return i; }
+};
+
+template<> struct KeyMaker<void*> {
+    static const char* name() { return "pointer"; }
+    static void* make(unsigned i) { return reinterpret_cast<void*>(static_cast<uintptr_t>(i) << 4); }
+};
+
+template<> struct KeyMaker<String> {
+    static const char* name() { return "string"; }
+    static String make(unsigned i) { return String::format("property-%u", i); }
+};
+
+static void report(const char* key, unsigned size, const char* op, double start, unsigned ops)
+{
+    printf("%-8s %8u  %-8s %8.2f ns/op\n", key, size, op, (monotonicallyIncreasingTime() - start) * 1e9 / ops);
+}
+
+template<typename Key>
+static void run(unsigned size)
+{
+    // Keep the total work per row roughly constant.
+    const unsigned passes = std::max(1U, (1U << 22) / size);
+    unsigned state = 2463534242U;
+
+    Vector<Key> present;
+    Vector<Key> absent;
+    present.reserveInitialCapacity(size);
+    absent.reserveInitialCapacity(size);
+    for (unsigned i = 0; i < size; ++i) {
+        // Even numbers are present and odd ones absent, and neither is 0 or -1.
+        unsigned r = (nextRandom(state) & 0x3fffffff) * 2 + 2;
+        present.uncheckedAppend(KeyMaker<Key>::make(r));
+        absent.uncheckedAppend(KeyMaker<Key>::make(r + 1));
+    }
+    const char* name = KeyMaker<Key>::name();
+
+    double start = monotonicallyIncreasingTime();
+    for (unsigned pass = 0; pass < passes; ++pass) {
+        HashMap<Key, unsigned> map;
+        for (unsigned i = 0; i < size; ++i)
+            map.add(present[i], i);
+        sink += map.size();
+    }
+    report(name, size, "insert", start, passes * size);
+
+    HashMap<Key, unsigned> map;
+    for (unsigned i = 0; i < size; ++i)
+        map.add(present[i], i);
+
+    start = monotonicallyIncreasingTime();
+    for (unsigned pass = 0; pass < passes; ++pass) {
+        for (unsigned i = 0; i < size; ++i)
+            sink += map.get(present[i]);
+    }
+    report(name, size, "hit", start, passes * size);
+
+    start = monotonicallyIncreasingTime();
+    for (unsigned pass = 0; pass < passes; ++pass) {
+        for (unsigned i = 0; i < size; ++i)
+            sink += map.contains(absent[i]);
+    }
+    report(name, size, "miss", start, passes * size);
+
+    // Leaves deleted buckets behind, which the probes then have to skip.
+    start = monotonicallyIncreasingTime();
+    for (unsigned pass = 0; pass < passes; ++pass) {
+        for (unsigned i = 0; i < size; i += 2) {
+            map.remove(present[i]);
+            map.add(present[i], i);
+        }
+    }
+    report(name, size, "churn", start, passes * size);
+
+    start = monotonicallyIncreasingTime();
+    for (unsigned pass = 0; pass < passes; ++pass) {
+        for (auto& entry : map)
+            sink += entry.value;
+    }
+    report(name, size, "iterate", start, passes * size);
+}
+
+int main()
+{
+    initializeThreading();
+
+#if USE(HASHTABLE_CONTROL_BYTES)
+    printf("Control bytes, group probing\n\n");
+#else
+    printf("Double hashing\n\n");
+#endif
+
+    static const unsigned sizes[] = { 64, 4096, 262144, 4194304 };
+    for (unsigned size : sizes)
+        run<unsigned>(size);
+    for (unsigned size : sizes)
+        run<void*>(size);
+    // Four million strings would mostly measure the allocator.
+    for (unsigned size : sizes) {
+        if (size <= 262144)
+            run<String>(size);
+    }
+
+    return !sink;
+}
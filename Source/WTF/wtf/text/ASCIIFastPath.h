@@ -27,7 +27,7 @@
 #include <wtf/StdLibExtras.h>
 #include <wtf/text/LChar.h>
 
-#if OS(DARWIN) && (CPU(X86) || CPU(X86_64))
+#if (OS(DARWIN) && (CPU(X86) || CPU(X86_64))) || defined(__SSE2__)
 #include <emmintrin.h>
 #endif
 
@@ -107,6 +107,57 @@ inline bool charactersAreAllASCII(const CharacterType* characters, size_t length
     return !(allCharBits & nonASCIIBitMask);
 }
 
+#if defined(__SSE2__)
+inline const LChar* findControlCharacterOrSSE2(const LChar* characters, const LChar* end, LChar first, LChar second)
+{
+    const __m128i controlMax = _mm_set1_epi8(0x1F);
+    const __m128i firstVector = _mm_set1_epi8(first);
+    const __m128i secondVector = _mm_set1_epi8(second);
+    for (; end - characters >= 16; characters += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters));
+        // A saturating subtract leaves zero exactly for the bytes <= 0x1F.
+        __m128i control = _mm_cmpeq_epi8(_mm_subs_epu8(chunk, controlMax), _mm_setzero_si128());
+        __m128i matches = _mm_or_si128(control, _mm_or_si128(_mm_cmpeq_epi8(chunk, firstVector), _mm_cmpeq_epi8(chunk, secondVector)));
+        if (unsigned mask = _mm_movemask_epi8(matches))
+            return characters + __builtin_ctz(mask);
+    }
+    return characters;
+}
+
+inline const UChar* findControlCharacterOrSSE2(const UChar* characters, const UChar* end, UChar first, UChar second)
+{
+    const __m128i controlMax = _mm_set1_epi16(0x1F);
+    const __m128i firstVector = _mm_set1_epi16(first);
+    const __m128i secondVector = _mm_set1_epi16(second);
+    for (; end - characters >= 8; characters += 8) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters));
+        __m128i control = _mm_cmpeq_epi16(_mm_subs_epu16(chunk, controlMax), _mm_setzero_si128());
+        __m128i matches = _mm_or_si128(control, _mm_or_si128(_mm_cmpeq_epi16(chunk, firstVector), _mm_cmpeq_epi16(chunk, secondVector)));
+        // movemask yields two bits per 16-bit lane.
+        if (unsigned mask = _mm_movemask_epi8(matches))
+            return characters + (__builtin_ctz(mask) >> 1);
+    }
+    return characters;
+}
+#endif
+
+// Returns the first character in [characters, end) that is a control character
+// (below 0x20) or equal to first or second, or end if there is none. This is the
+// set of characters that stops both JSON string lexing and JSON quoting.
+template<typename CharacterType>
+inline const CharacterType* findControlCharacterOr(const CharacterType* characters, const CharacterType* end, CharacterType first, CharacterType second)
+{
+#if defined(__SSE2__)
+    characters = findControlCharacterOrSSE2(characters, end, first, second);
+#endif
+    for (; characters != end; ++characters) {
+        CharacterType character = *characters;
+        if (character < 0x20 || character == first || character == second)
+            break;
+    }
+    return characters;
+}
+
 inline void copyLCharsFromUCharSource(LChar* destination, const UChar* source, size_t length)
 {
 #if OS(DARWIN) && (CPU(X86) || CPU(X86_64))
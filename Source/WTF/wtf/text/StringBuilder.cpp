@@ -31,6 +31,7 @@
 #include "MathExtras.h"
 #include "WTFString.h"
 #include <wtf/dtoa.h>
+#include <wtf/text/ASCIIFastPath.h>
 
 namespace WTF {
 
@@ -365,9 +366,15 @@ template <typename OutputCharacterType, typename InputCharacterType>
 static void appendQuotedJSONStringInternal(OutputCharacterType*& output, const InputCharacterType* input, unsigned length)
 {
     for (const InputCharacterType* end = input + length; input != end; ++input) {
-        if (*input > 0x1F && *input != '"' && *input != '\\') {
-            *output++ = *input;
-            continue;
+        // Copy everything up to the next character that needs escaping in one go.
+        // For typical JSON that is the whole string.
+        const InputCharacterType* runEnd = findControlCharacterOr<InputCharacterType>(input, end, '"', '\\');
+        if (runEnd != input) {
+            StringImpl::copyChars(output, input, runEnd - input);
+            output += runEnd - input;
+            input = runEnd;
+            if (input == end)
+                break;
         }
         switch (*input) {
         case '\t':
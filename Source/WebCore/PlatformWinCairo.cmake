@@ -115,7 +115,9 @@ list(APPEND WebCore_SOURCES
     platform/network/curl/CredentialStorageCurl.cpp
     platform/network/curl/CurlCacheEntry.cpp
     platform/network/curl/CurlCacheManager.cpp
+    platform/network/curl/CurlContentDecoder.cpp
     platform/network/curl/CurlDownload.cpp
+    platform/network/curl/CurlRecordReplay.cpp
     platform/network/curl/DNSCurl.cpp
     platform/network/curl/FormDataStreamCurl.cpp
     platform/network/curl/MultipartHandle.cpp
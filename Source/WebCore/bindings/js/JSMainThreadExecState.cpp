@@ -34,6 +34,7 @@
 namespace WebCore {
 
 JSC::ExecState* JSMainThreadExecState::s_mainThreadState = 0;
+ScriptStatistics JSMainThreadExecState::s_statistics;
 
 void JSMainThreadExecState::didLeaveScriptContext()
 {
@@ -29,6 +29,7 @@
 #include "JSDOMBinding.h"
 #include <runtime/Completion.h>
 #include <runtime/Microtask.h>
+#include <wtf/CurrentTime.h>
 #include <wtf/MainThread.h>
 
 #if PLATFORM(IOS)
@@ -40,6 +41,13 @@ namespace WebCore {
 class InspectorInstrumentationCookie;
 class ScriptExecutionContext;
 
+// Each entry is a run of script from the event loop, including the
+// layouts and style updates it forces.
+struct ScriptStatistics {
+    uint64_t entries;
+    double scriptTime; // Seconds.
+};
+
 class JSMainThreadExecState {
     WTF_MAKE_NONCOPYABLE(JSMainThreadExecState);
     friend class JSMainThreadNullState;
@@ -70,10 +78,13 @@ public:
 
     static InspectorInstrumentationCookie instrumentFunctionCall(ScriptExecutionContext*, JSC::CallType, const JSC::CallData&);
 
+    static ScriptStatistics statistics() { return s_statistics; }
+
 private:
     explicit JSMainThreadExecState(JSC::ExecState* exec)
         : m_previousState(s_mainThreadState)
         , m_lock(exec)
+        , m_startTime(m_previousState ? 0 : monotonicallyIncreasingTime())
     {
         ASSERT(isMainThread());
         s_mainThreadState = exec;
@@ -88,13 +99,19 @@ private:
 
         s_mainThreadState = m_previousState;
 
-        if (didExitJavaScript)
+        if (didExitJavaScript) {
+            ++s_statistics.entries;
+            s_statistics.scriptTime += monotonicallyIncreasingTime() - m_startTime;
             didLeaveScriptContext();
+        }
     }
 
     static JSC::ExecState* s_mainThreadState;
     JSC::ExecState* m_previousState;
     JSC::JSLockHolder m_lock;
+    double m_startTime;
+
+    static ScriptStatistics s_statistics;
 
     static void didLeaveScriptContext();
 };
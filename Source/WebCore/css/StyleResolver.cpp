@@ -777,6 +777,8 @@ Ref<RenderStyle> StyleResolver::styleForElement(Element* element, RenderStyle* d
     // will vanish if a style recalc happens during loading.
     if (sharingBehavior == AllowStyleSharing && !element->document().haveStylesheetsLoaded() && !element->renderer()) {
         if (!s_styleNotYetAvailable) {
+            // Shared by all documents, so it can't use this one's arena.
+            RenderArenaScope noRenderArena(nullptr);
             s_styleNotYetAvailable = &RenderStyle::create().leakRef();
             s_styleNotYetAvailable->setDisplay(NONE);
             s_styleNotYetAvailable->fontCascade().update(&document().fontSelector());
@@ -118,6 +118,7 @@
 #include "PointerLockController.h"
 #include "PopStateEvent.h"
 #include "ProcessingInstruction.h"
+#include "RenderArena.h"
 #include "RenderChildIterator.h"
 #include "RenderLayerCompositor.h"
 #include "RenderView.h"
@@ -1744,6 +1745,7 @@ void Document::recalcStyle(Style::Change change)
     if (m_inStyleRecalc)
         return; // Guard against re-entrancy. -dwh
 
+    RenderArenaScope renderArenaScope(renderArena());
     RenderView::RepaintRegionAccumulator repaintRegionAccumulator(renderView());
     AnimationUpdateBlock animationUpdateBlock(&m_frame->animation());
 
@@ -2099,6 +2101,8 @@ void Document::createRenderTree()
     if (m_isNonRenderedPlaceholder)
         return;
 
+    RenderArenaScope renderArenaScope(renderArena());
+
     // FIXME: It would be better if we could pass the resolved document style directly here.
     m_renderView = createRenderer<RenderView>(*this, RenderStyle::create());
     Node::setRenderer(m_renderView.get());
@@ -2108,6 +2112,13 @@ void Document::createRenderTree()
     recalcStyle(Style::Force);
 }
 
+RenderArena* Document::renderArena()
+{
+    if (!m_renderArena)
+        m_renderArena = RenderArena::create();
+    return m_renderArena.get();
+}
+
 void Document::didBecomeCurrentDocumentInFrame()
 {
     // FIXME: Are there cases where the document can be dislodged from the frame during the event handling below?
@@ -2194,6 +2205,10 @@ void Document::destroyRenderTree()
     m_renderView = nullptr;
     Node::setRenderer(nullptr);
 
+    // The arena frees its memory once the objects still alive in it are gone.
+    // A new render tree starts a new one.
+    m_renderArena = nullptr;
+
 #if ENABLE(IOS_TEXT_AUTOSIZING)
     // Do this before the arena is cleared, which is needed to deref the RenderStyle on TextAutoSizingKey.
     m_textAutoSizedNodes.clear();
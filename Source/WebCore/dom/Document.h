@@ -138,6 +138,7 @@ class ProcessingInstruction;
 class QualifiedName;
 class Range;
 class RegisteredEventListener;
+class RenderArena;
 class RenderView;
 class RenderFullScreen;
 class ScriptableDocumentParser;
@@ -568,6 +569,7 @@ public:
     virtual void stopActiveDOMObjects() override final;
 
     RenderView* renderView() const { return m_renderView.get(); }
+    RenderArena* renderArena();
 
     bool renderTreeBeingDestroyed() const { return m_renderTreeBeingDestroyed; }
     bool hasLivingRenderTree() const { return renderView() && !renderTreeBeingDestroyed(); }
@@ -1543,6 +1545,7 @@ private:
     bool m_isSrcdocDocument;
 
     RenderPtr<RenderView> m_renderView;
+    RefPtr<RenderArena> m_renderArena;
     mutable DocumentEventQueue m_eventQueue;
 
     WeakPtrFactory<Document> m_weakFactory;
@@ -54,6 +54,8 @@ LinkRelAttribute::LinkRelAttribute(const String& rel)
 #endif
     else if (equalIgnoringCase(rel, "dns-prefetch"))
         isDNSPrefetch = true;
+    else if (equalIgnoringCase(rel, "preconnect"))
+        isPreconnect = true;
     else if (equalIgnoringCase(rel, "alternate stylesheet") || equalIgnoringCase(rel, "stylesheet alternate")) {
         isStyleSheet = true;
         isAlternate = true;
@@ -70,6 +72,8 @@ LinkRelAttribute::LinkRelAttribute(const String& rel)
                 isAlternate = true;
             else if (equalIgnoringCase(word, "icon"))
                 iconType = Favicon;
+            else if (equalIgnoringCase(word, "preconnect"))
+                isPreconnect = true;
 #if ENABLE(TOUCH_ICON_LOADING)
             else if (equalIgnoringCase(word, "apple-touch-icon"))
                 iconType = TouchIcon;
@@ -102,6 +102,12 @@ bool LinkLoader::loadLink(const LinkRelAttribute& relAttribute, const URL& href,
             prefetchDNS(href.host());
     }
 
+    if (relAttribute.isPreconnect) {
+        Settings* settings = document.settings();
+        if (settings && settings->dnsPrefetchingEnabled() && href.isValid() && href.protocolIsInHTTPFamily())
+            preconnectTo(href, PreconnectReason::LinkHint);
+    }
+
 #if ENABLE(LINK_PREFETCH)
     if ((relAttribute.isLinkPrefetch || relAttribute.isLinkSubresource) && href.isValid() && document.frame()) {
         if (!m_client.shouldLoadLink())
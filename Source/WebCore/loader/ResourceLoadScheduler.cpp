@@ -229,6 +229,13 @@ void ResourceLoadScheduler::setDefersLoading(ResourceLoader*, bool)
 {
 }
 
+void ResourceLoadScheduler::didChangePriority(ResourceLoader* resourceLoader, ResourceLoadPriority priority)
+{
+    HostInformation* host = hostForURL(resourceLoader->url());
+    if (host && host->reschedule(resourceLoader, priority))
+        scheduleServePendingRequests();
+}
+
 void ResourceLoadScheduler::crossOriginRedirectReceived(ResourceLoader* resourceLoader, const URL& redirectURL)
 {
     HostInformation* oldHost = hostForURL(resourceLoader->url());
@@ -383,6 +390,20 @@ void ResourceLoadScheduler::HostInformation::remove(ResourceLoader* resourceLoad
     }
 }
 
+bool ResourceLoadScheduler::HostInformation::reschedule(ResourceLoader* resourceLoader, ResourceLoadPriority priority)
+{
+    for (auto& requestQueue : m_requestsPending) {
+        for (auto it = requestQueue.begin(), end = requestQueue.end(); it != end; ++it) {
+            if (*it == resourceLoader) {
+                requestQueue.remove(it);
+                schedule(resourceLoader, priority);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 bool ResourceLoadScheduler::HostInformation::hasRequests() const
 {
     if (!m_requestsLoading.isEmpty())
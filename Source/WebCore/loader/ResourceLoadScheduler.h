@@ -55,6 +55,7 @@ public:
     WEBCORE_EXPORT virtual PassRefPtr<NetscapePlugInStreamLoader> schedulePluginStreamLoad(Frame*, NetscapePlugInStreamLoaderClient*, const ResourceRequest&);
     WEBCORE_EXPORT virtual void remove(ResourceLoader*);
     virtual void setDefersLoading(ResourceLoader*, bool);
+    virtual void didChangePriority(ResourceLoader*, ResourceLoadPriority);
     virtual void crossOriginRedirectReceived(ResourceLoader*, const URL& redirectURL);
     
     WEBCORE_EXPORT virtual void servePendingRequests(ResourceLoadPriority minimumPriority = ResourceLoadPriority::VeryLow);
@@ -97,6 +98,7 @@ private:
         void schedule(ResourceLoader*, ResourceLoadPriority = ResourceLoadPriority::VeryLow);
         void addLoadInProgress(ResourceLoader*);
         void remove(ResourceLoader*);
+        bool reschedule(ResourceLoader*, ResourceLoadPriority);
         bool hasRequests() const;
         bool limitRequests(ResourceLoadPriority) const;
 
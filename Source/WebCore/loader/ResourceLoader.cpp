@@ -190,6 +190,20 @@ void ResourceLoader::start()
     }
 }
 
+// Loads still waiting in the scheduler move to the new priority's queue,
+// started ones pass it on to the network layer.
+void ResourceLoader::didChangePriority(ResourceLoadPriority priority)
+{
+    if (m_request.priority() == priority)
+        return;
+
+    m_request.setPriority(priority);
+    if (m_handle)
+        m_handle->didChangePriority(priority);
+    else
+        platformStrategies()->loaderStrategy()->resourceLoadScheduler()->didChangePriority(this, priority);
+}
+
 void ResourceLoader::setDefersLoading(bool defers)
 {
     m_defersLoading = defers;
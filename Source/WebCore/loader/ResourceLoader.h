@@ -87,6 +87,8 @@ public:
     virtual void setDefersLoading(bool);
     bool defersLoading() const { return m_defersLoading; }
 
+    void didChangePriority(ResourceLoadPriority);
+
     unsigned long identifier() const { return m_identifier; }
 
     virtual void releaseResources();
@@ -94,6 +96,7 @@ public:
 
     SharedBuffer* resourceData() const { return m_resourceData.get(); }
     void clearResourceData();
+    PassRefPtr<SharedBuffer> takeResourceData() { return m_resourceData.release(); }
     
     virtual bool isSubresourceLoader();
 
@@ -327,6 +327,7 @@ void CachedImage::clear()
 {
     destroyDecodedData();
     clearImage();
+    m_previousImage = nullptr;
     m_pendingContainerSizeRequests.clear();
     setEncodedSize(0);
 }
@@ -348,7 +349,12 @@ inline void CachedImage::createImage()
     } else {
         m_image = BitmapImage::create(this);
         downcast<BitmapImage>(*m_image).setAllowSubsampling(m_loader && m_loader->frameLoader()->frame().settings().imageSubsamplingEnabled());
+#if !USE(CG)
+        if (m_previousImage)
+            downcast<BitmapImage>(*m_image).reuseFrameBufferOf(downcast<BitmapImage>(*m_previousImage));
+#endif
     }
+    m_previousImage = nullptr;
 
     if (m_image) {
         // Send queued container size requests.
@@ -449,13 +455,29 @@ void CachedImage::error(CachedResource::Status status)
 
 void CachedImage::responseReceived(const ResourceResponse& response)
 {
-    if (!m_response.isNull())
+    if (!m_response.isNull()) {
+#if !USE(CG)
+        // The next part of a multipart/x-mixed-replace response, like the next
+        // frame of a camera feed: the new image decodes into the frame buffer
+        // of the last one, so keep that around until then.
+        RefPtr<Image> previousImage;
+        if (m_image && m_image->isBitmapImage() && m_image->hasOneRef() && response.mimeType() == m_response.mimeType()) {
+            m_image->setImageObserver(0);
+            previousImage = m_image.release();
+            setDecodedSize(0);
+        }
+#endif
         clear();
+#if !USE(CG)
+        m_previousImage = previousImage.release();
+#endif
+    }
     CachedResource::responseReceived(response);
 }
 
 void CachedImage::destroyDecodedData()
 {
+    m_previousImage = nullptr;
     bool canDeleteImage = !m_image || (m_image->hasOneRef() && m_image->isBitmapImage());
     if (canDeleteImage && !isLoading() && !hasClients()) {
         m_image = 0;
@@ -132,6 +132,8 @@ private:
     ContainerSizeRequests m_pendingContainerSizeRequests;
 
     RefPtr<Image> m_image;
+    // The image of the previous multipart part, until the next one takes its frame buffer.
+    RefPtr<Image> m_previousImage;
     std::unique_ptr<SVGImageCache> m_svgImageCache;
     unsigned m_isManuallyCached : 1;
     unsigned m_shouldPaintBrokenImage : 1;
@@ -746,6 +746,17 @@ void CachedResource::setLoadPriority(const Optional<ResourceLoadPriority>& loadP
         m_loadPriority = defaultPriorityForResourceType(type());
 }
 
+void CachedResource::didChangePriority(ResourceLoadPriority loadPriority)
+{
+    if (m_loadPriority == loadPriority)
+        return;
+
+    m_loadPriority = loadPriority;
+    m_resourceRequest.setPriority(loadPriority);
+    if (m_loader)
+        m_loader->didChangePriority(loadPriority);
+}
+
 inline CachedResource::Callback::Callback(CachedResource& resource, CachedResourceClient& client)
     : m_resource(resource)
     , m_client(client)
@@ -118,6 +118,8 @@ public:
     
     ResourceLoadPriority loadPriority() const { return m_loadPriority; }
     void setLoadPriority(const Optional<ResourceLoadPriority>&);
+    // Reprioritizes the load if it is in progress.
+    void didChangePriority(ResourceLoadPriority);
 
     WEBCORE_EXPORT void addClient(CachedResourceClient*);
     WEBCORE_EXPORT void removeClient(CachedResourceClient*);
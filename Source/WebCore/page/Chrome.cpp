@@ -389,8 +389,11 @@ IntRect Chrome::windowResizerRect() const
 
 void Chrome::mouseDidMoveOverElement(const HitTestResult& result, unsigned modifierFlags)
 {
-    if (result.innerNode() && result.innerNode()->document().isDNSPrefetchEnabled())
+    if (result.innerNode() && result.innerNode()->document().isDNSPrefetchEnabled()) {
         prefetchDNS(result.absoluteLinkURL().host());
+        if (result.absoluteLinkURL().protocolIsInHTTPFamily())
+            preconnectTo(result.absoluteLinkURL(), PreconnectReason::LinkHover);
+    }
     m_client.mouseDidMoveOverElement(result, modifierFlags);
 
     InspectorInstrumentation::mouseDidMoveOverElement(m_page, result, modifierFlags);
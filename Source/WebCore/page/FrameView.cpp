@@ -63,6 +63,7 @@
 #include "OverflowEvent.h"
 #include "PageOverlayController.h"
 #include "ProgressTracker.h"
+#include "RenderArena.h"
 #include "RenderEmbeddedObject.h"
 #include "RenderFullScreen.h"
 #include "RenderIFrame.h"
@@ -117,6 +118,28 @@ using namespace HTMLNames;
 
 double FrameView::sCurrentPaintTimeStamp = 0.0;
 
+static LayoutStatistics layoutStatisticsData;
+static unsigned layoutDepth;
+
+class LayoutStatisticsScope {
+public:
+    LayoutStatisticsScope()
+        : m_startTime(layoutDepth++ ? 0 : monotonicallyIncreasingTime())
+    {
+    }
+
+    ~LayoutStatisticsScope()
+    {
+        if (--layoutDepth)
+            return;
+        ++layoutStatisticsData.layouts;
+        layoutStatisticsData.layoutTime += monotonicallyIncreasingTime() - m_startTime;
+    }
+
+private:
+    double m_startTime;
+};
+
 // The maximum number of updateEmbeddedObjects iterations that should be done before returning.
 static const unsigned maxUpdateEmbeddedObjectsIterations = 2;
 
@@ -1099,6 +1122,11 @@ inline void FrameView::forceLayoutParentViewIfNeeded()
     frameView->layout();
 }
 
+LayoutStatistics FrameView::layoutStatistics()
+{
+    return layoutStatisticsData;
+}
+
 void FrameView::layout(bool allowSubtree)
 {
     if (isInLayout())
@@ -1137,6 +1165,7 @@ void FrameView::layout(bool allowSubtree)
     if (isPainting())
         return;
 
+    LayoutStatisticsScope statisticsScope;
     InspectorInstrumentationCookie cookie = InspectorInstrumentation::willLayout(frame());
     AnimationUpdateBlock animationUpdateBlock(&frame().animation());
     
@@ -1151,6 +1180,9 @@ void FrameView::layout(bool allowSubtree)
     Document& document = *frame().document();
     ASSERT(!document.inPageCache());
 
+    // Line boxes and renderers created by layout come from the document's arena.
+    RenderArenaScope renderArenaScope(document.renderArena());
+
     bool subtree;
     RenderElement* root;
 
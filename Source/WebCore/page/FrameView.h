@@ -65,6 +65,12 @@ Pagination::Mode paginationModeForRenderStyle(const RenderStyle&);
 
 typedef unsigned long long DOMTimeStamp;
 
+// Layouts run from within another, like those of subframes, are part of it.
+struct LayoutStatistics {
+    uint64_t layouts;
+    double layoutTime; // Seconds.
+};
+
 class FrameView final : public ScrollView {
 public:
     friend class RenderView;
@@ -364,6 +370,7 @@ public:
     bool isInChildFrameWithFrameFlattening() const;
 
     static double currentPaintTimeStamp() { return sCurrentPaintTimeStamp; } // returns 0 if not painting
+    WEBCORE_EXPORT static LayoutStatistics layoutStatistics();
     
     WEBCORE_EXPORT void updateLayoutAndStyleIfNeededRecursive();
 
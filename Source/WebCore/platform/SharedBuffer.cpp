@@ -28,34 +28,60 @@
 #include "SharedBuffer.h"
 
 #include <algorithm>
+#include <atomic>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/Threading.h>
 #include <wtf/unicode/UTF8.h>
 
 namespace WebCore {
 
+static std::atomic<uint64_t> bytesCopied;
+static std::atomic<uint64_t> bytesShared;
+static std::atomic<uint64_t> bytesFlattened;
+
 #if !USE(NETWORK_CFDATA_ARRAY_CALLBACK)
 
 static const unsigned segmentSize = 0x1000;
-static const unsigned segmentPositionMask = 0x0FFF;
+// Smaller pieces of other buffers are copied, so that the many small reads
+// of a slow connection don't fragment the buffer.
+static const unsigned minimumSharedLength = segmentSize / 4;
+static const unsigned maxPooledSegments = 64;
 
-static inline unsigned segmentIndex(unsigned position)
+static Mutex& segmentPoolMutex()
 {
-    return position / segmentSize;
+    static NeverDestroyed<Mutex> mutex;
+    return mutex;
 }
 
-static inline unsigned offsetInSegment(unsigned position)
+static Vector<RefPtr<SharedBuffer::DataBuffer>>& segmentPool()
 {
-    return position & segmentPositionMask;
+    static NeverDestroyed<Vector<RefPtr<SharedBuffer::DataBuffer>>> pool;
+    return pool;
 }
 
-static inline char* allocateSegment() WARN_UNUSED_RETURN;
-static inline char* allocateSegment()
+static PassRefPtr<SharedBuffer::DataBuffer> allocateSegment()
 {
-    return static_cast<char*>(fastMalloc(segmentSize));
+    {
+        MutexLocker lock(segmentPoolMutex());
+        if (!segmentPool().isEmpty())
+            return segmentPool().takeLast();
+    }
+
+    RefPtr<SharedBuffer::DataBuffer> segment = adoptRef(new SharedBuffer::DataBuffer);
+    segment->data.reserveInitialCapacity(segmentSize);
+    return segment.release();
 }
 
-static inline void freeSegment(char* p)
+static void freeSegment(RefPtr<SharedBuffer::DataBuffer>& segment)
 {
-    fastFree(p);
+    // Segments still shared with another buffer stay with it.
+    if (segment->hasOneRef() && segment->data.capacity() == segmentSize) {
+        segment->data.shrink(0);
+        MutexLocker lock(segmentPoolMutex());
+        if (segmentPool().size() < maxPooledSegments)
+            segmentPool().append(segment.release());
+    }
+    segment = nullptr;
 }
 
 #endif
@@ -71,16 +97,31 @@ SharedBuffer::SharedBuffer(unsigned size)
 {
 }
 
+// Initial data is kept in one block, so data() needs no merging, and
+// appending this buffer to another shares the block whole.
 SharedBuffer::SharedBuffer(const char* data, unsigned size)
-    : m_buffer(adoptRef(new DataBuffer))
+    : m_size(size)
+    , m_buffer(adoptRef(new DataBuffer))
 {
-    append(data, size);
+    m_buffer->data.append(data, size);
+    bytesCopied += size;
 }
 
 SharedBuffer::SharedBuffer(const unsigned char* data, unsigned size)
-    : m_buffer(adoptRef(new DataBuffer))
+    : m_size(size)
+    , m_buffer(adoptRef(new DataBuffer))
 {
-    append(reinterpret_cast<const char*>(data), size);
+    m_buffer->data.append(reinterpret_cast<const char*>(data), size);
+    bytesCopied += size;
+}
+
+SharedBufferStatistics SharedBuffer::statistics()
+{
+    SharedBufferStatistics stats;
+    stats.bytesCopied = bytesCopied;
+    stats.bytesShared = bytesShared;
+    stats.bytesFlattened = bytesFlattened;
+    return stats;
 }
     
 SharedBuffer::~SharedBuffer()
@@ -145,6 +186,11 @@ void SharedBuffer::append(SharedBuffer* data)
 #if USE(NETWORK_CFDATA_ARRAY_CALLBACK)
     if (maybeAppendDataArray(data))
         return;
+#else
+    if (!data->hasPlatformData()) {
+        append(data, 0, data->size());
+        return;
+    }
 #endif
 
     const char* segment;
@@ -155,45 +201,96 @@ void SharedBuffer::append(SharedBuffer* data)
     }
 }
 
+void SharedBuffer::append(SharedBuffer* data, unsigned position, unsigned length)
+{
+    ASSERT(position + length <= data->size());
+    const unsigned end = position + length;
+
+#if !USE(NETWORK_CFDATA_ARRAY_CALLBACK)
+    if (!data->hasPlatformData()) {
+        maybeTransferPlatformData();
+
+        // Taken first, in case data is this buffer.
+        RefPtr<DataBuffer> flat = data->m_buffer;
+        const unsigned flatLength = flat->data.size();
+        const Vector<Segment> segments = data->m_segments;
+
+        if (position < flatLength)
+            appendSegment(*flat, position, std::min(end, flatLength) - position);
+        for (const Segment& segment : segments) {
+            const unsigned segmentBegin = flatLength + segment.begin;
+            const unsigned segmentEnd = segmentBegin + segment.length;
+            if (segmentBegin >= end)
+                break;
+            if (segmentEnd <= position)
+                continue;
+
+            const unsigned begin = std::max(position, segmentBegin);
+            appendSegment(*segment.buffer, segment.offset + begin - segmentBegin, std::min(end, segmentEnd) - begin);
+        }
+        return;
+    }
+#endif
+
+    const char* segment;
+    while (position < end) {
+        const unsigned available = std::min(data->getSomeData(segment, position), end - position);
+        append(segment, available);
+        position += available;
+    }
+}
+
+#if !USE(NETWORK_CFDATA_ARRAY_CALLBACK)
+
+void SharedBuffer::appendSegment(DataBuffer& buffer, unsigned offset, unsigned length)
+{
+    // Small resources stay in one block.
+    if (length < minimumSharedLength || (m_segments.isEmpty() && m_size + length <= segmentSize)) {
+        append(buffer.data.data() + offset, length);
+        return;
+    }
+
+    m_segments.append(Segment { &buffer, static_cast<unsigned>(m_size - m_buffer->data.size()), offset, length });
+    m_size += length;
+    bytesShared += length;
+}
+
+#endif
+
 void SharedBuffer::append(const char* data, unsigned length)
 {
     if (!length)
         return;
 
     maybeTransferPlatformData();
+    bytesCopied += length;
 
 #if !USE(NETWORK_CFDATA_ARRAY_CALLBACK)
-    unsigned positionInSegment = offsetInSegment(m_size - m_buffer->data.size());
-    m_size += length;
-
-    if (m_size <= segmentSize) {
+    if (m_segments.isEmpty() && m_size + length <= segmentSize) {
         // No need to use segments for small resource data
+        m_size += length;
         if (m_buffer->data.isEmpty())
             m_buffer->data.reserveInitialCapacity(length);
         appendToDataBuffer(data, length);
         return;
     }
 
-    char* segment;
-    if (!positionInSegment) {
-        segment = allocateSegment();
-        m_segments.append(segment);
-    } else
-        segment = m_segments.last() + positionInSegment;
-
-    unsigned segmentFreeSpace = segmentSize - positionInSegment;
-    unsigned bytesToCopy = std::min(length, segmentFreeSpace);
-
-    for (;;) {
-        memcpy(segment, data, bytesToCopy);
-        if (static_cast<unsigned>(length) == bytesToCopy)
-            break;
+    while (length) {
+        // The last segment is filled up, unless another buffer holds it too.
+        Segment* last = m_segments.isEmpty() ? nullptr : &m_segments.last();
+        if (!last || !last->buffer->hasOneRef() || last->offset + last->length != last->buffer->data.size()
+            || last->buffer->data.size() == last->buffer->data.capacity()) {
+            m_segments.append(Segment { allocateSegment(), static_cast<unsigned>(m_size - m_buffer->data.size()), 0, 0 });
+            last = &m_segments.last();
+        }
 
-        length -= bytesToCopy;
+        Vector<char>& segment = last->buffer->data;
+        const unsigned bytesToCopy = std::min<unsigned>(length, segment.capacity() - segment.size());
+        segment.append(data, bytesToCopy);
+        last->length += bytesToCopy;
+        m_size += bytesToCopy;
         data += bytesToCopy;
-        segment = allocateSegment();
-        m_segments.append(segment);
-        bytesToCopy = std::min(length, segmentSize);
+        length -= bytesToCopy;
     }
 #else
     m_size += length;
@@ -213,8 +310,8 @@ void SharedBuffer::clear()
     clearPlatformData();
     
 #if !USE(NETWORK_CFDATA_ARRAY_CALLBACK)
-    for (char* segment : m_segments)
-        freeSegment(segment);
+    for (Segment& segment : m_segments)
+        freeSegment(segment.buffer);
     m_segments.clear();
 #else
     m_dataArray.clear();
@@ -237,8 +334,9 @@ PassRefPtr<SharedBuffer> SharedBuffer::copy() const
     clone->m_buffer->data.append(m_buffer->data.data(), m_buffer->data.size());
 
 #if !USE(NETWORK_CFDATA_ARRAY_CALLBACK)
-    for (char* segment : m_segments)
-        clone->m_buffer->data.append(segment, segmentSize);
+    for (const Segment& segment : m_segments)
+        clone->m_buffer->data.append(segment.buffer->data.data() + segment.offset, segment.length);
+    bytesCopied += m_size;
 #else
     for (auto& data : m_dataArray)
         clone->m_dataArray.append(data.get());
@@ -279,12 +377,13 @@ void SharedBuffer::clearDataBuffer()
 
 void SharedBuffer::copyBufferAndClear(char* destination, unsigned bytesToCopy) const
 {
-    for (char* segment : m_segments) {
-        unsigned effectiveBytesToCopy = std::min(bytesToCopy, segmentSize);
-        memcpy(destination, segment, effectiveBytesToCopy);
+    bytesFlattened += bytesToCopy;
+    for (Segment& segment : m_segments) {
+        unsigned effectiveBytesToCopy = std::min(bytesToCopy, segment.length);
+        memcpy(destination, segment.buffer->data.data() + segment.offset, effectiveBytesToCopy);
         destination += effectiveBytesToCopy;
         bytesToCopy -= effectiveBytesToCopy;
-        freeSegment(segment);
+        freeSegment(segment.buffer);
     }
     m_segments.clear();
 }
@@ -325,16 +424,14 @@ unsigned SharedBuffer::getSomeData(const char*& someData, unsigned position) con
  
     position -= consecutiveSize;
 #if !USE(NETWORK_CFDATA_ARRAY_CALLBACK)
-    unsigned segments = m_segments.size();
-    unsigned maxSegmentedSize = segments * segmentSize;
-    unsigned segment = segmentIndex(position);
-    if (segment < segments) {
-        unsigned bytesLeft = totalSize - consecutiveSize;
-        unsigned segmentedSize = std::min(maxSegmentedSize, bytesLeft);
-
-        unsigned positionInSegment = offsetInSegment(position);
-        someData = m_segments[segment] + positionInSegment;
-        return segment == segments - 1 ? segmentedSize - position : segmentSize - positionInSegment;
+    auto segment = std::upper_bound(m_segments.begin(), m_segments.end(), position,
+        [](unsigned position, const Segment& segment) { return position < segment.begin; });
+    if (segment != m_segments.begin()) {
+        --segment;
+        unsigned positionInSegment = position - segment->begin;
+        ASSERT(positionInSegment < segment->length);
+        someData = segment->buffer->data.data() + segment->offset + positionInSegment;
+        return segment->length - positionInSegment;
     }
     ASSERT_NOT_REACHED();
     return 0;
@@ -47,6 +47,15 @@ OBJC_CLASS NSData;
 #endif
 
 namespace WebCore {
+
+// Bytes SharedBuffers took in since startup: copied in, taken over by
+// reference from another buffer, and copied again to merge segments for
+// data().
+struct SharedBufferStatistics {
+    uint64_t bytesCopied;
+    uint64_t bytesShared;
+    uint64_t bytesFlattened;
+};
     
 class SharedBuffer : public RefCounted<SharedBuffer> {
 public:
@@ -88,7 +97,11 @@ public:
 
     bool isEmpty() const { return !size(); }
 
+    // Shares the other buffer's memory rather than copying it, apart from
+    // small pieces.
     WEBCORE_EXPORT void append(SharedBuffer*);
+    // The same for |length| bytes of the other buffer from |position| on.
+    void append(SharedBuffer*, unsigned position, unsigned length);
     WEBCORE_EXPORT void append(const char*, unsigned);
     void append(const Vector<char>&);
 
@@ -124,6 +137,8 @@ public:
         Vector<char> data;
     };
 
+    WEBCORE_EXPORT static SharedBufferStatistics statistics();
+
 private:
     WEBCORE_EXPORT SharedBuffer();
     explicit SharedBuffer(unsigned);
@@ -155,7 +170,17 @@ private:
     const char *singleDataArrayBuffer() const;
     bool maybeAppendDataArray(SharedBuffer*);
 #else
-    mutable Vector<char*> m_segments;
+    // Segments are shared with the buffers they are appended to, and only
+    // written while this buffer holds the sole reference.
+    struct Segment {
+        RefPtr<DataBuffer> buffer;
+        unsigned begin;
+        // Where the bytes start in the buffer, for a part of another segment
+        unsigned offset;
+        unsigned length;
+    };
+    void appendSegment(DataBuffer&, unsigned offset, unsigned length);
+    mutable Vector<Segment> m_segments;
 #endif
 
 #if USE(CF)
@@ -185,6 +185,12 @@ public:
 
     bool allowSubsampling() const { return m_allowSubsampling; }
     void setAllowSubsampling(bool allowSubsampling) { m_allowSubsampling = allowSubsampling; }
+
+#if !USE(CG)
+    // Decodes into the frame buffer of |previous|, the last image of a stream
+    // of them, before it goes away.
+    void reuseFrameBufferOf(BitmapImage& previous) { m_source.reuseFrameBufferOf(previous.m_source); }
+#endif
     
 private:
     void updateSize(ImageOrientationDescription = ImageOrientationDescription()) const;
@@ -44,6 +44,7 @@ unsigned ImageSource::s_maxPixelsPerDecodedImage = 1024 * 1024;
 
 ImageSource::ImageSource(ImageSource::AlphaOption alphaOption, ImageSource::GammaAndColorProfileOption gammaAndColorProfileOption)
     : m_decoder(0)
+    , m_previousDecoder(0)
     , m_alphaOption(alphaOption)
     , m_gammaAndColorProfileOption(gammaAndColorProfileOption)
 {
@@ -64,6 +65,8 @@ void ImageSource::clear(bool destroyAll, size_t clearBeforeFrame, SharedBuffer*
 
     delete m_decoder;
     m_decoder = 0;
+    delete m_previousDecoder;
+    m_previousDecoder = 0;
     if (data)
         setData(data, allDataReceived);
 }
@@ -85,12 +88,27 @@ void ImageSource::setData(SharedBuffer* data, bool allDataReceived)
         if (m_decoder && s_maxPixelsPerDecodedImage)
             m_decoder->setMaxNumPixels(s_maxPixelsPerDecodedImage);
 #endif
+        if (m_decoder && m_previousDecoder) {
+            m_decoder->reuseFrameBufferOf(*m_previousDecoder);
+            delete m_previousDecoder;
+            m_previousDecoder = 0;
+        }
     }
 
     if (m_decoder)
         m_decoder->setData(data, allDataReceived);
 }
 
+void ImageSource::reuseFrameBufferOf(ImageSource& previous)
+{
+    if (m_decoder || !previous.m_decoder)
+        return;
+
+    delete m_previousDecoder;
+    m_previousDecoder = previous.m_decoder;
+    previous.m_decoder = 0;
+}
+
 String ImageSource::filenameExtension() const
 {
     return m_decoder ? m_decoder->filenameExtension() : String();
@@ -127,6 +127,12 @@ public:
     void setData(SharedBuffer* data, bool allDataReceived);
     String filenameExtension() const;
 
+#if !USE(CG)
+    // Takes over the decoder of |previous|, the source of the last image in
+    // a stream of them, for the decoder of this one to reuse its frame buffer.
+    void reuseFrameBufferOf(ImageSource& previous);
+#endif
+
     SubsamplingLevel subsamplingLevelForScale(float) const;
     bool allowSubsamplingOfFrameAtIndex(size_t) const;
 
@@ -166,6 +172,7 @@ private:
     NativeImageDecoderPtr m_decoder;
 
 #if !USE(CG)
+    NativeImageDecoderPtr m_previousDecoder;
     AlphaOption m_alphaOption;
     GammaAndColorProfileOption m_gammaAndColorProfileOption;
 #endif
@@ -29,6 +29,11 @@
 
 #include <runtime/Uint8ClampedArray.h>
 #include <wtf/MathExtras.h>
+#include <wtf/ParallelJobs.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace WebCore {
 
@@ -103,9 +108,8 @@ inline void luminance(float& red, float& green, float& blue, float& alpha)
 }
 
 template<ColorMatrixType filterType>
-void effectType(Uint8ClampedArray* pixelArray, const Vector<float>& values)
+void effectType(Uint8ClampedArray* pixelArray, const Vector<float>& values, unsigned startOffset, unsigned endOffset)
 {
-    unsigned pixelArrayLength = pixelArray->length();
     float components[9];
 
     if (filterType == FECOLORMATRIX_TYPE_SATURATE)
@@ -113,7 +117,7 @@ void effectType(Uint8ClampedArray* pixelArray, const Vector<float>& values)
     else if (filterType == FECOLORMATRIX_TYPE_HUEROTATE)
         FEColorMatrix::calculateHueRotateComponents(components, values[0]);
 
-    for (unsigned pixelByteOffset = 0; pixelByteOffset < pixelArrayLength; pixelByteOffset += 4) {
+    for (unsigned pixelByteOffset = startOffset; pixelByteOffset < endOffset; pixelByteOffset += 4) {
         float red = pixelArray->item(pixelByteOffset);
         float green = pixelArray->item(pixelByteOffset + 1);
         float blue = pixelArray->item(pixelByteOffset + 2);
@@ -139,36 +143,148 @@ void effectType(Uint8ClampedArray* pixelArray, const Vector<float>& values)
     }
 }
 
-void FEColorMatrix::platformApplySoftware()
+#ifdef __SSE2__
+// Computes each output pixel as the sum of the matrix columns scaled by the
+// input channels, in the same order as matrix() so the results are identical.
+static void matrixSSE2(unsigned char* data, unsigned startOffset, unsigned endOffset, const float* values)
 {
-    FilterEffect* in = inputEffect(0);
+    const __m128 column0 = _mm_setr_ps(values[0], values[5], values[10], values[15]);
+    const __m128 column1 = _mm_setr_ps(values[1], values[6], values[11], values[16]);
+    const __m128 column2 = _mm_setr_ps(values[2], values[7], values[12], values[17]);
+    const __m128 column3 = _mm_setr_ps(values[3], values[8], values[13], values[18]);
+    const __m128 offset = _mm_setr_ps(values[4] * 255, values[9] * 255, values[14] * 255, values[19] * 255);
+    const __m128 maxValue = _mm_set1_ps(255);
+    const __m128i zero = _mm_setzero_si128();
 
-    ImageBuffer* resultImage = createImageBufferResult();
-    if (!resultImage)
+    for (unsigned pixelByteOffset = startOffset; pixelByteOffset < endOffset; pixelByteOffset += 4) {
+        uint32_t pixel;
+        memcpy(&pixel, data + pixelByteOffset, 4);
+
+        __m128i channels = _mm_cvtsi32_si128(pixel);
+        channels = _mm_unpacklo_epi16(_mm_unpacklo_epi8(channels, zero), zero);
+        const __m128 rgba = _mm_cvtepi32_ps(channels);
+
+        __m128 result = _mm_mul_ps(column0, _mm_shuffle_ps(rgba, rgba, _MM_SHUFFLE(0, 0, 0, 0)));
+        result = _mm_add_ps(result, _mm_mul_ps(column1, _mm_shuffle_ps(rgba, rgba, _MM_SHUFFLE(1, 1, 1, 1))));
+        result = _mm_add_ps(result, _mm_mul_ps(column2, _mm_shuffle_ps(rgba, rgba, _MM_SHUFFLE(2, 2, 2, 2))));
+        result = _mm_add_ps(result, _mm_mul_ps(column3, _mm_shuffle_ps(rgba, rgba, _MM_SHUFFLE(3, 3, 3, 3))));
+        result = _mm_add_ps(result, offset);
+
+        // Clamp before converting, out of range floats do not saturate. NaN becomes 0.
+        result = _mm_min_ps(_mm_max_ps(result, _mm_setzero_ps()), maxValue);
+        __m128i packed = _mm_cvtps_epi32(result);
+        packed = _mm_packs_epi32(packed, packed);
+        packed = _mm_packus_epi16(packed, packed);
+
+        pixel = _mm_cvtsi128_si32(packed);
+        memcpy(data + pixelByteOffset, &pixel, 4);
+    }
+}
+
+static void matrixForType(ColorMatrixType type, const Vector<float>& values, float* result)
+{
+    if (type == FECOLORMATRIX_TYPE_MATRIX) {
+        for (unsigned i = 0; i < 20; ++i)
+            result[i] = values[i];
         return;
+    }
 
-    resultImage->context()->drawImageBuffer(in->asImageBuffer(), ColorSpaceDeviceRGB, drawingRegionOfInputImage(in->absolutePaintRect()));
+    float components[9];
+    if (type == FECOLORMATRIX_TYPE_SATURATE)
+        FEColorMatrix::calculateSaturateComponents(components, values[0]);
+    else
+        FEColorMatrix::calculateHueRotateComponents(components, values[0]);
 
-    IntRect imageRect(IntPoint(), resultImage->logicalSize());
-    RefPtr<Uint8ClampedArray> pixelArray = resultImage->getUnmultipliedImageData(imageRect);
+    // The color rows get the 3x3 components, alpha passes through.
+    for (unsigned i = 0; i < 20; ++i)
+        result[i] = 0;
+    for (unsigned row = 0; row < 3; ++row) {
+        for (unsigned column = 0; column < 3; ++column)
+            result[row * 5 + column] = components[row * 3 + column];
+    }
+    result[18] = 1;
+}
+#endif
+
+void FEColorMatrix::platformApplyGeneric(Uint8ClampedArray* pixelArray, int width, int startY, int endY)
+{
+    unsigned startOffset = startY * width * 4;
+    unsigned endOffset = endY * width * 4;
 
     switch (m_type) {
     case FECOLORMATRIX_TYPE_UNKNOWN:
         break;
     case FECOLORMATRIX_TYPE_MATRIX:
-        effectType<FECOLORMATRIX_TYPE_MATRIX>(pixelArray.get(), m_values);
-        break;
-    case FECOLORMATRIX_TYPE_SATURATE: 
-        effectType<FECOLORMATRIX_TYPE_SATURATE>(pixelArray.get(), m_values);
-        break;
+    case FECOLORMATRIX_TYPE_SATURATE:
     case FECOLORMATRIX_TYPE_HUEROTATE:
-        effectType<FECOLORMATRIX_TYPE_HUEROTATE>(pixelArray.get(), m_values);
+#ifdef __SSE2__
+        {
+            float values[20];
+            matrixForType(m_type, m_values, values);
+            matrixSSE2(pixelArray->data(), startOffset, endOffset, values);
+        }
+#else
+        if (m_type == FECOLORMATRIX_TYPE_MATRIX)
+            effectType<FECOLORMATRIX_TYPE_MATRIX>(pixelArray, m_values, startOffset, endOffset);
+        else if (m_type == FECOLORMATRIX_TYPE_SATURATE)
+            effectType<FECOLORMATRIX_TYPE_SATURATE>(pixelArray, m_values, startOffset, endOffset);
+        else
+            effectType<FECOLORMATRIX_TYPE_HUEROTATE>(pixelArray, m_values, startOffset, endOffset);
+#endif
         break;
     case FECOLORMATRIX_TYPE_LUMINANCETOALPHA:
-        effectType<FECOLORMATRIX_TYPE_LUMINANCETOALPHA>(pixelArray.get(), m_values);
-        setIsAlphaImage(true);
+        effectType<FECOLORMATRIX_TYPE_LUMINANCETOALPHA>(pixelArray, m_values, startOffset, endOffset);
         break;
     }
+}
+
+void FEColorMatrix::platformApplyWorker(PlatformApplyParameters* param)
+{
+    param->filter->platformApplyGeneric(param->pixelArray, param->width, param->startY, param->endY);
+}
+
+void FEColorMatrix::platformApplySoftware()
+{
+    FilterEffect* in = inputEffect(0);
+
+    ImageBuffer* resultImage = createImageBufferResult();
+    if (!resultImage)
+        return;
+
+    resultImage->context()->drawImageBuffer(in->asImageBuffer(), ColorSpaceDeviceRGB, drawingRegionOfInputImage(in->absolutePaintRect()));
+
+    IntRect imageRect(IntPoint(), resultImage->logicalSize());
+    RefPtr<Uint8ClampedArray> pixelArray = resultImage->getUnmultipliedImageData(imageRect);
+
+    if (m_type == FECOLORMATRIX_TYPE_LUMINANCETOALPHA)
+        setIsAlphaImage(true);
+
+    const int width = imageRect.width();
+    const int height = imageRect.height();
+    int optimalThreadNumber = (width * height) / s_minimalArea;
+    if (optimalThreadNumber > 1) {
+        ParallelJobs<PlatformApplyParameters> parallelJobs(&WebCore::FEColorMatrix::platformApplyWorker, optimalThreadNumber);
+        int numOfThreads = parallelJobs.numberOfJobs();
+        if (numOfThreads > 1) {
+            // Split the job into "jobSize"-sized jobs but there a few jobs that need to be slightly larger since
+            // jobSize * jobs < total size. These extras are handled by the remainder "jobsWithExtra".
+            const int jobSize = height / numOfThreads;
+            const int jobsWithExtra = height % numOfThreads;
+            int currentY = 0;
+            for (int job = numOfThreads - 1; job >= 0; --job) {
+                PlatformApplyParameters& param = parallelJobs.parameter(job);
+                param.filter = this;
+                param.pixelArray = pixelArray.get();
+                param.width = width;
+                param.startY = currentY;
+                currentY += job < jobsWithExtra ? jobSize + 1 : jobSize;
+                param.endY = currentY;
+            }
+            parallelJobs.execute();
+        } else
+            platformApplyGeneric(pixelArray.get(), width, 0, height);
+    } else
+        platformApplyGeneric(pixelArray.get(), width, 0, height);
 
     resultImage->putByteArray(Unmultiplied, pixelArray.get(), imageRect.size(), imageRect, IntPoint());
 }
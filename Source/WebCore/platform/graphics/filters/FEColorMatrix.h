@@ -58,9 +58,23 @@ public:
     static inline void calculateSaturateComponents(float* components, float value);
     static inline void calculateHueRotateComponents(float* components, float value);
 
+    static const int s_minimalArea = (300 * 300); // Empirical data limit for parallel jobs
+
+    struct PlatformApplyParameters {
+        FEColorMatrix* filter;
+        Uint8ClampedArray* pixelArray;
+        int width;
+        int startY;
+        int endY;
+    };
+
+    static void platformApplyWorker(PlatformApplyParameters*);
+
 private:
     FEColorMatrix(Filter&, ColorMatrixType, const Vector<float>&);
 
+    void platformApplyGeneric(Uint8ClampedArray*, int width, int startY, int endY);
+
     ColorMatrixType m_type;
     Vector<float> m_values;
 };
@@ -30,6 +30,7 @@
 
 #include <runtime/Uint8ClampedArray.h>
 #include <wtf/MathExtras.h>
+#include <wtf/ParallelJobs.h>
 #include <wtf/StdLibExtras.h>
 
 namespace WebCore {
@@ -147,6 +148,21 @@ static void gamma(unsigned char* values, const ComponentTransferFunction& transf
     }
 }
 
+void FEComponentTransfer::platformApplyWorker(PlatformApplyParameters* param)
+{
+    unsigned char* data = param->data;
+    const unsigned char* redTable = param->tables[0];
+    const unsigned char* greenTable = param->tables[1];
+    const unsigned char* blueTable = param->tables[2];
+    const unsigned char* alphaTable = param->tables[3];
+    for (unsigned pixelOffset = 0; pixelOffset < param->length; pixelOffset += 4) {
+        data[pixelOffset] = redTable[data[pixelOffset]];
+        data[pixelOffset + 1] = greenTable[data[pixelOffset + 1]];
+        data[pixelOffset + 2] = blueTable[data[pixelOffset + 2]];
+        data[pixelOffset + 3] = alphaTable[data[pixelOffset + 3]];
+    }
+}
+
 void FEComponentTransfer::platformApplySoftware()
 {
     FilterEffect* in = inputEffect(0);
@@ -162,14 +178,34 @@ void FEComponentTransfer::platformApplySoftware()
     IntRect drawingRect = requestedRegionOfInputImageData(in->absolutePaintRect());
     in->copyUnmultipliedImage(pixelArray, drawingRect);
 
-    unsigned pixelArrayLength = pixelArray->length();
-    unsigned char* data = pixelArray->data();
-    for (unsigned pixelOffset = 0; pixelOffset < pixelArrayLength; pixelOffset += 4) {
-        for (unsigned channel = 0; channel < 4; ++channel) {
-            unsigned char c = data[pixelOffset + channel];
-            data[pixelOffset + channel] = tables[channel][c];
+    // The lookups have no SIMD gather below AVX2, so large images are only split across threads.
+    unsigned pixelCount = pixelArray->length() / 4;
+    int optimalThreadNumber = pixelCount / s_minimalArea;
+    if (optimalThreadNumber > 1) {
+        ParallelJobs<PlatformApplyParameters> parallelJobs(&WebCore::FEComponentTransfer::platformApplyWorker, optimalThreadNumber);
+        unsigned numOfThreads = parallelJobs.numberOfJobs();
+        if (numOfThreads > 1) {
+            const unsigned jobSize = pixelCount / numOfThreads;
+            const unsigned jobsWithExtra = pixelCount % numOfThreads;
+            unsigned currentPixel = 0;
+            for (int job = numOfThreads - 1; job >= 0; --job) {
+                PlatformApplyParameters& param = parallelJobs.parameter(job);
+                unsigned size = static_cast<unsigned>(job) < jobsWithExtra ? jobSize + 1 : jobSize;
+                param.data = pixelArray->data() + currentPixel * 4;
+                param.length = size * 4;
+                param.tables = tables;
+                currentPixel += size;
+            }
+            parallelJobs.execute();
+            return;
         }
     }
+
+    PlatformApplyParameters param;
+    param.data = pixelArray->data();
+    param.length = pixelArray->length();
+    param.tables = tables;
+    platformApplyWorker(&param);
 }
 
 void FEComponentTransfer::getValues(unsigned char rValues[256], unsigned char gValues[256], unsigned char bValues[256], unsigned char aValues[256])
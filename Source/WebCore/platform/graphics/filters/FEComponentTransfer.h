@@ -82,6 +82,16 @@ public:
 
     virtual TextStream& externalRepresentation(TextStream&, int indention) const;
 
+    static const int s_minimalArea = (300 * 300); // Empirical data limit for parallel jobs
+
+    struct PlatformApplyParameters {
+        unsigned char* data;
+        unsigned length;
+        const unsigned char* const* tables;
+    };
+
+    static void platformApplyWorker(PlatformApplyParameters*);
+
 private:
     FEComponentTransfer(Filter&, const ComponentTransferFunction& redFunc, const ComponentTransferFunction& greenFunc,
                         const ComponentTransferFunction& blueFunc, const ComponentTransferFunction& alphaFunc);
@@ -30,6 +30,11 @@
 #include "TextStream.h"
 
 #include <runtime/Uint8ClampedArray.h>
+#include <wtf/ParallelJobs.h>
+
+#if !HAVE(ARM_NEON_INTRINSICS) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace WebCore {
 
@@ -180,6 +185,67 @@ static inline void computeArithmeticPixelsUnclamped(unsigned char* source, unsig
 }
 
 #if !HAVE(ARM_NEON_INTRINSICS)
+#ifdef __SSE2__
+// Processes 16 bytes per iteration with the same operation order as computeArithmeticPixels.
+// Clamping with min/max before the truncating conversion gives the same bytes as the scalar
+// branches, so this serves both the clamped and the unclamped case.
+template <int b1, int b4>
+static inline void computeArithmeticPixelsSSE2(unsigned char* source, unsigned char* destination, int pixelArrayLength,
+                                    float k1, float k2, float k3, float k4)
+{
+    const __m128 k2Vector = _mm_set1_ps(k2);
+    const __m128 k3Vector = _mm_set1_ps(k3);
+    const __m128 scaledK1 = _mm_set1_ps(k1 / 255.0f);
+    const __m128 scaledK4 = _mm_set1_ps(k4 * 255.0f);
+    const __m128 minValue = _mm_setzero_ps();
+    const __m128 maxValue = _mm_set1_ps(255.0f);
+    const __m128i zero = _mm_setzero_si128();
+
+    int vectorLength = pixelArrayLength & ~15;
+    for (int offset = 0; offset < vectorLength; offset += 16) {
+        __m128i sourceBytes = _mm_loadu_si128(reinterpret_cast<__m128i*>(source + offset));
+        __m128i destinationBytes = _mm_loadu_si128(reinterpret_cast<__m128i*>(destination + offset));
+        __m128i sourceWords[2] = { _mm_unpacklo_epi8(sourceBytes, zero), _mm_unpackhi_epi8(sourceBytes, zero) };
+        __m128i destinationWords[2] = { _mm_unpacklo_epi8(destinationBytes, zero), _mm_unpackhi_epi8(destinationBytes, zero) };
+        __m128i resultWords[2];
+
+        for (int half = 0; half < 2; ++half) {
+            __m128i resultDwords[2];
+            for (int quarter = 0; quarter < 2; ++quarter) {
+                __m128 i1 = _mm_cvtepi32_ps(quarter ? _mm_unpackhi_epi16(sourceWords[half], zero) : _mm_unpacklo_epi16(sourceWords[half], zero));
+                __m128 i2 = _mm_cvtepi32_ps(quarter ? _mm_unpackhi_epi16(destinationWords[half], zero) : _mm_unpacklo_epi16(destinationWords[half], zero));
+                __m128 result = _mm_add_ps(_mm_mul_ps(k2Vector, i1), _mm_mul_ps(k3Vector, i2));
+                if (b1)
+                    result = _mm_add_ps(result, _mm_mul_ps(_mm_mul_ps(scaledK1, i1), i2));
+                if (b4)
+                    result = _mm_add_ps(result, scaledK4);
+                result = _mm_min_ps(_mm_max_ps(result, minValue), maxValue);
+                resultDwords[quarter] = _mm_cvttps_epi32(result);
+            }
+            resultWords[half] = _mm_packs_epi32(resultDwords[0], resultDwords[1]);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + offset), _mm_packus_epi16(resultWords[0], resultWords[1]));
+    }
+
+    if (vectorLength < pixelArrayLength)
+        computeArithmeticPixels<b1, b4>(source + vectorLength, destination + vectorLength, pixelArrayLength - vectorLength, k1, k2, k3, k4);
+}
+
+static inline void arithmeticSoftware(unsigned char* source, unsigned char* destination, int pixelArrayLength, float k1, float k2, float k3, float k4)
+{
+    if (k4) {
+        if (k1)
+            computeArithmeticPixelsSSE2<1, 1>(source, destination, pixelArrayLength, k1, k2, k3, k4);
+        else
+            computeArithmeticPixelsSSE2<0, 1>(source, destination, pixelArrayLength, k1, k2, k3, k4);
+    } else {
+        if (k1)
+            computeArithmeticPixelsSSE2<1, 0>(source, destination, pixelArrayLength, k1, k2, k3, k4);
+        else
+            computeArithmeticPixelsSSE2<0, 0>(source, destination, pixelArrayLength, k1, k2, k3, k4);
+    }
+}
+#else
 static inline void arithmeticSoftware(unsigned char* source, unsigned char* destination, int pixelArrayLength, float k1, float k2, float k3, float k4)
 {
     float upperLimit = std::max(0.0f, k1) + std::max(0.0f, k2) + std::max(0.0f, k3) + k4;
@@ -211,22 +277,66 @@ static inline void arithmeticSoftware(unsigned char* source, unsigned char* dest
             computeArithmeticPixels<0, 0>(source, destination, pixelArrayLength, k1, k2, k3, k4);
     }
 }
+#endif // __SSE2__
 #endif
 
-inline void FEComposite::platformArithmeticSoftware(Uint8ClampedArray* source, Uint8ClampedArray* destination,
-    float k1, float k2, float k3, float k4)
+void FEComposite::platformArithmeticWorker(PlatformApplyParameters* param)
 {
-    int length = source->length();
-    ASSERT(length == static_cast<int>(destination->length()));
     // The selection here eventually should happen dynamically.
 #if HAVE(ARM_NEON_INTRINSICS)
-    ASSERT(!(length & 0x3));
-    platformArithmeticNeon(source->data(), destination->data(), length, k1, k2, k3, k4);
+    ASSERT(!(param->length & 0x3));
+    platformArithmeticNeon(param->source, param->destination, param->length, param->k1, param->k2, param->k3, param->k4);
 #else
-    arithmeticSoftware(source->data(), destination->data(), length, k1, k2, k3, k4);
+    arithmeticSoftware(param->source, param->destination, param->length, param->k1, param->k2, param->k3, param->k4);
 #endif
 }
 
+inline void FEComposite::platformArithmeticSoftware(Uint8ClampedArray* source, Uint8ClampedArray* destination,
+    float k1, float k2, float k3, float k4)
+{
+    int length = source->length();
+    ASSERT(length == static_cast<int>(destination->length()));
+
+    int optimalThreadNumber = (length / 4) / s_minimalArea;
+    if (optimalThreadNumber > 1) {
+        ParallelJobs<PlatformApplyParameters> parallelJobs(&WebCore::FEComposite::platformArithmeticWorker, optimalThreadNumber);
+        int numOfThreads = parallelJobs.numberOfJobs();
+        if (numOfThreads > 1) {
+            // Jobs get whole 16 byte blocks so every vector loop but the last one runs without a tail.
+            const int blocks = length / 16;
+            const int jobSize = blocks / numOfThreads;
+            const int jobsWithExtra = blocks % numOfThreads;
+            int currentOffset = 0;
+            for (int job = numOfThreads - 1; job >= 0; --job) {
+                PlatformApplyParameters& param = parallelJobs.parameter(job);
+                param.source = source->data() + currentOffset;
+                param.destination = destination->data() + currentOffset;
+                int size = (job < jobsWithExtra ? jobSize + 1 : jobSize) * 16;
+                if (!job)
+                    size = length - currentOffset;
+                param.length = size;
+                param.k1 = k1;
+                param.k2 = k2;
+                param.k3 = k3;
+                param.k4 = k4;
+                currentOffset += size;
+            }
+            parallelJobs.execute();
+            return;
+        }
+    }
+
+    PlatformApplyParameters param;
+    param.source = source->data();
+    param.destination = destination->data();
+    param.length = length;
+    param.k1 = k1;
+    param.k2 = k2;
+    param.k3 = k3;
+    param.k4 = k4;
+    platformArithmeticWorker(&param);
+}
+
 void FEComposite::determineAbsolutePaintRect()
 {
     switch (m_type) {
@@ -67,6 +67,20 @@ public:
 
     virtual TextStream& externalRepresentation(TextStream&, int indention) const;
 
+    static const int s_minimalArea = (300 * 300); // Empirical data limit for parallel jobs
+
+    struct PlatformApplyParameters {
+        unsigned char* source;
+        unsigned char* destination;
+        int length;
+        float k1;
+        float k2;
+        float k3;
+        float k4;
+    };
+
+    static void platformArithmeticWorker(PlatformApplyParameters*);
+
 protected:
     virtual bool requiresValidPreMultipliedPixels() override { return m_type != FECOMPOSITE_OPERATOR_ARITHMETIC; }
 
@@ -29,6 +29,7 @@
 #include "TextStream.h"
 
 #include <runtime/Uint8ClampedArray.h>
+#include <wtf/ParallelJobs.h>
 
 namespace WebCore {
 
@@ -101,6 +102,30 @@ void FEDisplacementMap::transformResultColorSpace(FilterEffect* in, const int in
         in->transformResultColorSpace(operatingColorSpace());
 }
 
+void FEDisplacementMap::platformApplyGeneric(const PaintingData& paintingData, int startY, int endY)
+{
+    const int width = paintingData.width;
+    const int height = paintingData.height;
+    const int stride = width * 4;
+    for (int y = startY; y < endY; ++y) {
+        int line = y * stride;
+        for (int x = 0; x < width; ++x) {
+            int dstIndex = line + x * 4;
+            int srcX = x + static_cast<int>(paintingData.scaleForColorX * paintingData.srcPixelArrayB[dstIndex + paintingData.xChannelIndex] + paintingData.scaledOffsetX);
+            int srcY = y + static_cast<int>(paintingData.scaleForColorY * paintingData.srcPixelArrayB[dstIndex + paintingData.yChannelIndex] + paintingData.scaledOffsetY);
+            if (srcX < 0 || srcX >= width || srcY < 0 || srcY >= height)
+                memset(paintingData.dstPixelArray + dstIndex, 0, 4);
+            else
+                memcpy(paintingData.dstPixelArray + dstIndex, paintingData.srcPixelArrayA + srcY * stride + srcX * 4, 4);
+        }
+    }
+}
+
+void FEDisplacementMap::platformApplyWorker(PlatformApplyParameters* param)
+{
+    platformApplyGeneric(*param->paintingData, param->startY, param->endY);
+}
+
 void FEDisplacementMap::platformApplySoftware()
 {
     FilterEffect* in = inputEffect(0);
@@ -125,27 +150,42 @@ void FEDisplacementMap::platformApplySoftware()
     IntSize paintSize = absolutePaintRect().size();
     float scaleX = filter.applyHorizontalScale(m_scale);
     float scaleY = filter.applyVerticalScale(m_scale);
-    float scaleForColorX = scaleX / 255.0;
-    float scaleForColorY = scaleY / 255.0;
-    float scaledOffsetX = 0.5 - scaleX * 0.5;
-    float scaledOffsetY = 0.5 - scaleY * 0.5;
-    int stride = paintSize.width() * 4;
-    for (int y = 0; y < paintSize.height(); ++y) {
-        int line = y * stride;
-        for (int x = 0; x < paintSize.width(); ++x) {
-            int dstIndex = line + x * 4;
-            int srcX = x + static_cast<int>(scaleForColorX * srcPixelArrayB->item(dstIndex + m_xChannelSelector - 1) + scaledOffsetX);
-            int srcY = y + static_cast<int>(scaleForColorY * srcPixelArrayB->item(dstIndex + m_yChannelSelector - 1) + scaledOffsetY);
-            for (unsigned channel = 0; channel < 4; ++channel) {
-                if (srcX < 0 || srcX >= paintSize.width() || srcY < 0 || srcY >= paintSize.height())
-                    dstPixelArray->set(dstIndex + channel, static_cast<unsigned char>(0));
-                else {
-                    unsigned char pixelValue = srcPixelArrayA->item(srcY * stride + srcX * 4 + channel);
-                    dstPixelArray->set(dstIndex + channel, pixelValue);
-                }
+
+    PaintingData paintingData;
+    paintingData.srcPixelArrayA = srcPixelArrayA->data();
+    paintingData.srcPixelArrayB = srcPixelArrayB->data();
+    paintingData.dstPixelArray = dstPixelArray->data();
+    paintingData.width = paintSize.width();
+    paintingData.height = paintSize.height();
+    paintingData.xChannelIndex = m_xChannelSelector - 1;
+    paintingData.yChannelIndex = m_yChannelSelector - 1;
+    paintingData.scaleForColorX = scaleX / 255.0;
+    paintingData.scaleForColorY = scaleY / 255.0;
+    paintingData.scaledOffsetX = 0.5 - scaleX * 0.5;
+    paintingData.scaledOffsetY = 0.5 - scaleY * 0.5;
+
+    // Each output row only reads the inputs, so rows can be split freely between threads.
+    int optimalThreadNumber = (paintingData.width * paintingData.height) / s_minimalArea;
+    if (optimalThreadNumber > 1) {
+        ParallelJobs<PlatformApplyParameters> parallelJobs(&WebCore::FEDisplacementMap::platformApplyWorker, optimalThreadNumber);
+        int numOfThreads = parallelJobs.numberOfJobs();
+        if (numOfThreads > 1) {
+            const int jobSize = paintingData.height / numOfThreads;
+            const int jobsWithExtra = paintingData.height % numOfThreads;
+            int currentY = 0;
+            for (int job = numOfThreads - 1; job >= 0; --job) {
+                PlatformApplyParameters& param = parallelJobs.parameter(job);
+                param.paintingData = &paintingData;
+                param.startY = currentY;
+                currentY += job < jobsWithExtra ? jobSize + 1 : jobSize;
+                param.endY = currentY;
             }
+            parallelJobs.execute();
+            return;
         }
     }
+
+    platformApplyGeneric(paintingData, 0, paintingData.height);
 }
 
 void FEDisplacementMap::dump()
@@ -59,9 +59,35 @@ public:
 
     virtual TextStream& externalRepresentation(TextStream&, int indention) const;
 
+    static const int s_minimalArea = (300 * 300); // Empirical data limit for parallel jobs
+
+    struct PaintingData {
+        const unsigned char* srcPixelArrayA;
+        const unsigned char* srcPixelArrayB;
+        unsigned char* dstPixelArray;
+        int width;
+        int height;
+        int xChannelIndex;
+        int yChannelIndex;
+        float scaleForColorX;
+        float scaleForColorY;
+        float scaledOffsetX;
+        float scaledOffsetY;
+    };
+
+    struct PlatformApplyParameters {
+        const PaintingData* paintingData;
+        int startY;
+        int endY;
+    };
+
+    static void platformApplyWorker(PlatformApplyParameters*);
+
 private:
     FEDisplacementMap(Filter&, ChannelSelectorType xChannelSelector, ChannelSelectorType yChannelSelector, float);
 
+    static void platformApplyGeneric(const PaintingData&, int startY, int endY);
+
     ChannelSelectorType m_xChannelSelector;
     ChannelSelectorType m_yChannelSelector;
     float m_scale;
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2015 Lauri Kasanen
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BitmapTextureImageBuffer_h
+#define BitmapTextureImageBuffer_h
+
+#include "BitmapTexture.h"
+#include "ImageBuffer.h"
+
+#if USE(TEXTURE_MAPPER)
+
+namespace WebCore {
+
+class GraphicsContext;
+
+// A texture in main memory, an image surface on cairo. Resetting one to the
+// size it already has clears it instead of allocating, so the texture pool
+// can hand the same surfaces out frame after frame.
+class BitmapTextureImageBuffer : public BitmapTexture {
+public:
+    static PassRefPtr<BitmapTexture> create() { return adoptRef(new BitmapTextureImageBuffer); }
+
+    virtual IntSize size() const override { return m_image ? m_image->internalSize() : IntSize(); }
+    virtual void didReset() override;
+    virtual bool isValid() const override { return !!m_image; }
+    virtual bool canReuseWith(const IntSize& contentsSize, Flags = 0) override { return m_image && m_image->internalSize() == contentsSize; }
+
+    GraphicsContext* graphicsContext() const { return m_image ? m_image->context() : nullptr; }
+    ImageBuffer* image() const { return m_image.get(); }
+
+    virtual void updateContents(Image*, const IntRect&, const IntPoint& offset, UpdateContentsFlag) override;
+    virtual void updateContents(TextureMapper*, GraphicsLayer*, const IntRect& target, const IntPoint& offset, UpdateContentsFlag) override;
+    virtual void updateContents(const void*, const IntRect& target, const IntPoint& sourceOffset, int bytesPerLine, UpdateContentsFlag) override;
+
+private:
+    BitmapTextureImageBuffer() { }
+
+    std::unique_ptr<ImageBuffer> m_image;
+};
+
+} // namespace WebCore
+
+#endif // USE(TEXTURE_MAPPER)
+
+#endif // BitmapTextureImageBuffer_h
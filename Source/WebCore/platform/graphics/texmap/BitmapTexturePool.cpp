@@ -27,11 +27,11 @@
 #include "config.h"
 #include "BitmapTexturePool.h"
 
+#include "BitmapTextureImageBuffer.h"
+
 #if USE(TEXTURE_MAPPER_GL)
 #include "BitmapTextureGL.h"
 #include "GLContext.h"
-#else
-#include "BitmapTextureImageBuffer.h"
 #endif
 
 namespace WebCore {
@@ -104,9 +104,12 @@ PassRefPtr<BitmapTexture> BitmapTexturePool::acquireTexture(const IntSize& size)
 PassRefPtr<BitmapTexture> BitmapTexturePool::createTexture()
 {
 #if USE(TEXTURE_MAPPER_GL)
-    BitmapTextureGL* texture = new BitmapTextureGL(m_context3D);
-    return adoptRef(texture);
+    if (m_context3D) {
+        BitmapTextureGL* texture = new BitmapTextureGL(m_context3D);
+        return adoptRef(texture);
+    }
 #endif
+    return BitmapTextureImageBuffer::create();
 }
 
 } // namespace WebCore
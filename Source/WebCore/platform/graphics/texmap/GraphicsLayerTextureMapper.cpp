@@ -602,7 +602,8 @@ void GraphicsLayerTextureMapper::removeAnimation(const String& animationName)
 bool GraphicsLayerTextureMapper::setFilters(const FilterOperations& filters)
 {
     TextureMapper* textureMapper = m_layer.textureMapper();
-    if (!textureMapper)
+    // Software layers leave filters to be painted into their contents
+    if (!textureMapper || textureMapper->accelerationMode() == TextureMapper::SoftwareMode)
         return false;
     notifyChange(FilterChange);
     return GraphicsLayer::setFilters(filters);
@@ -23,6 +23,7 @@
 #include "BitmapTexturePool.h"
 #include "FilterOperations.h"
 #include "GraphicsLayer.h"
+#include "TextureMapperImageBuffer.h"
 #include "Timer.h"
 #include <wtf/CurrentTime.h>
 
@@ -39,7 +40,9 @@ PassRefPtr<BitmapTexture> TextureMapper::acquireTextureFromPool(const IntSize& s
 
 std::unique_ptr<TextureMapper> TextureMapper::create()
 {
-    return platformCreateAccelerated();
+    if (std::unique_ptr<TextureMapper> textureMapper = platformCreateAccelerated())
+        return textureMapper;
+    return std::make_unique<TextureMapperImageBuffer>();
 }
 
 TextureMapper::TextureMapper()
@@ -56,13 +56,21 @@ public:
         RepeatWrap
     };
 
+    enum AccelerationMode {
+        SoftwareMode,
+        OpenGLMode
+    };
+
     typedef unsigned PaintFlags;
 
+    // An accelerated TextureMapper where the platform has one, else software.
     static std::unique_ptr<TextureMapper> create();
 
     explicit TextureMapper();
     virtual ~TextureMapper();
 
+    virtual AccelerationMode accelerationMode() const = 0;
+
     enum ExposedEdges {
         NoEdges = 0,
         LeftEdge = 1 << 0,
@@ -112,6 +112,7 @@ public:
     virtual void endClip() override;
     virtual IntRect clipBounds() override;
     virtual IntSize maxTextureSize() const override { return IntSize(2000, 2000); }
+    virtual AccelerationMode accelerationMode() const override { return OpenGLMode; }
     virtual PassRefPtr<BitmapTexture> createTexture() override;
     inline GraphicsContext3D* graphicsContext3D() const { return m_context3D.get(); }
 
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2015 Lauri Kasanen
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TextureMapperImageBuffer_h
+#define TextureMapperImageBuffer_h
+
+#include "BitmapTextureImageBuffer.h"
+#include "TextureMapper.h"
+
+#if USE(TEXTURE_MAPPER)
+
+namespace WebCore {
+
+// A software TextureMapper. Layers are cached in image buffers and drawn with
+// the platform's 2D graphics, so on cairo compositing is done by pixman.
+// Only affine transforms are drawn, and filters are not supported.
+class TextureMapperImageBuffer : public TextureMapper {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    TextureMapperImageBuffer();
+
+    virtual AccelerationMode accelerationMode() const override { return SoftwareMode; }
+
+    virtual void drawBorder(const Color&, float borderWidth, const FloatRect&, const TransformationMatrix&) override;
+    virtual void drawNumber(int number, const Color&, const FloatPoint&, const TransformationMatrix&) override;
+
+    virtual void drawTexture(const BitmapTexture&, const FloatRect& target, const TransformationMatrix&, float opacity, unsigned exposedEdges) override;
+    virtual void drawSolidColor(const FloatRect&, const TransformationMatrix&, const Color&) override;
+
+    virtual void bindSurface(BitmapTexture* surface) override { m_currentSurface = surface; }
+    virtual void beginClip(const TransformationMatrix&, const FloatRect&) override;
+    virtual void endClip() override;
+    virtual IntRect clipBounds() override;
+    virtual PassRefPtr<BitmapTexture> createTexture() override { return BitmapTextureImageBuffer::create(); }
+
+    virtual IntSize maxTextureSize() const override;
+
+private:
+    GraphicsContext* currentContext()
+    {
+        return m_currentSurface ? static_cast<BitmapTextureImageBuffer*>(m_currentSurface.get())->graphicsContext() : graphicsContext();
+    }
+
+    RefPtr<BitmapTexture> m_currentSurface;
+};
+
+} // namespace WebCore
+
+#endif // USE(TEXTURE_MAPPER)
+
+#endif // TextureMapperImageBuffer_h
@@ -646,6 +646,26 @@ bool TextureMapperLayer::descendantsOrSelfHaveRunningAnimations() const
         });
 }
 
+FloatRect TextureMapperLayer::runningAnimationsBoundingRect()
+{
+    computeTransformsRecursive();
+
+    FloatRect rect;
+    uniteRunningAnimationRects(rect, false);
+    return rect;
+}
+
+void TextureMapperLayer::uniteRunningAnimationRects(FloatRect& rect, bool inAnimatingSubtree) const
+{
+    // Descendants move along with an animating layer.
+    inAnimatingSubtree |= m_animations.hasRunningAnimations();
+    if (inAnimatingSubtree)
+        rect.unite(m_currentTransform.combined().mapRect(layerRect()));
+
+    for (auto* child : m_children)
+        child->uniteRunningAnimationRects(rect, inAnimatingSubtree);
+}
+
 void TextureMapperLayer::applyAnimationsRecursively()
 {
     syncAnimations();
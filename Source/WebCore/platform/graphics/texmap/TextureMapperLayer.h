@@ -121,6 +121,9 @@ public:
 
     void syncAnimations();
     bool descendantsOrSelfHaveRunningAnimations() const;
+    // Where the animating subtrees land with their current transforms, in
+    // root coordinates. Called on the root layer.
+    FloatRect runningAnimationsBoundingRect();
 
     void paint();
 
@@ -139,6 +142,7 @@ private:
         return *this;
     }
     void computeTransformsRecursive();
+    void uniteRunningAnimationRects(FloatRect&, bool inAnimatingSubtree) const;
 
     static void sortByZOrder(Vector<TextureMapperLayer* >& array);
 
@@ -195,6 +195,21 @@ bool ImageFrame::copyBitmapData(const ImageFrame& other)
     return true;
 }
 
+Vector<ImageFrame::PixelData> ImageFrame::takeBackingStore()
+{
+    Vector<PixelData> backingStore = WTF::move(m_backingStore);
+    m_bytes = 0;
+    m_size = IntSize();
+    m_status = FrameEmpty;
+    return backingStore;
+}
+
+void ImageFrame::adoptBackingStore(Vector<PixelData>&& backingStore)
+{
+    ASSERT(!width() && !height());
+    m_backingStore = WTF::move(backingStore);
+}
+
 bool ImageFrame::setSize(int newWidth, int newHeight)
 {
     ASSERT(!width() && !height());
@@ -84,6 +84,12 @@ namespace WebCore {
         // the other.  Returns whether the copy succeeded.
         bool copyBitmapData(const ImageFrame&);
 
+        // Gives the pixel storage away for another frame to reuse, leaving
+        // this one empty.
+        Vector<PixelData> takeBackingStore();
+        // Makes setSize() of this empty frame decode into the given storage.
+        void adoptBackingStore(Vector<PixelData>&&);
+
         // Copies the pixel data at [(startX, startY), (endX, startY)) to the
         // same X-coordinates on each subsequent row up to but not including
         // endY.
@@ -395,6 +401,15 @@ namespace WebCore {
         // compositing).
         virtual void clearFrameBufferCache(size_t) { }
 
+        // Takes the pixel storage of the first frame of the decoder of the
+        // previous image in a stream of them, such as the parts of a
+        // multipart/x-mixed-replace response, for a frame as big to reuse.
+        void reuseFrameBufferOf(ImageDecoder& previous)
+        {
+            if (!previous.m_frameBufferCache.isEmpty())
+                m_recycledFrameBuffer = previous.m_frameBufferCache[0].takeBackingStore();
+        }
+
 #if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
         void setMaxNumPixels(int m) { m_maxNumPixels = m; }
 #endif
@@ -411,8 +426,19 @@ namespace WebCore {
         int lowerBoundScaledY(int origY, int searchStart = 0);
         int scaledY(int origY, int searchStart = 0);
 
+        // Sizes a frame, in the storage from reuseFrameBufferOf() if it has
+        // the same size.
+        bool setFrameSize(ImageFrame& buffer, int width, int height)
+        {
+            if (m_recycledFrameBuffer.size() == static_cast<size_t>(width) * height)
+                buffer.adoptBackingStore(WTF::move(m_recycledFrameBuffer));
+            m_recycledFrameBuffer.clear();
+            return buffer.setSize(width, height);
+        }
+
         RefPtr<SharedBuffer> m_data; // The encoded data.
         Vector<ImageFrame, 1> m_frameBufferCache;
+        Vector<ImageFrame::PixelData> m_recycledFrameBuffer;
         // FIXME: Do we need m_colorProfile any more, for any port?
         ColorProfile m_colorProfile;
         bool m_scaled;
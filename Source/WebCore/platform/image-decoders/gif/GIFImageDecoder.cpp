@@ -357,7 +357,7 @@ bool GIFImageDecoder::initFrameBuffer(unsigned frameIndex)
 
     if (!frameIndex) {
         // This is the first frame, so we're not relying on any previous data.
-        if (!buffer->setSize(scaledSize().width(), scaledSize().height()))
+        if (!setFrameSize(*buffer, scaledSize().width(), scaledSize().height()))
             return setFailed();
     } else {
         // The starting state for this frame depends on the previous frame's
@@ -30,7 +30,17 @@
 
 namespace WebCore {
 
+class URL;
+
+enum class PreconnectReason {
+    LinkHint, // <link rel=preconnect>
+    LinkHover // Speculative, platforms may ignore it.
+};
+
 WEBCORE_EXPORT void prefetchDNS(const String& hostname);
+
+// Open a connection to the URL's origin ahead of a request to it.
+WEBCORE_EXPORT void preconnectTo(const URL&, PreconnectReason);
 }
 
 #endif
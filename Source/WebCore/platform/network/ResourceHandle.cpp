@@ -239,4 +239,12 @@ void ResourceHandle::setDefersLoading(bool defers)
     platformSetDefersLoading(defers);
 }
 
+void ResourceHandle::didChangePriority(ResourceLoadPriority priority)
+{
+    d->m_firstRequest.setPriority(priority);
+#if USE(CURL)
+    platformDidChangePriority(priority);
+#endif
+}
+
 } // namespace WebCore
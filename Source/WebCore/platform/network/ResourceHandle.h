@@ -217,6 +217,7 @@ public:
 #endif
 
     WEBCORE_EXPORT void setDefersLoading(bool);
+    void didChangePriority(ResourceLoadPriority);
 
     WEBCORE_EXPORT ResourceRequest& firstRequest();
     const String& lastHTTPMethod() const;
@@ -253,6 +254,9 @@ private:
     };
 
     void platformSetDefersLoading(bool);
+#if USE(CURL)
+    void platformDidChangePriority(ResourceLoadPriority);
+#endif
 
     void scheduleFailure(FailureType);
 
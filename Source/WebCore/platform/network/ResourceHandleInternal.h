@@ -44,6 +44,7 @@
 
 #if USE(CURL)
 #include <curl/curl.h>
+#include "CurlContentDecoder.h"
 #include "FormDataStreamCurl.h"
 #include "MultipartHandle.h"
 #endif
@@ -158,6 +159,12 @@ namespace WebCore {
 
         std::unique_ptr<MultipartHandle> m_multipartHandle;
         bool m_addedCacheValidationHeaders { false };
+        // Scheme, host and port of HTTP(S) jobs, null for the rest.
+        String m_origin;
+        // Set when curl passes the body on still encoded, to be decoded
+        // by m_contentDecoder.
+        bool m_decodesContent { false };
+        RefPtr<CurlContentDecoder> m_contentDecoder;
 #endif
 #if USE(SOUP)
         GRefPtr<SoupMessage> m_soupMessage;
@@ -112,4 +112,8 @@ void prefetchDNS(const String& hostname)
     DNSResolveQueue::singleton().add(hostname);
 }
 
+void preconnectTo(const URL&, PreconnectReason)
+{
+}
+
 }
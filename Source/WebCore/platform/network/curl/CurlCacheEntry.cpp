@@ -43,24 +43,22 @@
 #include <wtf/DateMath.h>
 #include <wtf/HexNumber.h>
 #include <wtf/MD5.h>
+#include <wtf/text/StringBuilder.h>
 
 namespace WebCore {
 
 CurlCacheEntry::CurlCacheEntry(const String& url, ResourceHandle* job, const String& cacheDir)
-    : m_headerFilename(cacheDir)
+    : m_cacheDir(cacheDir)
     , m_contentFilename(cacheDir)
     , m_contentFile(invalidPlatformFileHandle)
     , m_entrySize(0)
+    , m_storedTime(currentTimeMS())
     , m_expireDate(-1)
-    , m_headerParsed(false)
     , m_isLoading(false)
     , m_job(job)
 {
     generateBaseFilename(url.latin1());
 
-    m_headerFilename.append(m_basename);
-    m_headerFilename.append(".header");
-
     m_contentFilename.append(m_basename);
     m_contentFilename.append(".content");
 }
@@ -75,35 +73,38 @@ bool CurlCacheEntry::isLoading() const
     return m_isLoading;
 }
 
+String CurlCacheEntry::bodyFilename(const String& cacheDir, const String& bodyHash)
+{
+    return cacheDir + bodyHash + ".blob";
+}
+
 // Cache manager should invalidate the entry on false
 bool CurlCacheEntry::isCached()
 {
-    if (!fileExists(m_contentFilename) || !fileExists(m_headerFilename))
-        return false;
-
-    if (!m_headerParsed) {
-        if (!loadResponseHeaders())
-            return false;
-    }
-
-    if (m_expireDate < currentTimeMS()) {
-        m_headerParsed = false;
-        return false;
-    }
-
-    if (!entrySize())
+    if (m_bodyHash.isEmpty())
         return false;
 
-    return true;
+    return m_expireDate >= currentTimeMS();
 }
 
-bool CurlCacheEntry::saveCachedData(const char* data, size_t size)
+bool CurlCacheEntry::saveCachedData(const SharedBuffer& data)
 {
     if (!openContentFile())
         return false;
 
-    // Append
-    writeToFile(m_contentFile, data, size);
+    // Append. A failed write invalidates the whole entry, so this block
+    // isn't counted.
+    const char* segment;
+    unsigned position = 0;
+    while (unsigned length = data.getSomeData(segment, position)) {
+        if (writeToFile(m_contentFile, segment, length) != static_cast<int>(length)) {
+            LOG(Network, "Cache Error: Could not write to %s\n", m_contentFilename.latin1().data());
+            return false;
+        }
+        m_contentHasher.addBytes(reinterpret_cast<const uint8_t*>(segment), length);
+        position += length;
+    }
+    m_entrySize += position;
 
     return true;
 }
@@ -113,60 +114,71 @@ bool CurlCacheEntry::readCachedData(ResourceHandle* job)
     ASSERT(job->client());
 
     Vector<char> buffer;
-    if (!loadFileToBuffer(m_contentFilename, buffer))
+    if (!loadFileToBuffer(bodyFilename(m_cacheDir, m_bodyHash), buffer) || buffer.size() != m_entrySize)
         return false;
 
     if (buffer.size())
-        job->getInternal()->client()->didReceiveData(job, buffer.data(), buffer.size(), 0);
+        job->getInternal()->client()->didReceiveBuffer(job, SharedBuffer::adoptVector(buffer), 0);
 
     return true;
 }
 
-bool CurlCacheEntry::saveResponseHeaders(const ResourceResponse& response)
+void CurlCacheEntry::saveResponseHeaders(const ResourceResponse& response)
 {
-    PlatformFileHandle headerFile = openFile(m_headerFilename, OpenForWrite);
-    if (!isHandleValid(headerFile)) {
-        LOG(Network, "Cache Error: Could not open %s for write\n", m_headerFilename.latin1().data());
-        return false;
-    }
+    for (const auto& header : response.httpHeaderFields())
+        m_cachedResponse.setHTTPHeaderField(header.key, header.value);
+}
 
-    // Headers
-    HTTPHeaderMap::const_iterator it = response.httpHeaderFields().begin();
-    HTTPHeaderMap::const_iterator end = response.httpHeaderFields().end();
-    while (it != end) {
-        String headerField = it->key;
-        headerField.append(": ");
-        headerField.append(it->value);
-        headerField.append("\n");
-        CString headerFieldLatin1 = headerField.latin1();
-        writeToFile(headerFile, headerFieldLatin1.data(), headerFieldLatin1.length());
-        m_cachedResponse.setHTTPHeaderField(it->key, it->value);
-        ++it;
+// A record is a line with the body's hash and size and when the entry was
+// stored, then the response headers, up to an empty line.
+bool CurlCacheEntry::writeIndexRecord(PlatformFileHandle indexFile) const
+{
+    StringBuilder record;
+    record.append(m_bodyHash);
+    record.append(' ');
+    record.appendNumber(static_cast<unsigned long long>(m_entrySize));
+    record.append(' ');
+    record.appendNumber(static_cast<long long>(m_storedTime));
+    record.append('\n');
+
+    for (const auto& header : m_cachedResponse.httpHeaderFields()) {
+        record.append(header.key);
+        record.appendLiteral(": ");
+        record.append(header.value);
+        record.append('\n');
     }
+    record.append('\n');
 
-    closeFile(headerFile);
-    return true;
+    CString recordLatin1 = record.toString().latin1();
+    return writeToFile(indexFile, recordLatin1.data(), recordLatin1.length()) == static_cast<int>(recordLatin1.length());
 }
 
-bool CurlCacheEntry::loadResponseHeaders()
+bool CurlCacheEntry::readIndexRecord(const Vector<String>& lines, size_t& position)
 {
-    Vector<char> buffer;
-    if (!loadFileToBuffer(m_headerFilename, buffer))
+    if (position >= lines.size())
         return false;
 
-    String headerContent = String(buffer.data(), buffer.size());
-    Vector<String> headerFields;
-    headerContent.split('\n', headerFields);
+    Vector<String> fields;
+    lines[position++].split(' ', fields);
 
-    Vector<String>::const_iterator it = headerFields.begin();
-    Vector<String>::const_iterator end = headerFields.end();
-    while (it != end) {
-        size_t splitPosition = it->find(":");
+    while (position < lines.size() && !lines[position].isEmpty()) {
+        const String& line = lines[position++];
+        size_t splitPosition = line.find(':');
         if (splitPosition != notFound)
-            m_cachedResponse.setHTTPHeaderField(it->left(splitPosition), it->substring(splitPosition+1).stripWhiteSpace());
-        ++it;
+            m_cachedResponse.setHTTPHeaderField(line.left(splitPosition), line.substring(splitPosition + 1).stripWhiteSpace());
     }
+    position++;
+
+    if (fields.size() != 3 || fields[0].length() != 2 * SHA1::hashSize)
+        return false;
+
+    bool sizeValid, timeValid;
+    m_entrySize = fields[1].toUInt64(&sizeValid);
+    m_storedTime = fields[2].toInt64(&timeValid);
+    if (!sizeValid || !timeValid)
+        return false;
 
+    m_bodyHash = fields[0];
     return parseResponseHeaders(m_cachedResponse);
 }
 
@@ -207,9 +219,16 @@ void CurlCacheEntry::didFail()
 
 void CurlCacheEntry::didFinishLoading()
 {
+    if (m_isLoading)
+        m_bodyHash = m_contentHasher.computeHexDigest().data();
     setIsLoading(false);
 }
 
+void CurlCacheEntry::forgetBody()
+{
+    m_bodyHash = String();
+}
+
 void CurlCacheEntry::generateBaseFilename(const CString& url)
 {
     MD5 md5;
@@ -264,7 +283,6 @@ bool CurlCacheEntry::loadFileToBuffer(const String& filepath, Vector<char>& buff
 void CurlCacheEntry::invalidate()
 {
     closeContentFile();
-    deleteFile(m_headerFilename);
     deleteFile(m_contentFilename);
     LOG(Network, "Cache: invalidated %s\n", m_basename.latin1().data());
 }
@@ -276,13 +294,7 @@ bool CurlCacheEntry::parseResponseHeaders(const ResourceResponse& response)
     if (response.cacheControlContainsNoCache() || response.cacheControlContainsNoStore() || !response.hasCacheValidatorFields())
         return false;
 
-    double fileTime;
-    time_t fileModificationDate;
-
-    if (getFileModificationTime(m_headerFilename, fileModificationDate))
-        fileTime = difftime(fileModificationDate, 0) * 1000.0;
-    else
-        fileTime = currentTimeMS(); // GMT
+    double fileTime = m_storedTime; // GMT
 
     auto maxAge = response.cacheControlMaxAge();
     auto lastModificationDate = response.lastModified();
@@ -322,7 +334,6 @@ bool CurlCacheEntry::parseResponseHeaders(const ResourceResponse& response)
     if (etag.isNull() && lastModified.isNull())
         return false;
 
-    m_headerParsed = true;
     return true;
 }
 
@@ -335,28 +346,6 @@ void CurlCacheEntry::setIsLoading(bool isLoading)
         closeContentFile();
 }
 
-size_t CurlCacheEntry::entrySize()
-{
-    if (!m_entrySize) {
-        long long headerFileSize;
-        long long contentFileSize;
-
-        if (!getFileSize(m_headerFilename, headerFileSize)) {
-            LOG(Network, "Cache Error: Could not get file size of %s\n", m_headerFilename.latin1().data());
-            return m_entrySize;
-        }
-        if (!getFileSize(m_contentFilename, contentFileSize)) {
-            LOG(Network, "Cache Error: Could not get file size of %s\n", m_contentFilename.latin1().data());
-            return m_entrySize;
-        }
-
-        m_entrySize = headerFileSize + contentFileSize;
-    }
-
-    return m_entrySize;
-}
-
-
 bool CurlCacheEntry::openContentFile()
 {
     if (isHandleValid(m_contentFile))
@@ -32,14 +32,19 @@
 #include "ResourceHandle.h"
 #include "ResourceRequest.h"
 #include "ResourceResponse.h"
+#include "SharedBuffer.h"
 #include <wtf/HashMap.h>
 #include <wtf/ListHashSet.h>
+#include <wtf/SHA1.h>
 #include <wtf/Vector.h>
 #include <wtf/text/CString.h>
 #include <wtf/text/WTFString.h>
 
 namespace WebCore {
 
+// An entry keeps the response headers in memory, and names its body by
+// the body's hash. Bodies are files of their own, shared by all entries
+// with the same content; the manager counts their references.
 class CurlCacheEntry {
 
 public:
@@ -48,18 +53,32 @@ public:
 
     bool isCached();
     bool isLoading() const;
-    size_t entrySize();
+    size_t entrySize() const { return m_entrySize; }
     HTTPHeaderMap& requestHeaders() { return m_requestHeaders; }
 
-    bool saveCachedData(const char* data, size_t);
+    // Empty until the body has been loaded
+    const String& bodyHash() const { return m_bodyHash; }
+    static String bodyFilename(const String& cacheDir, const String& bodyHash);
+
+    bool saveCachedData(const SharedBuffer&);
     bool readCachedData(ResourceHandle*);
 
-    bool saveResponseHeaders(const ResourceResponse&);
+    void saveResponseHeaders(const ResourceResponse&);
     void setResponseFromCachedHeaders(ResourceResponse&);
 
+    // The manager moves the loaded body to its shared file, or drops it
+    // if there is one already.
+    const String& contentFilename() const { return m_contentFilename; }
+
+    bool writeIndexRecord(PlatformFileHandle) const;
+    bool readIndexRecord(const Vector<String>& lines, size_t& position);
+
     void invalidate();
     void didFail();
     void didFinishLoading();
+    // For a loaded body the manager couldn't store, so that invalidating
+    // the entry doesn't release the stored body with the same hash.
+    void forgetBody();
 
     bool parseResponseHeaders(const ResourceResponse&);
 
@@ -73,14 +92,16 @@ public:
 
 private:
     String m_basename;
-    String m_headerFilename;
+    String m_cacheDir;
     String m_contentFilename;
 
     PlatformFileHandle m_contentFile;
+    SHA1 m_contentHasher;
+    String m_bodyHash;
 
     size_t m_entrySize;
+    double m_storedTime;
     double m_expireDate;
-    bool m_headerParsed;
     bool m_isLoading;
     ListHashSet<ResourceHandle*> m_clients;
 
@@ -91,7 +112,6 @@ private:
 
     void generateBaseFilename(const CString& url);
     bool loadFileToBuffer(const String& filepath, Vector<char>& buffer);
-    bool loadResponseHeaders();
 
     bool openContentFile();
     bool closeContentFile();
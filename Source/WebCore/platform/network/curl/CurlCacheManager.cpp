@@ -37,12 +37,15 @@
 #include "ResourceHandleInternal.h"
 #include "ResourceRequest.h"
 #include <wtf/HashMap.h>
+#include <wtf/HashSet.h>
 #include <wtf/text/CString.h>
 
 #define IO_BUFFERSIZE 4096
 
 namespace WebCore {
 
+static const char indexVersion[] = "CurlCacheManager index 2";
+
 CurlCacheManager& CurlCacheManager::getInstance()
 {
     static CurlCacheManager instance;
@@ -105,6 +108,7 @@ void CurlCacheManager::loadIndex()
     PlatformFileHandle indexFile = openFile(indexFilePath, OpenForRead);
     if (!isHandleValid(indexFile)) {
         LOG(Network, "Cache Warning: Could not open %s for read\n", indexFilePath.latin1().data());
+        removeUnusedFiles();
         return;
     }
 
@@ -129,30 +133,58 @@ void CurlCacheManager::loadIndex()
     closeFile(indexFile);
 
     // Create strings from buffer
-    String headerContent = String(buffer.data(), buffer.size());
-    Vector<String> indexURLs;
-    headerContent.split('\n', indexURLs);
+    String indexContent = String(buffer.data(), buffer.size());
+    Vector<String> indexLines;
+    indexContent.split('\n', true, indexLines);
     buffer.clear();
 
-    // Add entries to index
-    Vector<String>::const_iterator it = indexURLs.begin();
-    Vector<String>::const_iterator end = indexURLs.end();
-    if (indexURLs.size() > 1)
-        --end; // Last line is empty
-    while (it != end) {
-        String url = it->stripWhiteSpace();
+    // An index of another version, like the URL list kept along with a
+    // header file per URL before, is dropped with its files.
+    if (indexLines.isEmpty() || indexLines[0] != indexVersion) {
+        removeUnusedFiles();
+        return;
+    }
+
+    HashSet<String> bodyFiles;
+    for (const auto& path : listDirectory(m_cacheDir, "*.blob"))
+        bodyFiles.add(pathGetFileName(path));
+
+    // Add entries to index, most recently used first
+    size_t position = 1;
+    while (position < indexLines.size() && !indexLines[position].isEmpty()) {
+        String url = indexLines[position++];
         auto cacheEntry = std::make_unique<CurlCacheEntry>(url, nullptr, m_cacheDir);
 
-        if (cacheEntry->isCached() && cacheEntry->entrySize() < m_storageSizeLimit) {
-            m_currentStorageSize += cacheEntry->entrySize();
-            makeRoomForNewEntry();
-            m_LRUEntryList.prependOrMoveToFirst(url);
-            m_index.set(url, WTF::move(cacheEntry));
-        } else
-            cacheEntry->invalidate();
+        if (!cacheEntry->readIndexRecord(indexLines, position) || !cacheEntry->isCached())
+            continue;
+        if (!bodyFiles.contains(cacheEntry->bodyHash() + ".blob"))
+            continue;
+        if (cacheEntry->entrySize() >= m_storageSizeLimit)
+            continue;
+
+        addBodyReference(*cacheEntry);
+        m_LRUEntryList.add(url);
+        m_index.set(url, WTF::move(cacheEntry));
+        makeRoomForNewEntry();
+    }
+
+    removeUnusedFiles();
+}
 
-        ++it;
+// Deletes the bodies no entry refers to, and the files of interrupted
+// loads.
+void CurlCacheManager::removeUnusedFiles()
+{
+    for (const auto& path : listDirectory(m_cacheDir, "*.blob")) {
+        String filename = pathGetFileName(path);
+        if (!m_bodies.contains(filename.left(filename.length() - 5)))
+            deleteFile(path);
     }
+
+    for (const auto& path : listDirectory(m_cacheDir, "*.content"))
+        deleteFile(path);
+    for (const auto& path : listDirectory(m_cacheDir, "*.header"))
+        deleteFile(path);
 }
 
 void CurlCacheManager::saveIndex()
@@ -170,13 +202,19 @@ void CurlCacheManager::saveIndex()
         return;
     }
 
-    auto it = m_LRUEntryList.begin();
-    const auto& end = m_LRUEntryList.end();
-    while (it != end) {
-        const CString& urlLatin1 = it->latin1();
+    writeToFile(indexFile, indexVersion, sizeof(indexVersion) - 1);
+    writeToFile(indexFile, "\n", 1);
+
+    for (const auto& url : m_LRUEntryList) {
+        // Entries still loading are left out, their files are removed on load
+        const CurlCacheEntry& cacheEntry = *m_index.get(url);
+        if (cacheEntry.bodyHash().isEmpty())
+            continue;
+
+        const CString& urlLatin1 = url.latin1();
         writeToFile(indexFile, urlLatin1.data(), urlLatin1.length());
         writeToFile(indexFile, "\n", 1);
-        ++it;
+        cacheEntry.writeIndexRecord(indexFile);
     }
 
     closeFile(indexFile);
@@ -220,10 +258,10 @@ void CurlCacheManager::didReceiveResponse(ResourceHandle& job, ResourceResponse&
         auto cacheEntry = std::make_unique<CurlCacheEntry>(url, &job, m_cacheDir);
         bool cacheable = cacheEntry->parseResponseHeaders(response);
         if (cacheable) {
+            cacheEntry->saveResponseHeaders(response);
             cacheEntry->setIsLoading(true);
             m_LRUEntryList.prependOrMoveToFirst(url);
             m_index.set(url, WTF::move(cacheEntry));
-            saveResponseHeaders(url, response);
         }
     } else
         invalidateCacheEntry(url);
@@ -237,8 +275,130 @@ void CurlCacheManager::didFinishLoading(ResourceHandle& job)
     const String& url = job.firstRequest().url().string();
 
     auto it = m_index.find(url);
-    if (it != m_index.end())
-        it->value->didFinishLoading();
+    if (it == m_index.end())
+        return;
+
+    // Loads of the URL other than the one saving the body don't finish it
+    CurlCacheEntry& cacheEntry = *it->value;
+    if (!cacheEntry.isLoading() || cacheEntry.getJob() != &job)
+        return;
+
+    cacheEntry.didFinishLoading();
+    if (!storeBody(cacheEntry))
+        invalidateCacheEntry(url);
+}
+
+static bool filesHaveSameContent(const String& path1, const String& path2)
+{
+    PlatformFileHandle file1 = openFile(path1, OpenForRead);
+    PlatformFileHandle file2 = openFile(path2, OpenForRead);
+    bool same = isHandleValid(file1) && isHandleValid(file2);
+
+    char buffer1[4096];
+    char buffer2[4096];
+    while (same) {
+        int length1 = readFromFile(file1, buffer1, sizeof(buffer1));
+        int length2 = readFromFile(file2, buffer2, sizeof(buffer2));
+        same = length1 >= 0 && length1 == length2 && !memcmp(buffer1, buffer2, length1);
+        if (length1 <= 0)
+            break;
+    }
+
+    if (isHandleValid(file1))
+        closeFile(file1);
+    if (isHandleValid(file2))
+        closeFile(file2);
+    return same;
+}
+
+static String hashFile(const String& path)
+{
+    PlatformFileHandle file = openFile(path, OpenForRead);
+    if (!isHandleValid(file))
+        return String();
+
+    SHA1 hasher;
+    char buffer[4096];
+    int length;
+    while ((length = readFromFile(file, buffer, sizeof(buffer))) > 0)
+        hasher.addBytes(reinterpret_cast<const uint8_t*>(buffer), length);
+    closeFile(file);
+
+    if (length < 0)
+        return String();
+    return hasher.computeHexDigest().data();
+}
+
+// Identical bodies are stored once, whichever URLs they came from. A body
+// already stored makes the one just loaded redundant, once the two files
+// are known to match; the hash alone isn't trusted.
+bool CurlCacheManager::storeBody(CurlCacheEntry& cacheEntry)
+{
+    const String bodyFilename = CurlCacheEntry::bodyFilename(m_cacheDir, cacheEntry.bodyHash());
+
+    auto it = m_bodies.find(cacheEntry.bodyHash());
+    if (it != m_bodies.end()) {
+        if (it->value.size == cacheEntry.entrySize() && filesHaveSameContent(cacheEntry.contentFilename(), bodyFilename)) {
+            LOG(Network, "Cache: %s is stored already\n", cacheEntry.bodyHash().latin1().data());
+            deleteFile(cacheEntry.contentFilename());
+            m_currentStorageSize -= std::min(m_currentStorageSize, cacheEntry.entrySize());
+            it->value.refCount++;
+            return true;
+        }
+
+        // Another body with this hash is stored, so the new one isn't cached.
+        if (hashFile(bodyFilename) == it->key) {
+            LOG(Network, "Cache Error: %s is the hash of another body\n", cacheEntry.contentFilename().latin1().data());
+            cacheEntry.forgetBody();
+            return false;
+        }
+
+        // The stored file was damaged. The body just loaded replaces it for
+        // every entry that shares it.
+        LOG(Network, "Cache: replacing damaged %s\n", bodyFilename.latin1().data());
+        if (!moveFile(cacheEntry.contentFilename(), bodyFilename)) {
+            cacheEntry.forgetBody();
+            return false;
+        }
+        m_currentStorageSize -= std::min(m_currentStorageSize, it->value.size);
+        it->value.size = cacheEntry.entrySize();
+        it->value.refCount++;
+        return true;
+    }
+
+    if (!moveFile(cacheEntry.contentFilename(), bodyFilename)) {
+        LOG(Network, "Cache Error: Could not store %s\n", cacheEntry.contentFilename().latin1().data());
+        m_currentStorageSize -= std::min(m_currentStorageSize, cacheEntry.entrySize());
+        return false;
+    }
+
+    m_bodies.add(cacheEntry.bodyHash(), StoredBody { 1, cacheEntry.entrySize() });
+    return true;
+}
+
+void CurlCacheManager::addBodyReference(const CurlCacheEntry& cacheEntry)
+{
+    auto result = m_bodies.add(cacheEntry.bodyHash(), StoredBody { 0, cacheEntry.entrySize() });
+    if (result.isNewEntry)
+        m_currentStorageSize += cacheEntry.entrySize();
+    result.iterator->value.refCount++;
+}
+
+void CurlCacheManager::releaseBody(const CurlCacheEntry& cacheEntry)
+{
+    // A body still loading is counted as it arrives
+    if (cacheEntry.bodyHash().isEmpty()) {
+        m_currentStorageSize -= std::min(m_currentStorageSize, cacheEntry.entrySize());
+        return;
+    }
+
+    auto it = m_bodies.find(cacheEntry.bodyHash());
+    if (it == m_bodies.end() || --it->value.refCount)
+        return;
+
+    deleteFile(CurlCacheEntry::bodyFilename(m_cacheDir, it->key));
+    m_currentStorageSize -= std::min(m_currentStorageSize, it->value.size);
+    m_bodies.remove(it);
 }
 
 bool CurlCacheManager::isCached(const String& url) const
@@ -269,7 +429,7 @@ bool CurlCacheManager::getCachedResponse(const String& url, ResourceResponse& re
     return false;
 }
 
-void CurlCacheManager::didReceiveData(ResourceHandle& job, const char* data, size_t size)
+void CurlCacheManager::didReceiveData(ResourceHandle& job, SharedBuffer& data)
 {
     if (m_disabled)
         return;
@@ -281,28 +441,17 @@ void CurlCacheManager::didReceiveData(ResourceHandle& job, const char* data, siz
         if (it->value->getJob() != &job)
             return;
 
-        if (!it->value->saveCachedData(data, size))
+        if (!it->value->saveCachedData(data))
             invalidateCacheEntry(url);
 
         else {
-            m_currentStorageSize += size;
+            m_currentStorageSize += data.size();
             m_LRUEntryList.prependOrMoveToFirst(url);
             makeRoomForNewEntry();
         }
     }
 }
 
-void CurlCacheManager::saveResponseHeaders(const String& url, ResourceResponse& response)
-{
-    if (m_disabled)
-        return;
-
-    auto it = m_index.find(url);
-    if (it != m_index.end())
-        if (!it->value->saveResponseHeaders(response))
-            invalidateCacheEntry(url);
-}
-
 void CurlCacheManager::invalidateCacheEntry(const String& url)
 {
     if (m_disabled)
@@ -310,11 +459,7 @@ void CurlCacheManager::invalidateCacheEntry(const String& url)
 
     auto it = m_index.find(url);
     if (it != m_index.end()) {
-        if (m_currentStorageSize < it->value->entrySize())
-            m_currentStorageSize = 0;
-        else
-            m_currentStorageSize -= it->value->entrySize();
-
+        releaseBody(*it->value);
         it->value->invalidate();
         m_index.remove(url);
     }
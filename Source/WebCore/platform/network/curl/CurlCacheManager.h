@@ -50,7 +50,7 @@ public:
     bool getCachedResponse(const String& url, ResourceResponse&);
 
     void didReceiveResponse(ResourceHandle&, ResourceResponse&);
-    void didReceiveData(ResourceHandle&, const char*, size_t); // Save data
+    void didReceiveData(ResourceHandle&, SharedBuffer&); // Save data
     void didFinishLoading(ResourceHandle&);
     void didFail(ResourceHandle&);
 
@@ -67,15 +67,25 @@ private:
     String m_cacheDir;
     HashMap<String, std::unique_ptr<CurlCacheEntry>> m_index;
 
+    // Bodies by their hash, with the number of entries sharing each
+    struct StoredBody {
+        unsigned refCount;
+        size_t size;
+    };
+    HashMap<String, StoredBody> m_bodies;
+
     ListHashSet<String> m_LRUEntryList;
     size_t m_currentStorageSize;
     size_t m_storageSizeLimit;
 
     void saveIndex();
     void loadIndex();
+    void removeUnusedFiles();
     void makeRoomForNewEntry();
 
-    void saveResponseHeaders(const String&, ResourceResponse&);
+    bool storeBody(CurlCacheEntry&);
+    void addBodyReference(const CurlCacheEntry&);
+    void releaseBody(const CurlCacheEntry&);
     void invalidateCacheEntry(const String&);
     void readCachedData(const String&, ResourceHandle*, ResourceResponse&);
 };
@@ -0,0 +1,430 @@
+/*
+ * Copyright (C) 2015 Lauri Kasanen
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "CurlContentDecoder.h"
+
+#if USE(CURL)
+
+#include "ResourceHandle.h"
+#include "ResourceHandleInternal.h"
+#include "ResourceHandleManager.h"
+#include "SharedBuffer.h"
+
+#include <wtf/CurrentTime.h>
+#include <wtf/MainThread.h>
+#include <wtf/NeverDestroyed.h>
+#include <zlib.h>
+
+#if USE(BROTLI)
+#include <brotli/decode.h>
+#endif
+#if USE(ZSTD)
+#include <zstd.h>
+#endif
+
+namespace WebCore {
+
+// Decoded output grows by this much at a time.
+static const size_t outputChunkSize = 32 * 1024;
+
+static ContentDecodingStatistics decodingStatistics;
+
+static Mutex& statisticsMutex()
+{
+    static NeverDestroyed<Mutex> mutex;
+    return mutex;
+}
+
+// One thread decodes for every response. Its queue keeps each response's
+// chunks in the order curl received them.
+class ContentDecoderThread {
+    friend NeverDestroyed<ContentDecoderThread>;
+public:
+    static ContentDecoderThread& singleton();
+
+    void append(PassRefPtr<CurlContentDecoder>, Vector<char>& input, bool finish);
+
+private:
+    ContentDecoderThread();
+
+    void run();
+
+    struct Task {
+        RefPtr<CurlContentDecoder> decoder;
+        Vector<char> input;
+        bool finish;
+    };
+
+    Mutex m_mutex;
+    ThreadCondition m_condition;
+    Deque<Task> m_tasks;
+    bool m_started;
+};
+
+ContentDecoderThread& ContentDecoderThread::singleton()
+{
+    static NeverDestroyed<ContentDecoderThread> thread;
+
+    return thread;
+}
+
+ContentDecoderThread::ContentDecoderThread()
+    : m_started(false)
+{
+}
+
+void ContentDecoderThread::append(PassRefPtr<CurlContentDecoder> decoder, Vector<char>& input, bool finish)
+{
+    ASSERT(isMainThread());
+
+    Task task;
+    task.decoder = decoder;
+    task.input.swap(input);
+    task.finish = finish;
+
+    MutexLocker lock(m_mutex);
+    m_tasks.append(WTF::move(task));
+    m_condition.signal();
+
+    if (!m_started) {
+        m_started = true;
+        detachThread(createThread("WebCore: content decoder", [this] { run(); }));
+    }
+}
+
+void ContentDecoderThread::run()
+{
+    while (true) {
+        Task task;
+        {
+            MutexLocker lock(m_mutex);
+            while (m_tasks.isEmpty())
+                m_condition.wait(m_mutex);
+            task = m_tasks.takeFirst();
+        }
+
+        task.decoder->process(task.input, task.finish);
+    }
+}
+
+PassRefPtr<CurlContentDecoder> CurlContentDecoder::create(ResourceHandle* job, const String& contentEncoding)
+{
+    String encoding = contentEncoding.stripWhiteSpace().lower();
+
+    if (encoding == "gzip" || encoding == "x-gzip")
+        return adoptRef(new CurlContentDecoder(job, Encoding::Gzip));
+    if (encoding == "deflate")
+        return adoptRef(new CurlContentDecoder(job, Encoding::Deflate));
+#if USE(BROTLI)
+    if (encoding == "br")
+        return adoptRef(new CurlContentDecoder(job, Encoding::Brotli));
+#endif
+#if USE(ZSTD)
+    if (encoding == "zstd")
+        return adoptRef(new CurlContentDecoder(job, Encoding::Zstd));
+#endif
+
+    return nullptr;
+}
+
+const char* CurlContentDecoder::acceptEncoding()
+{
+    return "gzip, deflate"
+#if USE(BROTLI)
+        ", br"
+#endif
+#if USE(ZSTD)
+        ", zstd"
+#endif
+        ;
+}
+
+ContentDecodingStatistics CurlContentDecoder::statistics()
+{
+    MutexLocker lock(statisticsMutex());
+    return decodingStatistics;
+}
+
+CurlContentDecoder::CurlContentDecoder(ResourceHandle* job, Encoding encoding)
+    : m_job(job)
+    , m_encoding(encoding)
+    , m_zstream(nullptr)
+#if USE(BROTLI)
+    , m_brotliState(nullptr)
+#endif
+#if USE(ZSTD)
+    , m_zstdStream(nullptr)
+#endif
+    , m_receivedData(false)
+    , m_streamEnded(false)
+    , m_failed(false)
+    , m_state(State::Decoding)
+{
+    switch (m_encoding) {
+    case Encoding::Gzip:
+    case Encoding::Deflate:
+        m_zstream = static_cast<z_stream*>(fastZeroedMalloc(sizeof(z_stream)));
+        // Accepts both the gzip and zlib wrappers
+        m_failed = inflateInit2(m_zstream, MAX_WBITS + 32) != Z_OK;
+        break;
+    case Encoding::Brotli:
+#if USE(BROTLI)
+        m_brotliState = BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
+        m_failed = !m_brotliState;
+#endif
+        break;
+    case Encoding::Zstd:
+#if USE(ZSTD)
+        m_zstdStream = ZSTD_createDStream();
+        m_failed = !m_zstdStream || ZSTD_isError(ZSTD_initDStream(m_zstdStream));
+#endif
+        break;
+    }
+
+    MutexLocker lock(statisticsMutex());
+    decodingStatistics.responses++;
+}
+
+CurlContentDecoder::~CurlContentDecoder()
+{
+    if (m_zstream) {
+        inflateEnd(m_zstream);
+        fastFree(m_zstream);
+    }
+#if USE(BROTLI)
+    if (m_brotliState)
+        BrotliDecoderDestroyInstance(m_brotliState);
+#endif
+#if USE(ZSTD)
+    if (m_zstdStream)
+        ZSTD_freeDStream(m_zstdStream);
+#endif
+}
+
+void CurlContentDecoder::decode(const char* data, size_t length)
+{
+    Vector<char> input;
+    input.append(data, length);
+    ContentDecoderThread::singleton().append(this, input, false);
+}
+
+void CurlContentDecoder::finish()
+{
+    Vector<char> input;
+    ContentDecoderThread::singleton().append(this, input, true);
+}
+
+void CurlContentDecoder::process(const Vector<char>& input, bool finish)
+{
+    Vector<char> output;
+
+    if (!m_failed && !input.isEmpty()) {
+        const double start = monotonicallyIncreasingTime();
+        m_failed = !decodeChunk(input.data(), input.size(), output);
+        const double elapsed = monotonicallyIncreasingTime() - start;
+
+        MutexLocker lock(statisticsMutex());
+        decodingStatistics.encodedBytes += input.size();
+        decodingStatistics.decodedBytes += output.size();
+        decodingStatistics.decodeTime += elapsed;
+    }
+
+    bool wasEmpty;
+    {
+        MutexLocker lock(m_outputMutex);
+        if (m_state != State::Decoding)
+            return;
+
+        wasEmpty = m_output.isEmpty();
+        if (!output.isEmpty())
+            m_output.append(WTF::move(output));
+        else if (!m_failed && !finish)
+            return;
+
+        // A body cut short still gets what was decoded of it, like curl
+        // did. Only data the decoder rejects fails the load.
+        if (m_failed)
+            m_state = State::Failed;
+        else if (finish)
+            m_state = State::Finished;
+    }
+
+    // One wakeup covers everything queued before the main thread runs.
+    if (wasEmpty || m_failed || finish) {
+        RefPtr<CurlContentDecoder> protect(this);
+        callOnMainThread([protect] {
+            protect->deliver();
+        });
+    }
+}
+
+bool CurlContentDecoder::decodeChunk(const char* data, size_t length, Vector<char>& output)
+{
+    switch (m_encoding) {
+    case Encoding::Gzip:
+    case Encoding::Deflate:
+        return inflateChunk(data, length, output);
+
+    case Encoding::Brotli: {
+#if USE(BROTLI)
+        if (m_streamEnded)
+            return true;
+
+        size_t availableIn = length;
+        const uint8_t* nextIn = reinterpret_cast<const uint8_t*>(data);
+        while (true) {
+            const size_t used = output.size();
+            output.grow(used + outputChunkSize);
+            size_t availableOut = outputChunkSize;
+            uint8_t* nextOut = reinterpret_cast<uint8_t*>(output.data() + used);
+
+            BrotliDecoderResult result = BrotliDecoderDecompressStream(m_brotliState, &availableIn, &nextIn, &availableOut, &nextOut, nullptr);
+            output.shrink(used + outputChunkSize - availableOut);
+
+            if (result == BROTLI_DECODER_RESULT_ERROR)
+                return false;
+            if (result == BROTLI_DECODER_RESULT_SUCCESS)
+                m_streamEnded = true;
+            if (result != BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT)
+                return true;
+        }
+#endif
+        return false;
+    }
+
+    case Encoding::Zstd: {
+#if USE(ZSTD)
+        ZSTD_inBuffer in = { data, length, 0 };
+        while (true) {
+            const size_t used = output.size();
+            output.grow(used + outputChunkSize);
+            ZSTD_outBuffer out = { output.data() + used, outputChunkSize, 0 };
+
+            size_t result = ZSTD_decompressStream(m_zstdStream, &out, &in);
+            output.shrink(used + out.pos);
+
+            if (ZSTD_isError(result))
+                return false;
+            // A full output buffer may leave more to flush
+            if (in.pos == in.size && out.pos < out.size)
+                return true;
+        }
+#endif
+        return false;
+    }
+    }
+
+    return false;
+}
+
+bool CurlContentDecoder::inflateChunk(const char* data, size_t length, Vector<char>& output)
+{
+    // Anything after the end of the stream is ignored
+    if (m_streamEnded)
+        return true;
+
+    bool firstChunk = !m_receivedData;
+    m_receivedData = true;
+
+    m_zstream->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    m_zstream->avail_in = length;
+
+    while (true) {
+        const size_t used = output.size();
+        output.grow(used + outputChunkSize);
+        m_zstream->next_out = reinterpret_cast<Bytef*>(output.data() + used);
+        m_zstream->avail_out = outputChunkSize;
+
+        int result = inflate(m_zstream, Z_NO_FLUSH);
+        output.shrink(used + outputChunkSize - m_zstream->avail_out);
+
+        if (result == Z_STREAM_END) {
+            m_streamEnded = true;
+            return true;
+        }
+
+        // Some servers send deflate without the zlib wrapper. The header
+        // is checked first, so this shows on the first chunk.
+        if (result == Z_DATA_ERROR && m_encoding == Encoding::Deflate && firstChunk && !m_zstream->total_out) {
+            if (inflateReset2(m_zstream, -MAX_WBITS) != Z_OK)
+                return false;
+            m_zstream->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+            m_zstream->avail_in = length;
+            firstChunk = false;
+            continue;
+        }
+
+        if (result != Z_OK && result != Z_BUF_ERROR)
+            return false;
+        if (!m_zstream->avail_in && m_zstream->avail_out)
+            return true;
+    }
+}
+
+void CurlContentDecoder::deliver()
+{
+    ASSERT(isMainThread());
+
+    RefPtr<CurlContentDecoder> protect(this);
+
+    while (m_job) {
+        RefPtr<ResourceHandle> job = m_job;
+        ResourceHandleInternal* d = job->getInternal();
+        if (d->m_cancelled) {
+            m_job = nullptr;
+            return;
+        }
+        if (d->m_defersLoading)
+            return;
+
+        Vector<char> data;
+        State state;
+        {
+            MutexLocker lock(m_outputMutex);
+            if (!m_output.isEmpty())
+                data = m_output.takeFirst();
+            state = m_state;
+        }
+
+        if (!data.isEmpty()) {
+            ResourceHandleManager::sharedInstance()->didReceiveDecodedData(job.get(), SharedBuffer::adoptVector(data));
+            continue;
+        }
+
+        if (state == State::Decoding)
+            return;
+
+        m_job = nullptr;
+        if (state == State::Finished)
+            ResourceHandleManager::sharedInstance()->didFinishDecoding(job.get());
+        else
+            ResourceHandleManager::sharedInstance()->didFailDecoding(job.get());
+    }
+}
+
+} // namespace WebCore
+
+#endif
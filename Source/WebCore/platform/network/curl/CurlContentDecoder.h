@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2015 Lauri Kasanen
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CurlContentDecoder_h
+#define CurlContentDecoder_h
+
+#include <wtf/Deque.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/ThreadSafeRefCounted.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+typedef struct z_stream_s z_stream;
+#if USE(BROTLI)
+typedef struct BrotliDecoderStateStruct BrotliDecoderState;
+#endif
+#if USE(ZSTD)
+typedef struct ZSTD_DCtx_s ZSTD_DStream;
+#endif
+
+namespace WebCore {
+
+class ResourceHandle;
+
+// Response bodies decoded since startup.
+struct ContentDecodingStatistics {
+    uint64_t responses;
+    uint64_t encodedBytes;
+    uint64_t decodedBytes;
+    // Time spent decoding on the decoder thread, in seconds.
+    double decodeTime;
+};
+
+// Decodes the body of one response on a thread shared by all of them, so
+// that inflating doesn't hold up the main thread's poll loop. The decoded
+// data, and then the end of the body, are handed back to the manager on
+// the main thread, in order.
+class CurlContentDecoder : public ThreadSafeRefCounted<CurlContentDecoder> {
+public:
+    // Null if the encoding is identity or not compiled in.
+    static PassRefPtr<CurlContentDecoder> create(ResourceHandle*, const String& contentEncoding);
+    ~CurlContentDecoder();
+
+    // The encodings to advertise, those compiled in.
+    static const char* acceptEncoding();
+    static ContentDecodingStatistics statistics();
+
+    void decode(const char* data, size_t length);
+    void finish();
+
+    // Hands over what has been decoded so far, unless the job defers loading.
+    void deliver();
+    // The job is going away, anything left is dropped.
+    void detach() { m_job = nullptr; }
+
+private:
+    friend class ContentDecoderThread;
+
+    enum class Encoding { Gzip, Deflate, Brotli, Zstd };
+    enum class State { Decoding, Finished, Failed };
+
+    CurlContentDecoder(ResourceHandle*, Encoding);
+
+    // These run on the decoder thread.
+    void process(const Vector<char>& input, bool finish);
+    bool decodeChunk(const char* data, size_t length, Vector<char>& output);
+    bool inflateChunk(const char* data, size_t length, Vector<char>& output);
+
+    ResourceHandle* m_job;
+    const Encoding m_encoding;
+
+    // Decoder thread only
+    z_stream* m_zstream;
+#if USE(BROTLI)
+    BrotliDecoderState* m_brotliState;
+#endif
+#if USE(ZSTD)
+    ZSTD_DStream* m_zstdStream;
+#endif
+    bool m_receivedData;
+    bool m_streamEnded;
+    bool m_failed;
+
+    Mutex m_outputMutex;
+    Deque<Vector<char>> m_output;
+    State m_state;
+};
+
+}
+
+#endif
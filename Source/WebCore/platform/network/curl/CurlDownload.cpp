@@ -226,16 +226,21 @@ void CurlDownloadManager::downloadThread(void* data)
         CURLcode err = curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &download);
 
         if (msg->msg == CURLMSG_DONE) {
-            if (msg->data.result == CURLE_OK)
-                callOnMainThread([download] {
-                    if (download)
-                        download->didFinish();
-                });
-            else
-                callOnMainThread([download] {
-                    if (download)
-                        download->didFail();
-                });
+            // The download may be gone by the time the main thread gets here.
+            if (download) {
+                WeakPtr<CurlDownload> weakDownload = download->m_weakPtrFactory.createWeakPtr();
+                // A ranged download aborts its transfer itself once the range end is reached.
+                if (msg->data.result == CURLE_OK || (msg->data.result == CURLE_WRITE_ERROR && download->m_rangeComplete))
+                    callOnMainThread([weakDownload] {
+                        if (weakDownload)
+                            weakDownload->didFinish();
+                    });
+                else
+                    callOnMainThread([weakDownload] {
+                        if (weakDownload)
+                            weakDownload->didFail();
+                    });
+            }
 
             downloadManager->removeFromCurl(msg->easy_handle);
         }
@@ -256,6 +261,16 @@ CurlDownload::CurlDownload()
 , m_deletesFileUponFailure(false)
 , m_listener(0)
 , m_finished(false)
+, m_outputHandle(invalidPlatformFileHandle)
+, m_outputOffset(0)
+, m_rangeStart(0)
+, m_rangeEnd(-1)
+, m_written(0)
+, m_pendingDataLength(0)
+, m_rangeRequested(false)
+, m_rangeComplete(false)
+, m_rangeIgnored(false)
+, m_weakPtrFactory(this)
 {
     m_response = new ResourceResponse;
 }
@@ -375,6 +390,43 @@ ResourceResponse CurlDownload::getResponse() const
     return *m_response;
 }
 
+void CurlDownload::setOutputFile(PlatformFileHandle handle, long long offset)
+{
+    MutexLocker locker(m_mutex);
+    m_outputHandle = handle;
+    m_outputOffset = offset;
+}
+
+void CurlDownload::setRange(long long start, long long end)
+{
+    MutexLocker locker(m_mutex);
+    m_rangeStart = start;
+    m_rangeEnd = end;
+
+    if (!start && end < 0)
+        return;
+
+    String range = String::number(start) + "-";
+    if (end >= 0)
+        range.append(String::number(end));
+    // Curl copies the string.
+    curl_easy_setopt(m_curlHandle, CURLOPT_RANGE, range.latin1().data());
+    m_rangeRequested = true;
+}
+
+long long CurlDownload::setRangeEnd(long long end)
+{
+    MutexLocker locker(m_mutex);
+    m_rangeEnd = std::max(end, m_rangeStart + m_written - 1);
+    return m_rangeEnd;
+}
+
+long long CurlDownload::bytesWritten() const
+{
+    MutexLocker locker(m_mutex);
+    return m_written;
+}
+
 void CurlDownload::closeFile()
 {
     if (m_tempHandle != invalidPlatformFileHandle) {
@@ -405,13 +457,20 @@ void CurlDownload::moveFileToDestination()
 #endif
 }
 
-void CurlDownload::writeDataToFile(const char* data, int size)
+bool CurlDownload::writeDataToFile(const char* data, int size)
 {
+    if (m_outputHandle != invalidPlatformFileHandle) {
+        if (seekFile(m_outputHandle, m_outputOffset + m_written, SeekFromBeginning) < 0)
+            return false;
+        return writeToFile(m_outputHandle, data, size) == size;
+    }
+
     if (m_tempPath.isEmpty())
         m_tempPath = openTemporaryFile("download", m_tempHandle);
 
-    if (m_tempHandle != invalidPlatformFileHandle)
-        writeToFile(m_tempHandle, data, size);
+    if (m_tempHandle == invalidPlatformFileHandle)
+        return false;
+    return writeToFile(m_tempHandle, data, size) == size;
 }
 
 void CurlDownload::addHeaders(const ResourceRequest& request)
@@ -451,7 +510,14 @@ void CurlDownload::didReceiveHeader(const String& header)
         long httpCode = 0;
         CURLcode err = curl_easy_getinfo(m_curlHandle, CURLINFO_RESPONSE_CODE, &httpCode);
 
+        // A server ignoring the Range header sends the whole body; writing that
+        // at the range offset would corrupt the file. Redirects are followed.
+        if (m_rangeRequested && httpCode >= 200 && httpCode != 206 && (httpCode < 300 || httpCode >= 400))
+            m_rangeIgnored = true;
+
         if (httpCode >= 200 && httpCode < 300) {
+            m_response->setHTTPStatusCode(httpCode);
+
             const char* url = 0;
             err = curl_easy_getinfo(m_curlHandle, CURLINFO_EFFECTIVE_URL, &url);
             m_response->setURL(URL(ParsedURLString, url));
@@ -468,8 +534,10 @@ void CurlDownload::didReceiveHeader(const String& header)
             m_response->setMimeType(extractMIMETypeFromMediaType(m_response->httpHeaderField(HTTPHeaderName::ContentType)));
             m_response->setTextEncodingName(extractCharsetFromMediaType(m_response->httpHeaderField(HTTPHeaderName::ContentType)));
 
-            callOnMainThread([this] {
-                didReceiveResponse();
+            WeakPtr<CurlDownload> weakThis = m_weakPtrFactory.createWeakPtr();
+            callOnMainThread([weakThis] {
+                if (weakThis)
+                    weakThis->didReceiveResponse();
             });
         }
     } else {
@@ -479,15 +547,46 @@ void CurlDownload::didReceiveHeader(const String& header)
     }
 }
 
-void CurlDownload::didReceiveData(void* data, int size)
+size_t CurlDownload::didReceiveData(void* data, int size)
 {
     MutexLocker locker(m_mutex);
 
-    callOnMainThread([this, size] {
-        didReceiveDataOfLength(size);
-    });
+    if (m_rangeIgnored)
+        return 0;
+
+    if (m_rangeEnd >= 0) {
+        long long remaining = m_rangeEnd - m_rangeStart + 1 - m_written;
+        if (remaining <= 0) {
+            m_rangeComplete = true;
+            return 0;
+        }
+        if (size > remaining)
+            size = remaining;
+    }
+
+    // A failed write, like on a full disk, fails the transfer rather than
+    // leaving a hole in the file.
+    if (!writeDataToFile(static_cast<const char*>(data), size))
+        return 0;
+    m_written += size;
+
+    // Progress is coalesced: only one notification is queued at a time, and
+    // it reports everything received until the main thread gets to it.
+    m_pendingDataLength += size;
+    if (m_pendingDataLength == size) {
+        WeakPtr<CurlDownload> weakThis = m_weakPtrFactory.createWeakPtr();
+        callOnMainThread([weakThis] {
+            if (weakThis)
+                weakThis->didReceiveDataOfLength();
+        });
+    }
+
+    if (m_rangeEnd >= 0 && m_written >= m_rangeEnd - m_rangeStart + 1) {
+        m_rangeComplete = true;
+        return 0;
+    }
 
-    writeDataToFile(static_cast<const char*>(data), size);
+    return size;
 }
 
 void CurlDownload::didReceiveResponse()
@@ -496,32 +595,44 @@ void CurlDownload::didReceiveResponse()
         m_listener->didReceiveResponse();
 }
 
-void CurlDownload::didReceiveDataOfLength(int size)
+void CurlDownload::didReceiveDataOfLength()
 {
-    if (m_listener)
+    int size;
+    {
+        MutexLocker locker(m_mutex);
+        size = m_pendingDataLength;
+        m_pendingDataLength = 0;
+    }
+
+    if (m_listener && size)
         m_listener->didReceiveDataOfLength(size);
 }
 
 void CurlDownload::didFinish()
 {
-    MutexLocker locker(m_mutex);
+    {
+        MutexLocker locker(m_mutex);
 
-    closeFile();
-    moveFileToDestination();
-    m_finished = true;
+        closeFile();
+        moveFileToDestination();
+        m_finished = true;
+    }
 
+    // The listener may call back into us, so it runs unlocked.
     if (m_listener)
         m_listener->didFinish();
 }
 
 void CurlDownload::didFail()
 {
-    MutexLocker locker(m_mutex);
+    {
+        MutexLocker locker(m_mutex);
 
-    closeFile();
+        closeFile();
 
-    if (m_deletesFileUponFailure)
-        deleteFile(m_tempPath);
+        if (m_deletesFileUponFailure)
+            deleteFile(m_tempPath);
+    }
 
     if (m_listener)
         m_listener->didFail();
@@ -533,7 +644,7 @@ size_t CurlDownload::writeCallback(void* ptr, size_t size, size_t nmemb, void* d
     CurlDownload* download = reinterpret_cast<CurlDownload*>(data);
 
     if (download)
-        download->didReceiveData(ptr, totalSize);
+        return download->didReceiveData(ptr, totalSize);
 
     return totalSize;
 }
@@ -563,10 +674,10 @@ void CurlDownload::downloadFailedCallback(CurlDownload* download)
         download->didFail();
 }
 
-void CurlDownload::receivedDataCallback(CurlDownload* download, int size)
+void CurlDownload::receivedDataCallback(CurlDownload* download, int)
 {
     if (download)
-        download->didReceiveDataOfLength(size);
+        download->didReceiveDataOfLength();
 }
 
 void CurlDownload::receivedResponseCallback(CurlDownload* download)
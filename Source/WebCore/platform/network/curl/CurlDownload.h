@@ -30,6 +30,7 @@
 #include "ResourceHandle.h"
 #include "ResourceResponse.h"
 #include <wtf/Threading.h>
+#include <wtf/WeakPtr.h>
 
 #if PLATFORM(WIN)
 #include <windows.h>
@@ -107,20 +108,34 @@ public:
 
     void setDestination(const String& destination) { m_destination = destination; }
 
+    // Writes the body into an already open file starting at the given offset,
+    // instead of a temporary file moved to the destination. The handle is not
+    // owned; all transfers run on the one download thread, so several
+    // downloads may share a handle.
+    void setOutputFile(PlatformFileHandle, long long offset);
+
+    // Requests only bytes start..end (inclusive, end -1 for the rest of the
+    // resource). The end may be lowered while the download is running; the
+    // transfer then completes once it is reached. setRangeEnd returns the end
+    // actually used, which is later if more was already written.
+    void setRange(long long start, long long end);
+    long long setRangeEnd(long long end);
+    long long bytesWritten() const;
+
     void addHeaders(const ResourceRequest&);
 
 private:
     void closeFile();
     void moveFileToDestination();
-    void writeDataToFile(const char* data, int size);
+    bool writeDataToFile(const char* data, int size);
 
     // Called on download thread.
     void didReceiveHeader(const String& header);
-    void didReceiveData(void* data, int size);
+    size_t didReceiveData(void* data, int size);
 
     // Called on main thread.
     void didReceiveResponse();
-    void didReceiveDataOfLength(int size);
+    void didReceiveDataOfLength();
     void didFinish();
     void didFail();
 
@@ -143,6 +158,19 @@ private:
     mutable Mutex m_mutex;
     CurlDownloadListener *m_listener;
     bool m_finished;
+    WebCore::PlatformFileHandle m_outputHandle;
+    long long m_outputOffset;
+    long long m_rangeStart;
+    long long m_rangeEnd;
+    long long m_written;
+    int m_pendingDataLength;
+    bool m_rangeRequested;
+    bool m_rangeComplete;
+    bool m_rangeIgnored;
+
+    // The callbacks queued for the main thread hold weak pointers, as the
+    // download may be deleted before they run.
+    WeakPtrFactory<CurlDownload> m_weakPtrFactory;
 
     static CurlDownloadManager m_downloadManager;
 
@@ -0,0 +1,592 @@
+/*
+ * Copyright (C) 2015 Lauri Kasanen
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "CurlRecordReplay.h"
+
+#if USE(CURL)
+
+#include "HTTPHeaderNames.h"
+#include "HTTPParsers.h"
+#include "ResourceError.h"
+#include "ResourceHandle.h"
+#include "ResourceHandleClient.h"
+#include "ResourceHandleInternal.h"
+#include "SharedBuffer.h"
+#include "URL.h"
+
+#include <curl/curl.h>
+#include <stdio.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/text/CString.h>
+#include <wtf/text/StringBuilder.h>
+
+namespace WebCore {
+
+static const char archiveMagic[] = "WebKitFLTK replay 1";
+
+// Replayed bodies are passed on in blocks of at most this size, like curl's.
+static const size_t replayBlockSize = 16 * 1024;
+static const double replayInterval = 0.01;
+
+static bool isReplayedURL(const URL& url)
+{
+    return url.protocolIsInHTTPFamily();
+}
+
+static bool isRecordedHeader(const String& name)
+{
+    // The body is kept as the loader got it, decoded and whole
+    return !equalIgnoringCase(name, "Content-Encoding")
+        && !equalIgnoringCase(name, "Content-Length")
+        && !equalIgnoringCase(name, "Transfer-Encoding");
+}
+
+CurlRecordReplay& CurlRecordReplay::singleton()
+{
+    static NeverDestroyed<CurlRecordReplay> recordReplay;
+
+    return recordReplay;
+}
+
+CurlRecordReplay::CurlRecordReplay()
+    : m_recordFile(invalidPlatformFileHandle)
+    , m_recordStart(0)
+    , m_replaying(false)
+    , m_latency(0)
+    , m_bytesPerSecond(0)
+    , m_replayTimer(*this, &CurlRecordReplay::replayTimerFired)
+    , m_lastTick(0)
+    , m_unusedBytes(0)
+{
+}
+
+String CurlRecordReplay::key(const String& method, const String& url)
+{
+    return method + ' ' + url;
+}
+
+bool CurlRecordReplay::startRecording(const String& path)
+{
+    stop();
+
+    m_recordFile = openFile(path, OpenForWrite);
+    if (!isHandleValid(m_recordFile))
+        return false;
+
+    writeToFile(m_recordFile, archiveMagic, sizeof(archiveMagic) - 1);
+    writeToFile(m_recordFile, "\n", 1);
+    m_recordStart = monotonicallyIncreasingTime();
+    return true;
+}
+
+bool CurlRecordReplay::startReplaying(const String& path, int latencyMs, unsigned bytesPerSecond)
+{
+    stop();
+
+    if (!readArchive(path)) {
+        m_entries.clear();
+        m_index.clear();
+        return false;
+    }
+
+    m_replaying = true;
+    m_latency = latencyMs;
+    m_bytesPerSecond = bytesPerSecond;
+    m_unusedBytes = 0;
+    return true;
+}
+
+void CurlRecordReplay::stop()
+{
+    if (isHandleValid(m_recordFile))
+        closeFile(m_recordFile);
+    m_recordings.clear();
+
+    // The jobs still replaying lose their server. Failing one may start
+    // others, so the list is walked by index.
+    for (size_t i = 0; i < m_replays.size(); i++) {
+        Replay& replay = *m_replays[i];
+        if (replay.done)
+            continue;
+        replay.done = true;
+
+        ResourceHandle* job = replay.job.get();
+        const URL& url = job->firstRequest().url();
+        if (job->client())
+            job->client()->didFail(job, ResourceError(url.host(), CURLE_COULDNT_CONNECT, url.string(), "Replay stopped"));
+    }
+    if (!m_replays.isEmpty() && !m_replayTimer.isActive())
+        m_replayTimer.startOneShot(0);
+
+    m_replaying = false;
+    m_entries.clear();
+    m_index.clear();
+    m_served.clear();
+}
+
+void CurlRecordReplay::willStart(ResourceHandle* job)
+{
+    URL url = job->firstRequest().url();
+    if (!isRecording() || !isReplayedURL(url))
+        return;
+    url.removeFragmentIdentifier();
+
+    std::unique_ptr<Recording> recording = std::make_unique<Recording>();
+    recording->start = monotonicallyIncreasingTime();
+    recording->entry.method = job->firstRequest().httpMethod();
+    recording->entry.url = url.string();
+    recording->entry.statusCode = 0;
+    recording->entry.startTime = (recording->start - m_recordStart) * 1000;
+    recording->entry.responseTime = 0;
+    recording->entry.finishTime = 0;
+    m_recordings.set(job, WTF::move(recording));
+}
+
+void CurlRecordReplay::willRedirect(ResourceHandle* job, const ResourceResponse& response, const URL& newURL)
+{
+    auto it = m_recordings.find(job);
+    if (it == m_recordings.end())
+        return;
+
+    // Each hop is an entry of its own, for the URL it came from
+    Recording& recording = *it->value;
+    didReceiveResponse(job, response);
+    recording.entry.finishTime = recording.entry.responseTime;
+    writeEntry(recording.entry);
+
+    URL url = newURL;
+    url.removeFragmentIdentifier();
+    recording.start = monotonicallyIncreasingTime();
+    recording.entry.url = url.string();
+    recording.entry.statusCode = 0;
+    recording.entry.statusText = String();
+    recording.entry.headers.clear();
+    recording.entry.body.clear();
+    recording.entry.startTime = (recording.start - m_recordStart) * 1000;
+}
+
+void CurlRecordReplay::didReceiveResponse(ResourceHandle* job, const ResourceResponse& response)
+{
+    auto it = m_recordings.find(job);
+    if (it == m_recordings.end())
+        return;
+
+    Entry& entry = it->value->entry;
+    entry.statusCode = response.httpStatusCode();
+    entry.statusText = response.httpStatusText();
+    entry.headers.clear();
+    for (const auto& header : response.httpHeaderFields()) {
+        if (isRecordedHeader(header.key))
+            entry.headers.set(header.key, header.value);
+    }
+    entry.responseTime = (monotonicallyIncreasingTime() - it->value->start) * 1000;
+}
+
+void CurlRecordReplay::didReceiveData(ResourceHandle* job, const SharedBuffer& buffer)
+{
+    auto it = m_recordings.find(job);
+    if (it == m_recordings.end())
+        return;
+
+    Vector<char>& body = it->value->entry.body;
+    const char* segment;
+    unsigned position = 0;
+    while (unsigned length = buffer.getSomeData(segment, position)) {
+        body.append(segment, length);
+        position += length;
+    }
+}
+
+void CurlRecordReplay::didFinishLoading(ResourceHandle* job)
+{
+    std::unique_ptr<Recording> recording = m_recordings.take(job);
+    if (!recording || !recording->entry.statusCode)
+        return;
+
+    recording->entry.finishTime = (monotonicallyIncreasingTime() - recording->start) * 1000;
+    writeEntry(recording->entry);
+}
+
+void CurlRecordReplay::didFail(ResourceHandle* job)
+{
+    m_recordings.remove(job);
+}
+
+// An entry is its request line, a line of status and timing, the headers
+// and a blank line, then the body.
+void CurlRecordReplay::writeEntry(const Entry& entry)
+{
+    StringBuilder builder;
+    builder.append(entry.method);
+    builder.append(' ');
+    builder.append(entry.url);
+    builder.append('\n');
+
+    char status[128];
+    snprintf(status, sizeof(status), "%d %.1f %.1f %.1f %zu ", entry.statusCode,
+        entry.startTime, entry.responseTime, entry.finishTime, entry.body.size());
+    builder.append(status);
+    builder.append(entry.statusText);
+    builder.append('\n');
+
+    for (const auto& header : entry.headers) {
+        builder.append(header.key);
+        builder.appendLiteral(": ");
+        builder.append(header.value);
+        builder.append('\n');
+    }
+    builder.append('\n');
+
+    CString head = builder.toString().latin1();
+    writeToFile(m_recordFile, head.data(), head.length());
+    writeToFile(m_recordFile, entry.body.data(), entry.body.size());
+    writeToFile(m_recordFile, "\n", 1);
+}
+
+static bool readLine(const Vector<char>& data, size_t& position, String& line)
+{
+    size_t end = position;
+    while (end < data.size() && data[end] != '\n')
+        end++;
+    if (end == data.size())
+        return false;
+
+    line = String(data.data() + position, end - position);
+    position = end + 1;
+    return true;
+}
+
+bool CurlRecordReplay::readArchive(const String& path)
+{
+    PlatformFileHandle file = openFile(path, OpenForRead);
+    if (!isHandleValid(file))
+        return false;
+
+    long long size = 0;
+    Vector<char> data;
+    if (getFileSize(file, size) && size > 0) {
+        data.resize(size);
+        if (readFromFile(file, data.data(), size) != size)
+            data.clear();
+    }
+    closeFile(file);
+
+    size_t position = 0;
+    String line;
+    if (!readLine(data, position, line) || line != archiveMagic)
+        return false;
+
+    while (position < data.size()) {
+        std::unique_ptr<Entry> entry = std::make_unique<Entry>();
+
+        if (!readLine(data, position, line))
+            return false;
+        size_t space = line.find(' ');
+        if (space == notFound)
+            return false;
+        entry->method = line.left(space);
+        entry->url = line.substring(space + 1);
+
+        if (!readLine(data, position, line))
+            return false;
+        CString status = line.latin1();
+        size_t bodySize = 0;
+        int statusTextStart = 0;
+        if (sscanf(status.data(), "%d %lf %lf %lf %zu %n", &entry->statusCode, &entry->startTime,
+            &entry->responseTime, &entry->finishTime, &bodySize, &statusTextStart) < 5)
+            return false;
+        entry->statusText = line.substring(statusTextStart);
+
+        while (true) {
+            if (!readLine(data, position, line))
+                return false;
+            if (line.isEmpty())
+                break;
+            size_t colon = line.find(':');
+            if (colon == notFound)
+                return false;
+            entry->headers.set(line.left(colon), line.substring(colon + 1).stripWhiteSpace());
+        }
+
+        if (bodySize > data.size() - position)
+            return false;
+        entry->body.append(data.data() + position, bodySize);
+        position += bodySize + 1;
+
+        m_index.add(key(entry->method, entry->url), Vector<const Entry*>()).iterator->value.append(entry.get());
+        m_entries.append(WTF::move(entry));
+    }
+
+    return true;
+}
+
+const CurlRecordReplay::Entry* CurlRecordReplay::nextEntry(ResourceHandle* job)
+{
+    URL url = job->firstRequest().url();
+    url.removeFragmentIdentifier();
+    const String requestKey = key(job->firstRequest().httpMethod(), url.string());
+
+    auto it = m_index.find(requestKey);
+    if (it == m_index.end())
+        return nullptr;
+
+    // Requests made more often than recorded get the last response again
+    unsigned& served = m_served.add(requestKey, 0).iterator->value;
+    const Entry* entry = it->value[std::min<size_t>(served, it->value.size() - 1)];
+    served++;
+    return entry;
+}
+
+double CurlRecordReplay::latency(const Entry* entry) const
+{
+    if (m_latency >= 0)
+        return m_latency / 1000.0;
+    return entry ? entry->responseTime / 1000 : 0;
+}
+
+void CurlRecordReplay::setResponse(ResourceHandle* job, const Entry& entry)
+{
+    ResourceResponse& response = job->getInternal()->m_response;
+    response = ResourceResponse();
+
+    response.setURL(job->firstRequest().url());
+    response.setHTTPStatusCode(entry.statusCode);
+    response.setHTTPStatusText(entry.statusText);
+    for (const auto& header : entry.headers)
+        response.setHTTPHeaderField(header.key, header.value);
+
+    const String& contentType = response.httpHeaderField(HTTPHeaderName::ContentType);
+    response.setMimeType(extractMIMETypeFromMediaType(contentType).lower());
+    response.setTextEncodingName(extractCharsetFromMediaType(contentType));
+    response.setExpectedContentLength(entry.body.size());
+}
+
+// Like the header callback does for curl's redirects. True if the job
+// moved on to another URL.
+bool CurlRecordReplay::redirect(ResourceHandle* job, const Entry& entry)
+{
+    if (entry.statusCode < 300 || entry.statusCode >= 400 || entry.statusCode == 304)
+        return false;
+
+    ResourceHandleInternal* d = job->getInternal();
+    const String& location = d->m_response.httpHeaderField(HTTPHeaderName::Location);
+    if (location.isEmpty())
+        return false;
+
+    URL newURL = URL(job->firstRequest().url(), location);
+    ResourceRequest redirectedRequest = job->firstRequest();
+    redirectedRequest.setURL(newURL);
+    if (d->client())
+        d->client()->willSendRequest(job, redirectedRequest, d->m_response);
+
+    d->m_firstRequest.setURL(newURL);
+    return true;
+}
+
+bool CurlRecordReplay::add(ResourceHandle* job)
+{
+    if (!m_replaying || !isReplayedURL(job->firstRequest().url()))
+        return false;
+
+    std::unique_ptr<Replay> replay = std::make_unique<Replay>();
+    replay->job = job;
+    replay->entry = nextEntry(job);
+    replay->responseTime = monotonicallyIncreasingTime() + latency(replay->entry);
+    replay->sent = 0;
+    replay->responded = false;
+    replay->done = false;
+    m_replays.append(WTF::move(replay));
+
+    if (!m_replayTimer.isActive())
+        m_replayTimer.startOneShot(0);
+    return true;
+}
+
+bool CurlRecordReplay::dispatchSynchronously(ResourceHandle* job)
+{
+    if (!m_replaying || !isReplayedURL(job->firstRequest().url()))
+        return false;
+
+    ResourceHandleInternal* d = job->getInternal();
+    ResourceHandleClient* client = d->client();
+
+    while (const Entry* entry = nextEntry(job)) {
+        setResponse(job, *entry);
+        if (redirect(job, *entry))
+            continue;
+
+        client->didReceiveResponse(job, d->m_response);
+        client->didReceiveData(job, entry->body.data(), entry->body.size(), entry->body.size());
+        client->didFinishLoading(job, 0);
+        return true;
+    }
+
+    const URL& url = job->firstRequest().url();
+    client->didFail(job, ResourceError(url.host(), CURLE_COULDNT_CONNECT, url.string(), "Not in the replay archive"));
+    return true;
+}
+
+bool CurlRecordReplay::cancel(ResourceHandle* job)
+{
+    for (auto& replay : m_replays) {
+        if (replay->job == job && !replay->done) {
+            replay->done = true;
+            if (!m_replayTimer.isActive())
+                m_replayTimer.startOneShot(0);
+            return true;
+        }
+    }
+    return false;
+}
+
+void CurlRecordReplay::respond(Replay& replay)
+{
+    ResourceHandle* job = replay.job.get();
+    ResourceHandleInternal* d = job->getInternal();
+
+    if (!replay.entry) {
+        replay.done = true;
+        if (d->client()) {
+            const URL& url = job->firstRequest().url();
+            d->client()->didFail(job, ResourceError(url.host(), CURLE_COULDNT_CONNECT, url.string(), "Not in the replay archive"));
+        }
+        return;
+    }
+
+    setResponse(job, *replay.entry);
+    if (redirect(job, *replay.entry)) {
+        replay.entry = nextEntry(job);
+        replay.responseTime = monotonicallyIncreasingTime() + latency(replay.entry);
+        return;
+    }
+
+    replay.responded = true;
+    if (d->client())
+        d->client()->didReceiveResponse(job, d->m_response);
+    d->m_response.setResponseFired(true);
+}
+
+void CurlRecordReplay::send(Replay& replay, size_t allowance)
+{
+    ResourceHandle* job = replay.job.get();
+    ResourceHandleInternal* d = job->getInternal();
+    const Vector<char>& body = replay.entry->body;
+
+    // The client may stop the replay, and the archive with it, from any
+    // of its callbacks, so that's checked before the body is looked at.
+    while (!replay.done && !d->m_defersLoading && replay.sent < body.size() && allowance) {
+        const size_t length = std::min(std::min(body.size() - replay.sent, allowance), replayBlockSize);
+        RefPtr<SharedBuffer> buffer = SharedBuffer::create(body.data() + replay.sent, length);
+        replay.sent += length;
+        allowance -= length;
+        if (d->client())
+            d->client()->didReceiveBuffer(job, buffer.release(), length);
+    }
+
+    if (replay.done || d->m_defersLoading || replay.sent < body.size())
+        return;
+
+    replay.done = true;
+    if (d->client())
+        d->client()->didFinishLoading(job, 0);
+}
+
+void CurlRecordReplay::replayTimerFired()
+{
+    const double now = monotonicallyIncreasingTime();
+    const double elapsed = m_lastTick ? now - m_lastTick : 0;
+    m_lastTick = now;
+
+    unsigned sending = 0;
+    for (auto& replay : m_replays) {
+        if (replay->responded && !replay->done)
+            sending++;
+    }
+
+    // The bodies being sent share the bandwidth evenly. A share one of them
+    // doesn't need is kept for the next round, but not saved up for longer.
+    const double budget = m_unusedBytes + elapsed * m_bytesPerSecond;
+    const size_t share = sending ? budget / sending : 0;
+    double used = 0;
+
+    double nextResponse = 0;
+    const size_t count = m_replays.size();
+    for (size_t i = 0; i < count; i++) {
+        Replay& replay = *m_replays[i];
+        if (replay.done || replay.job->getInternal()->m_defersLoading)
+            continue;
+
+        if (!replay.responded) {
+            if (replay.responseTime > now) {
+                if (!nextResponse || replay.responseTime < nextResponse)
+                    nextResponse = replay.responseTime;
+                continue;
+            }
+            respond(replay);
+            if (!replay.responded || replay.done)
+                continue;
+            // Sends only from the next round when limited, with a share
+            if (m_bytesPerSecond)
+                continue;
+        }
+
+        const size_t sent = replay.sent;
+        send(replay, m_bytesPerSecond ? share : replay.entry->body.size());
+        used += replay.sent - sent;
+    }
+
+    m_unusedBytes = sending ? std::min(std::max(budget - used, 0.0), m_bytesPerSecond * replayInterval) : 0;
+
+    // The jobs let go only after they're out of the list, since their
+    // destructors cancel them.
+    Vector<RefPtr<ResourceHandle>> finished;
+    m_replays.removeAllMatching([&finished] (const std::unique_ptr<Replay>& replay) {
+        if (!replay->done)
+            return false;
+        finished.append(WTF::move(replay->job));
+        return true;
+    });
+    finished.clear();
+
+    if (m_replays.isEmpty()) {
+        m_lastTick = 0;
+        return;
+    }
+
+    bool waitingToSend = false;
+    for (auto& replay : m_replays) {
+        if (replay->responded || replay->job->getInternal()->m_defersLoading)
+            waitingToSend = true;
+    }
+    double delay = replayInterval;
+    if (!waitingToSend && nextResponse)
+        delay = std::max(nextResponse - now, 0.0);
+    m_replayTimer.startOneShot(delay);
+}
+
+} // namespace WebCore
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2015 Lauri Kasanen
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CurlRecordReplay_h
+#define CurlRecordReplay_h
+
+#include "FileSystem.h"
+#include "HTTPHeaderMap.h"
+#include "Timer.h"
+#include <memory>
+#include <wtf/HashMap.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+class ResourceHandle;
+class ResourceResponse;
+class SharedBuffer;
+class URL;
+
+// Records the HTTP(S) responses of the loads the manager runs into an
+// archive file, or serves loads from one instead of the network, so that
+// a page load can be repeated offline and alike every time.
+//
+// Replayed responses come from a timer standing in for the server: each
+// waits the given latency, and the bodies being sent share the bandwidth.
+// A request is matched by method and URL; repeated ones get the recorded
+// responses in order. Redirects are replayed hop by hop, and requests
+// missing from the archive fail.
+class CurlRecordReplay {
+    WTF_MAKE_NONCOPYABLE(CurlRecordReplay);
+public:
+    static CurlRecordReplay& singleton();
+
+    bool startRecording(const String& path);
+    // A negative latency waits as long as the recorded response took to
+    // arrive, a zero bandwidth is unlimited.
+    bool startReplaying(const String& path, int latencyMs, unsigned bytesPerSecond);
+    void stop();
+
+    bool isRecording() const { return isHandleValid(m_recordFile); }
+    bool isReplaying() const { return m_replaying; }
+
+    // The manager tells about each load while recording.
+    void willStart(ResourceHandle*);
+    void willRedirect(ResourceHandle*, const ResourceResponse&, const URL&);
+    void didReceiveResponse(ResourceHandle*, const ResourceResponse&);
+    void didReceiveData(ResourceHandle*, const SharedBuffer&);
+    void didFinishLoading(ResourceHandle*);
+    void didFail(ResourceHandle*);
+
+    // While replaying, HTTP(S) loads are handed here. False if the job
+    // isn't one to replay.
+    bool add(ResourceHandle*);
+    bool dispatchSynchronously(ResourceHandle*);
+    bool cancel(ResourceHandle*);
+
+private:
+    friend NeverDestroyed<CurlRecordReplay>;
+
+    CurlRecordReplay();
+
+    struct Entry {
+        String method;
+        String url;
+        int statusCode;
+        String statusText;
+        HTTPHeaderMap headers;
+        Vector<char> body;
+        // Milliseconds since the recording, then the request, started
+        double startTime;
+        double responseTime;
+        double finishTime;
+    };
+
+    struct Recording {
+        Entry entry;
+        double start;
+    };
+
+    struct Replay {
+        RefPtr<ResourceHandle> job;
+        const Entry* entry;
+        double responseTime;
+        size_t sent;
+        bool responded;
+        bool done;
+    };
+
+    static String key(const String& method, const String& url);
+    void writeEntry(const Entry&);
+    bool readArchive(const String& path);
+
+    const Entry* nextEntry(ResourceHandle*);
+    double latency(const Entry*) const;
+    static void setResponse(ResourceHandle*, const Entry&);
+    static bool redirect(ResourceHandle*, const Entry&);
+    void respond(Replay&);
+    void send(Replay&, size_t allowance);
+    void replayTimerFired();
+
+    PlatformFileHandle m_recordFile;
+    double m_recordStart;
+    HashMap<ResourceHandle*, std::unique_ptr<Recording>> m_recordings;
+
+    bool m_replaying;
+    int m_latency;
+    unsigned m_bytesPerSecond;
+    Vector<std::unique_ptr<Entry>> m_entries;
+    HashMap<String, Vector<const Entry*>> m_index;
+    HashMap<String, unsigned> m_served;
+    Vector<std::unique_ptr<Replay>> m_replays;
+    Timer m_replayTimer;
+    double m_lastTick;
+    double m_unusedBytes;
+};
+
+}
+
+#endif
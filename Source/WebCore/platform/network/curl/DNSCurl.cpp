@@ -25,16 +25,181 @@
 
 #include "config.h"
 #include "DNS.h"
+#include "DNSResolveQueue.h"
 
 #if USE(CURL)
 
-#include "NotImplemented.h"
+#include "ResourceHandleManager.h"
+#include "URL.h"
+
+#include <curl/curl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <wtf/Deque.h>
+#include <wtf/MainThread.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/Threading.h>
+#include <wtf/text/CString.h>
+#include <wtf/text/StringBuilder.h>
 
 namespace WebCore {
 
-void prefetchDNS(const String& /* hostname */)
+// getaddrinfo blocks, so names are resolved on a few threads of their own.
+static const unsigned resolverThreadCount = 4;
+
+class DNSResolverPool {
+    friend NeverDestroyed<DNSResolverPool>;
+public:
+    static DNSResolverPool& singleton();
+
+    void resolve(const String& hostname);
+
+private:
+    DNSResolverPool();
+
+    void run();
+    void resolveName(const CString& hostname);
+
+    Mutex m_mutex;
+    ThreadCondition m_condition;
+    Deque<CString> m_names;
+    unsigned m_threads;
+    unsigned m_idleThreads;
+
+    CURLSH* m_curlShareHandle;
+};
+
+DNSResolverPool& DNSResolverPool::singleton()
+{
+    static NeverDestroyed<DNSResolverPool> pool;
+
+    return pool;
+}
+
+DNSResolverPool::DNSResolverPool()
+    : m_threads(0)
+    , m_idleThreads(0)
+    , m_curlShareHandle(ResourceHandleManager::sharedInstance()->getCurlShareHandle())
+{
+}
+
+void DNSResolverPool::resolve(const String& hostname)
+{
+    ASSERT(isMainThread());
+
+    MutexLocker lock(m_mutex);
+    m_names.append(hostname.latin1());
+
+    if (m_idleThreads)
+        m_condition.signal();
+    else if (m_threads < resolverThreadCount) {
+        m_threads++;
+        detachThread(createThread("WebCore: DNS resolver", [this] { run(); }));
+    }
+}
+
+void DNSResolverPool::run()
+{
+    while (true) {
+        CString hostname;
+        {
+            MutexLocker lock(m_mutex);
+            while (m_names.isEmpty()) {
+                m_idleThreads++;
+                m_condition.wait(m_mutex);
+                m_idleThreads--;
+            }
+            hostname = m_names.takeFirst();
+        }
+
+        resolveName(hostname);
+        DNSResolveQueue::singleton().decrementRequestCount();
+    }
+}
+
+void DNSResolverPool::resolveName(const CString& hostname)
+{
+    struct addrinfo hints = { };
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    // This alone warms a caching system resolver.
+    struct addrinfo* result;
+    if (getaddrinfo(hostname.data(), nullptr, &hints, &result))
+        return;
+
+#if LIBCURL_VERSION_NUM >= 0x074b00
+    StringBuilder addresses;
+    for (struct addrinfo* address = result; address; address = address->ai_next) {
+        char numeric[NI_MAXHOST];
+        if (getnameinfo(address->ai_addr, address->ai_addrlen, numeric, sizeof(numeric), nullptr, 0, NI_NUMERICHOST))
+            continue;
+
+        if (!addresses.isEmpty())
+            addresses.append(',');
+        if (address->ai_family == AF_INET6) {
+            addresses.append('[');
+            addresses.append(numeric);
+            addresses.append(']');
+        } else
+            addresses.append(numeric);
+    }
+    freeaddrinfo(result);
+
+    if (addresses.isEmpty())
+        return;
+
+    // curl only resolves names on its own while connecting. Its shared
+    // cache takes the addresses as entries that expire like the ones it
+    // resolved itself, loaded when a transfer starts, so start an empty one.
+    const String entries = addresses.toString();
+    const String http = String("+") + hostname.data() + ":80:" + entries;
+    const String https = String("+") + hostname.data() + ":443:" + entries;
+    struct curl_slist* resolve = nullptr;
+    resolve = curl_slist_append(resolve, http.latin1().data());
+    resolve = curl_slist_append(resolve, https.latin1().data());
+
+    CURL* curl = curl_easy_init();
+    if (curl) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, m_curlShareHandle);
+        curl_easy_setopt(curl, CURLOPT_RESOLVE, resolve);
+        curl_easy_setopt(curl, CURLOPT_URL, "file:///dev/null");
+        curl_easy_perform(curl);
+        curl_easy_cleanup(curl);
+    }
+    curl_slist_free_all(resolve);
+#else
+    freeaddrinfo(result);
+#endif
+}
+
+bool DNSResolveQueue::platformProxyIsEnabledInSystemPreferences()
 {
-    notImplemented();
+    // A proxy resolves the names itself.
+    return ResourceHandleManager::sharedInstance()->isUsingProxy();
+}
+
+void DNSResolveQueue::platformResolve(const String& hostname)
+{
+    ASSERT(isMainThread());
+
+    DNSResolverPool::singleton().resolve(hostname);
+}
+
+void prefetchDNS(const String& hostname)
+{
+    ASSERT(isMainThread());
+    if (hostname.isEmpty())
+        return;
+
+    DNSResolveQueue::singleton().add(hostname);
+}
+
+void preconnectTo(const URL& url, PreconnectReason reason)
+{
+    ASSERT(isMainThread());
+
+    ResourceHandleManager::sharedInstance()->preconnect(url, reason);
 }
 
 }
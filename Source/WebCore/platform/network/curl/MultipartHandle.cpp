@@ -33,7 +33,6 @@
 #include "ResourceHandleClient.h"
 #include "ResourceHandleInternal.h"
 #include "ResourceResponse.h"
-#include <wtf/StringExtras.h>
 
 namespace WebCore {
 
@@ -77,79 +76,117 @@ bool MultipartHandle::extractBoundary(const String& contentType, String& boundar
 }
 
 
-bool MultipartHandle::matchForBoundary(const char* data, size_t position, size_t& matchedLength)
+char MultipartHandle::characterAt(size_t position) const
 {
-    matchedLength = 0;
+    const char* data;
+    m_buffer->getSomeData(data, position);
+    return *data;
+}
 
-    for (size_t i = 0; i < m_boundaryLength; ++i) {
-        if (data[position + i] != m_boundary[i]) {
-            matchedLength = i;
-            return false;
-        }
+size_t MultipartHandle::matchedLength(const char* pattern, size_t patternLength, size_t position) const
+{
+    size_t matched = 0;
+
+    // The match may go on in the next segment.
+    while (matched < patternLength) {
+        const char* data;
+        size_t length = std::min<size_t>(m_buffer->getSomeData(data, position + matched), patternLength - matched);
+        if (!length || memcmp(data, pattern + matched, length))
+            break;
+        matched += length;
     }
 
-    matchedLength = m_boundaryLength;
-    return true;
+    return matched;
 }
 
-bool MultipartHandle::checkForBoundary(size_t& boundaryStartPosition, size_t& lastPartialMatchPosition)
+size_t MultipartHandle::find(const char* pattern, size_t patternLength, size_t position, size_t& partialMatchPosition) const
 {
-    size_t contentLength = m_buffer.size();
-
-    boundaryStartPosition = notFound;
-    lastPartialMatchPosition = contentLength;
-
-    if (contentLength < m_boundaryLength)
-        return false;
+    size_t contentLength = m_buffer->size();
+    partialMatchPosition = contentLength;
+
+    while (position < contentLength) {
+        const char* data;
+        size_t length = m_buffer->getSomeData(data, position);
+
+        // memchr() goes through the segment a word or vector at a time.
+        const char* candidate = static_cast<const char*>(memchr(data, pattern[0], length));
+        if (!candidate) {
+            position += length;
+            continue;
+        }
 
-    const char* content = m_buffer.data();
-    size_t matched;
+        position += candidate - data;
+        size_t matched = matchedLength(pattern, patternLength, position);
+        if (matched == patternLength)
+            return position;
 
-    for (size_t i = 0; i < contentLength - m_boundaryLength; ++i) {
-        if (matchForBoundary(content, i, matched)) {
-            boundaryStartPosition = i;
-            return true;
+        if (position + matched == contentLength) {
+            // The data ends with the start of the pattern, and more data
+            // decides whether this is it.
+            partialMatchPosition = position;
+            return notFound;
         }
 
-        if (matched)
-            lastPartialMatchPosition = i;
+        ++position;
     }
 
-    return false;
+    return notFound;
 }
 
-bool MultipartHandle::parseHeadersIfPossible()
+bool MultipartHandle::checkForBoundary(size_t& boundaryStartPosition, size_t& lastPartialMatchPosition)
 {
-    size_t contentLength = m_buffer.size();
+    // The data before where the last search stopped has been searched already.
+    boundaryStartPosition = find(m_boundary.data(), m_boundary.length(), std::max(m_position, m_scanPosition), lastPartialMatchPosition);
 
-    if (!contentLength)
-        return false;
+    m_scanPosition = boundaryStartPosition == notFound ? lastPartialMatchPosition : boundaryStartPosition + m_boundary.length();
+    return boundaryStartPosition != notFound;
+}
 
-    const char* content = m_buffer.data();
+bool MultipartHandle::parseHeadersIfPossible()
+{
+    if (m_position == m_buffer->size())
+        return false;
 
     // Check if we have the header closing strings.
-    if (!strnstr(content, "\r\n\r\n", contentLength)) {
+    size_t partialMatch;
+    size_t headerEnd = find("\r\n\r\n", 4, m_position, partialMatch);
+    if (headerEnd != notFound)
+        headerEnd += 4;
+    else {
         // Some servers closes the headers with only \n-s.
-        if (!strnstr(content, "\n\n", contentLength)) {
+        headerEnd = find("\n\n", 2, m_position, partialMatch);
+        if (headerEnd == notFound) {
             // Don't have the header closing string. Wait for more data.
             return false;
         }
+        headerEnd += 2;
+    }
+
+    // The headers are small, so gather them in one piece.
+    Vector<char> header;
+    header.reserveInitialCapacity(headerEnd - m_position);
+    for (size_t position = m_position; position < headerEnd;) {
+        const char* data;
+        size_t length = std::min<size_t>(m_buffer->getSomeData(data, position), headerEnd - position);
+        header.append(data, length);
+        position += length;
     }
 
     // Parse the HTTP headers.
     String value;
     String name;
-    char* p = const_cast<char*>(content);
-    const char* end = content + contentLength;
-    size_t totalConsumedLength = 0;
-    for (; p < end; ++p) {
+    const char* p = header.data();
+    const char* end = p + header.size();
+    while (p < end) {
         String failureReason;
         size_t consumedLength = parseHTTPHeader(p, end - p, failureReason, name, value, false);
         if (!consumedLength)
             break; // No more header to parse.
 
+        // The \n after a \r is left for the caller.
         p += consumedLength;
-        totalConsumedLength += consumedLength;
+        if (p < end && *p == '\n')
+            ++p;
 
         // The name should not be empty, but the value could be empty.
         if (name.isEmpty())
@@ -158,18 +195,20 @@ bool MultipartHandle::parseHeadersIfPossible()
         m_headers.add(name, value);
     }
 
-    m_buffer.remove(0, totalConsumedLength + 1);
+    m_position = headerEnd;
     return true;
 }
 
-void MultipartHandle::contentReceived(const char* data, size_t length)
+void MultipartHandle::contentReceived(SharedBuffer& data)
 {
     if (m_state == End)
         return; // The handler is closed down so ignore everything.
 
-    m_buffer.append(data, length);
+    m_buffer->append(&data);
 
     while (processContent()) { }
+
+    dropProcessedData();
 }
 
 bool MultipartHandle::processContent()
@@ -191,7 +230,7 @@ bool MultipartHandle::processContent()
 */
     switch (m_state) {
     case CheckBoundary: {
-        if (m_buffer.size() < m_boundaryLength) {
+        if (m_buffer->size() - m_position < m_boundary.length()) {
             // We don't have enough data, so just skip.
             return false;
         }
@@ -200,33 +239,32 @@ bool MultipartHandle::processContent()
         size_t boundaryStart;
         size_t lastPartialMatch;
 
-        if (!checkForBoundary(boundaryStart, lastPartialMatch) && boundaryStart == notFound) {
+        if (!checkForBoundary(boundaryStart, lastPartialMatch)) {
             // Did not find the boundary start in this chunk.
             // Skip ahead to the last valid looking boundary character and start again.
-            m_buffer.remove(0, lastPartialMatch);
+            m_position = lastPartialMatch;
             return false;
         }
 
         // Found the boundary start.
         // Consume everything before that and also the boundary
-        m_buffer.remove(0, boundaryStart + m_boundaryLength);
+        m_position = boundaryStart + m_boundary.length();
         m_state = InBoundary;
     }
     // Fallthrough.
     case InBoundary: {
         // Now the first two characters should be: \r\n
-        if (m_buffer.size() < 2)
+        if (m_buffer->size() - m_position < 2)
             return false;
 
-        const char* content = m_buffer.data();
         // By default we'll remove 2 characters at the end.
         // The \r and \n as stated in the multipart RFC.
         size_t removeCount = 2;
 
-        if (content[0] != '\r' || content[1] != '\n') {
+        if (characterAt(m_position) != '\r' || characterAt(m_position + 1) != '\n') {
             // There should be a \r and a \n but it seems that's not the case.
             // So we'll check for a simple \n. Not really RFC compatible but servers do tricky things.
-            if (content[0] != '\n') {
+            if (characterAt(m_position) != '\n') {
                 // Also no \n so just go to the end.
                 m_state = End;
                 return false;
@@ -237,7 +275,7 @@ bool MultipartHandle::processContent()
         }
 
         // Consume the characters.
-        m_buffer.remove(0, removeCount);
+        m_position += removeCount;
         m_headers.clear();
         m_state = InHeader;
     }
@@ -254,33 +292,30 @@ bool MultipartHandle::processContent()
     }
     // Fallthrough.
     case InContent: {
-        if (m_buffer.isEmpty())
+        if (m_position == m_buffer->size())
             return false;
 
-        size_t boundaryStart = notFound;
+        size_t boundaryStart;
         size_t lastPartialMatch;
 
-        if (!checkForBoundary(boundaryStart, lastPartialMatch) && boundaryStart == notFound) {
+        if (!checkForBoundary(boundaryStart, lastPartialMatch)) {
             // Did not find the boundary start, all data up to the lastPartialMatch is ok.
-            didReceiveData(lastPartialMatch);
-            m_buffer.remove(0, lastPartialMatch);
+            didReceiveData(lastPartialMatch - m_position);
             return false;
         }
 
         // There was a boundary start (or end we'll check that later), push out part of the data.
-        didReceiveData(boundaryStart);
-        m_buffer.remove(0, boundaryStart + m_boundaryLength);
+        didReceiveData(boundaryStart - m_position);
+        m_position = boundaryStart + m_boundary.length();
         m_state = EndBoundary;
     }
     // Fallthrough.
     case EndBoundary: {
-        if (m_buffer.size() < 2)
+        if (m_buffer->size() - m_position < 2)
             return false; // Not enough data to check. Return later when there is more data.
 
         // We'll decide if this is a closing boundary or an opening one.
-        const char* content = m_buffer.data();
-
-        if (content[0] == '-' && content[1] == '-') {
+        if (characterAt(m_position) == '-' && characterAt(m_position + 1) == '-') {
             // This is a closing boundary. Close down the handler.
             m_state = End;
             return false;
@@ -302,6 +337,21 @@ bool MultipartHandle::processContent()
     return true; // There are still things to process, so go for it.
 }
 
+void MultipartHandle::dropProcessedData()
+{
+    if (!m_position)
+        return;
+
+    // What's left is at most a partial boundary or header, unless it's
+    // large enough to be shared.
+    RefPtr<SharedBuffer> rest = SharedBuffer::create();
+    rest->append(m_buffer.get(), m_position, m_buffer->size() - m_position);
+    m_buffer = rest.release();
+
+    m_scanPosition = std::max(m_scanPosition, m_position) - m_position;
+    m_position = 0;
+}
+
 void MultipartHandle::contentEnded()
 {
     // Process the leftover data.
@@ -310,11 +360,13 @@ void MultipartHandle::contentEnded()
     if (m_state != End) {
         // It seems we are still not at the end of the processing.
         // Push out the remaining data.
-        didReceiveData(m_buffer.size());
+        didReceiveData(m_buffer->size() - m_position);
         m_state = End;
     }
 
-    m_buffer.clear();
+    m_buffer->clear();
+    m_position = 0;
+    m_scanPosition = 0;
 }
 
 void MultipartHandle::didReceiveData(size_t length)
@@ -327,10 +379,14 @@ void MultipartHandle::didReceiveData(size_t length)
         return;
     }
 
-    if (d->client()) {
-        const char* data = m_buffer.data();
-        d->client()->didReceiveData(m_resourceHandle, data, length, length);
+    if (d->client() && length) {
+        // The part refers to the received data rather than copying it.
+        RefPtr<SharedBuffer> part = SharedBuffer::create();
+        part->append(m_buffer.get(), m_position, length);
+        d->client()->didReceiveBuffer(m_resourceHandle, part.release(), length);
     }
+
+    m_position += length;
 }
 
 void MultipartHandle::didReceiveResponse()
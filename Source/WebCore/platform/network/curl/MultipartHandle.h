@@ -28,7 +28,8 @@
 
 #include "HTTPHeaderMap.h"
 #include "ResourceHandle.h"
-#include <wtf/Vector.h>
+#include "SharedBuffer.h"
+#include <wtf/text/CString.h>
 #include <wtf/text/WTFString.h>
 
 namespace WebCore {
@@ -39,15 +40,17 @@ public:
 
     MultipartHandle(ResourceHandle* handle, const String& boundary)
         : m_resourceHandle(handle)
-        , m_boundary("--" + boundary)
-        , m_boundaryLength(m_boundary.length())
+        , m_boundary(String("--" + boundary).latin1())
+        , m_buffer(SharedBuffer::create())
+        , m_position(0)
+        , m_scanPosition(0)
         , m_state(CheckBoundary)
     {
     }
 
     ~MultipartHandle() { }
 
-    void contentReceived(const char* data, size_t length);
+    void contentReceived(SharedBuffer&);
     void contentEnded();
 
 private:
@@ -63,16 +66,23 @@ private:
     void didReceiveData(size_t length);
     void didReceiveResponse();
 
-    bool matchForBoundary(const char* data, size_t position, size_t& matchedLength);
+    char characterAt(size_t position) const;
+    size_t matchedLength(const char* pattern, size_t patternLength, size_t position) const;
+    size_t find(const char* pattern, size_t patternLength, size_t position, size_t& partialMatchPosition) const;
     inline bool checkForBoundary(size_t& boundaryStartPosition, size_t& lastPartialMatchPosition);
     bool parseHeadersIfPossible();
     bool processContent();
+    void dropProcessedData();
 
     ResourceHandle* m_resourceHandle;
-    String m_boundary;
-    size_t m_boundaryLength;
+    CString m_boundary;
 
-    Vector<char> m_buffer;
+    // The received data, shared with the network buffers and the parts
+    // passed on. What's before m_position is processed, and there is no
+    // boundary starting before m_scanPosition.
+    RefPtr<SharedBuffer> m_buffer;
+    size_t m_position;
+    size_t m_scanPosition;
     HTTPHeaderMap m_headers;
 
     MultipartHandleState m_state;
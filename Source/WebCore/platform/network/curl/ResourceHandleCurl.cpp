@@ -39,6 +39,7 @@
 #include "ResourceHandleInternal.h"
 #include "ResourceHandleManager.h"
 #include "SSLHandle.h"
+#include <wtf/MainThread.h>
 
 #if PLATFORM(WIN) && USE(CF)
 #include <wtf/PassRefPtr.h>
@@ -94,6 +95,8 @@ ResourceHandleInternal::~ResourceHandleInternal()
     fastFree(m_url);
     if (m_customHeaders)
         curl_slist_free_all(m_customHeaders);
+    if (m_contentDecoder)
+        m_contentDecoder->detach();
 }
 
 ResourceHandle::~ResourceHandle()
@@ -150,8 +153,21 @@ void ResourceHandle::setClientCertificate(const String& host, CFDataRef cert)
 }
 #endif
 
+void ResourceHandle::platformDidChangePriority(ResourceLoadPriority priority)
+{
+    ResourceHandleManager::sharedInstance()->didChangePriority(this, priority);
+}
+
 void ResourceHandle::platformSetDefersLoading(bool defers)
 {
+    // Decoded data may be waiting, even after the transfer ended
+    if (!defers && d->m_contentDecoder) {
+        RefPtr<CurlContentDecoder> decoder = d->m_contentDecoder;
+        callOnMainThread([decoder] {
+            decoder->deliver();
+        });
+    }
+
     if (!d->m_handle)
         return;
 
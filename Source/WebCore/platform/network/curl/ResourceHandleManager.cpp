@@ -41,6 +41,8 @@
 
 #include "CredentialStorage.h"
 #include "CurlCacheManager.h"
+#include "CurlContentDecoder.h"
+#include "CurlRecordReplay.h"
 #include "DataURL.h"
 #include "HTTPHeaderNames.h"
 #include "HTTPParsers.h"
@@ -50,6 +52,7 @@
 #include "ResourceHandle.h"
 #include "ResourceHandleInternal.h"
 #include "SSLHandle.h"
+#include "SharedBuffer.h"
 
 #if OS(WINDOWS)
 #include "WebCoreBundleWin.h"
@@ -62,9 +65,7 @@
 
 #include <errno.h>
 #include <stdio.h>
-#if ENABLE(WEB_TIMING)
 #include <wtf/CurrentTime.h>
-#endif
 #if USE(CF)
 #include <wtf/RetainPtr.h>
 #endif
@@ -74,12 +75,23 @@
 #include <wtf/spoofing.h>
 
 extern const char *wk_cookiepath;
+extern unsigned wk_sync_timeout;
+void fl_sync_wait();
 
 namespace WebCore {
 
 // only when waiting on network traffic, poll by this much
 const double pollTimeSeconds = 0.02;
 const int maxRunningJobs = 128;
+// idle connections the multi handle keeps open for reuse
+const long maxCachedConnections = 32;
+// preconnect to an origin at most this often, and this many at once
+const double preconnectInterval = 10;
+const unsigned maxPreconnects = 6;
+// synchronous loads check for repaints this often while they wait
+const int synchronousWaitMilliseconds = 20;
+// idle connections kept for synchronous loads
+const long maxCachedSynchronousConnections = 4;
 
 static const bool ignoreSSLErrors = getenv("WEBKIT_IGNORE_SSL_ERRORS");
 
@@ -142,6 +154,7 @@ static char* cookieJarPath()
 static Mutex* sharedResourceMutex(curl_lock_data data) {
     DEPRECATED_DEFINE_STATIC_LOCAL(Mutex, cookieMutex, ());
     DEPRECATED_DEFINE_STATIC_LOCAL(Mutex, dnsMutex, ());
+    DEPRECATED_DEFINE_STATIC_LOCAL(Mutex, sslSessionMutex, ());
     DEPRECATED_DEFINE_STATIC_LOCAL(Mutex, shareMutex, ());
 
     switch (data) {
@@ -149,6 +162,8 @@ static Mutex* sharedResourceMutex(curl_lock_data data) {
             return &cookieMutex;
         case CURL_LOCK_DATA_DNS:
             return &dnsMutex;
+        case CURL_LOCK_DATA_SSL_SESSION:
+            return &sslSessionMutex;
         case CURL_LOCK_DATA_SHARE:
             return &shareMutex;
         default:
@@ -205,8 +220,8 @@ static int sockoptfunction(void* data, curl_socket_t /*curlfd*/, curlsocktype /*
 #endif
 
 // libcurl does not implement its own thread synchronization primitives.
-// these two functions provide mutexes for cookies, and for the global DNS
-// cache.
+// these two functions provide mutexes for cookies, the global DNS cache and
+// the TLS session cache.
 static void curl_lock_callback(CURL* /* handle */, curl_lock_data data, curl_lock_access /* access */, void* /* userPtr */)
 {
     if (Mutex* mutex = sharedResourceMutex(data))
@@ -239,23 +254,53 @@ inline static bool isHttpNotModified(int statusCode)
     return statusCode == 304;
 }
 
+// HTTP/2 shares a connection among its streams by weight. Each priority
+// gets twice the share of the one below.
+static void setStreamWeight(CURL* handle, ResourceLoadPriority priority)
+{
+#if LIBCURL_VERSION_NUM >= 0x072e00
+    static const long weights[] = { 16, 32, 64, 128, 256 };
+    static_assert(WTF_ARRAY_LENGTH(weights) == resourceLoadPriorityCount, "A weight for every priority");
+    curl_easy_setopt(handle, CURLOPT_STREAM_WEIGHT, weights[static_cast<unsigned>(priority)]);
+#else
+    UNUSED_PARAM(handle);
+    UNUSED_PARAM(priority);
+#endif
+}
+
 ResourceHandleManager::ResourceHandleManager()
     : m_downloadTimer(*this, &ResourceHandleManager::downloadTimerCallback)
     , m_cookieJarFileName(cookieJarPath())
     , m_certificatePath (certificatePath())
     , m_runningJobs(0)
+    , m_http2Supported(false)
+    , m_connectionStatistics()
+    , m_hoverPreconnectEnabled(false)
 #ifndef NDEBUG
     , m_logFile(nullptr)
 #endif
 {
     curl_global_init(CURL_GLOBAL_ALL);
     m_curlMultiHandle = curl_multi_init();
+    m_synchronousMultiHandle = curl_multi_init();
     m_curlShareHandle = curl_share_init();
     curl_share_setopt(m_curlShareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
     curl_share_setopt(m_curlShareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    // Synchronous jobs and downloads resume the sessions of the main loader.
+    // The connection cache stays with the multi handle: curl can't share it
+    // with the download thread.
+    curl_share_setopt(m_curlShareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
     curl_share_setopt(m_curlShareHandle, CURLSHOPT_LOCKFUNC, curl_lock_callback);
     curl_share_setopt(m_curlShareHandle, CURLSHOPT_UNLOCKFUNC, curl_unlock_callback);
 
+    curl_multi_setopt(m_curlMultiHandle, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(maxConnectionsPerHost));
+    curl_multi_setopt(m_curlMultiHandle, CURLMOPT_MAXCONNECTS, maxCachedConnections);
+    curl_multi_setopt(m_synchronousMultiHandle, CURLMOPT_MAXCONNECTS, maxCachedSynchronousConnections);
+#if LIBCURL_VERSION_NUM >= 0x072f00
+    curl_multi_setopt(m_curlMultiHandle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    m_http2Supported = curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2;
+#endif
+
     initCookieSession();
 
 #ifndef NDEBUG
@@ -268,6 +313,7 @@ ResourceHandleManager::ResourceHandleManager()
 ResourceHandleManager::~ResourceHandleManager()
 {
     curl_multi_cleanup(m_curlMultiHandle);
+    curl_multi_cleanup(m_synchronousMultiHandle);
     curl_share_cleanup(m_curlShareHandle);
     if (m_cookieJarFileName)
         fastFree(m_cookieJarFileName);
@@ -294,6 +340,11 @@ const char* ResourceHandleManager::getCookieJarFileName() const
     return m_cookieJarFileName;
 }
 
+unsigned initializeMaximumHTTPConnectionCountPerHost()
+{
+    return ResourceHandleManager::maxRequestsPerHost;
+}
+
 ResourceHandleManager* ResourceHandleManager::sharedInstance()
 {
     static ResourceHandleManager* sharedInstance = 0;
@@ -302,6 +353,14 @@ ResourceHandleManager* ResourceHandleManager::sharedInstance()
     return sharedInstance;
 }
 
+// Asynchronous jobs get their bodies still encoded, so every response that
+// reaches the client needs a decoder for its Content-Encoding.
+static void createContentDecoder(ResourceHandle* job, ResourceHandleInternal* d, long httpCode)
+{
+    if (d->m_decodesContent && !isHttpNotModified(httpCode))
+        d->m_contentDecoder = CurlContentDecoder::create(job, d->m_response.httpHeaderField(HTTPHeaderName::ContentEncoding));
+}
+
 static void handleLocalReceiveResponse (CURL* handle, ResourceHandle* job, ResourceHandleInternal* d)
 {
     // since the code in headerCallback will not have run for local files
@@ -313,12 +372,49 @@ static void handleLocalReceiveResponse (CURL* handle, ResourceHandle* job, Resou
      CURLcode err = curl_easy_getinfo(handle, CURLINFO_EFFECTIVE_URL, &hdr);
      ASSERT_UNUSED(err, CURLE_OK == err);
      d->m_response.setURL(URL(ParsedURLString, hdr));
+
+     // An authentication challenge the client continued without credentials
+     // gets here, with the body of the 401 still to come.
+     long httpCode = 0;
+     curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &httpCode);
+     createContentDecoder(job, d, httpCode);
+
      if (d->client())
          d->client()->didReceiveResponse(job, d->m_response);
      d->m_response.setResponseFired(true);
 }
 
 
+static void didReceiveContent(ResourceHandle* job, PassRefPtr<SharedBuffer> prpBuffer)
+{
+    ResourceHandleInternal* d = job->getInternal();
+    RefPtr<SharedBuffer> buffer = prpBuffer;
+
+    if (d->m_multipartHandle)
+        d->m_multipartHandle->contentReceived(*buffer);
+    else if (d->client()) {
+        // The loader keeps this block by reference and the disk cache
+        // writes from it, so the data is copied just this once.
+        d->client()->didReceiveBuffer(job, buffer, 0);
+        CurlCacheManager::getInstance().didReceiveData(*job, *buffer);
+    }
+    CurlRecordReplay::singleton().didReceiveData(job, *buffer);
+}
+
+static void didFinishContent(ResourceHandle* job)
+{
+    ResourceHandleInternal* d = job->getInternal();
+
+    if (d->m_multipartHandle)
+        d->m_multipartHandle->contentEnded();
+
+    if (d->client()) {
+        d->client()->didFinishLoading(job, 0);
+        CurlCacheManager::getInstance().didFinishLoading(*job);
+    }
+    CurlRecordReplay::singleton().didFinishLoading(job);
+}
+
 // called with data after all headers have been processed via headerCallback
 static size_t writeCallback(void* ptr, size_t size, size_t nmemb, void* data)
 {
@@ -347,12 +443,10 @@ static size_t writeCallback(void* ptr, size_t size, size_t nmemb, void* data)
             return 0;
     }
 
-    if (d->m_multipartHandle)
-        d->m_multipartHandle->contentReceived(static_cast<const char*>(ptr), totalSize);
-    else if (d->client()) {
-        d->client()->didReceiveData(job, static_cast<char*>(ptr), totalSize, 0);
-        CurlCacheManager::getInstance().didReceiveData(*job, static_cast<char*>(ptr), totalSize);
-    }
+    if (d->m_contentDecoder)
+        d->m_contentDecoder->decode(static_cast<const char*>(ptr), totalSize);
+    else
+        didReceiveContent(job, SharedBuffer::create(static_cast<const char*>(ptr), totalSize));
 
     return totalSize;
 }
@@ -555,6 +649,8 @@ static size_t headerCallback(char* ptr, size_t size, size_t nmemb, void* data)
             if (!location.isEmpty()) {
                 URL newURL = URL(job->firstRequest().url(), location);
 
+                CurlRecordReplay::singleton().willRedirect(job, d->m_response, newURL);
+
                 ResourceRequest redirectedRequest = job->firstRequest();
                 redirectedRequest.setURL(newURL);
                 if (client)
@@ -576,6 +672,8 @@ static size_t headerCallback(char* ptr, size_t size, size_t nmemb, void* data)
             }
         }
 
+        createContentDecoder(job, d, httpCode);
+
         if (client) {
             if (isHttpNotModified(httpCode)) {
                 const String& url = job->firstRequest().url().string();
@@ -589,6 +687,7 @@ static size_t headerCallback(char* ptr, size_t size, size_t nmemb, void* data)
             client->didReceiveResponse(job, d->m_response);
             CurlCacheManager::getInstance().didReceiveResponse(*job, d->m_response);
         }
+        CurlRecordReplay::singleton().didReceiveResponse(job, d->m_response);
         d->m_response.setResponseFired(true);
 
     } else {
@@ -729,6 +828,12 @@ void ResourceHandleManager::downloadTimerCallback()
         // find the node which has same d->m_handle as completed transfer
         CURL* handle = msg->easy_handle;
         ASSERT(handle);
+        if (m_preconnects.contains(handle)) {
+            if (CURLMSG_DONE == msg->msg)
+                finishPreconnect(handle);
+            continue;
+        }
+
         ResourceHandle* job = 0;
         CURLcode err = curl_easy_getinfo(handle, CURLINFO_PRIVATE, &job);
         ASSERT_UNUSED(err, CURLE_OK == err);
@@ -746,6 +851,7 @@ void ResourceHandleManager::downloadTimerCallback()
         if (CURLMSG_DONE != msg->msg)
             continue;
 
+        updateConnectionStatistics(job);
 
         if (CURLE_OK == msg->data.result) {
 #if ENABLE(WEB_TIMING)
@@ -759,14 +865,15 @@ void ResourceHandleManager::downloadTimerCallback()
                 }
             }
 
-            if (d->m_multipartHandle)
-                d->m_multipartHandle->contentEnded();
-
-            if (d->client()) {
-                d->client()->didFinishLoading(job, 0);
-                CurlCacheManager::getInstance().didFinishLoading(*job);
-            }
+            // The decoder finishes the load once it has caught up
+            if (d->m_contentDecoder)
+                d->m_contentDecoder->finish();
+            else
+                didFinishContent(job);
         } else {
+            if (d->m_contentDecoder)
+                d->m_contentDecoder->detach();
+
             char* url = 0;
             curl_easy_getinfo(d->m_handle, CURLINFO_EFFECTIVE_URL, &url);
             URL tmpurl(URL(), url);
@@ -779,6 +886,7 @@ void ResourceHandleManager::downloadTimerCallback()
                 d->client()->didFail(job, resourceError);
                 CurlCacheManager::getInstance().didFail(*job);
             }
+            CurlRecordReplay::singleton().didFail(job);
         }
 
         removeFromCurl(job);
@@ -815,6 +923,128 @@ void ResourceHandleManager::setProxyInfo(const String& host,
     }
 }
 
+bool ResourceHandleManager::countNewConnections(CURL* handle)
+{
+    long connects = 0;
+    double appConnectTime = 0;
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects);
+    curl_easy_getinfo(handle, CURLINFO_APPCONNECT_TIME, &appConnectTime);
+
+    if (!connects)
+        return false;
+
+    m_connectionStatistics.newConnections += connects;
+    if (appConnectTime > 0)
+        m_connectionStatistics.tlsHandshakes++;
+    return true;
+}
+
+void ResourceHandleManager::updateConnectionStatistics(ResourceHandle* job)
+{
+    if (!job->firstRequest().url().protocolIsInHTTPFamily())
+        return;
+
+    ResourceHandleInternal* d = job->getInternal();
+    m_connectionStatistics.requests++;
+    if (!countNewConnections(d->m_handle))
+        m_connectionStatistics.reusedConnections++;
+
+#if LIBCURL_VERSION_NUM >= 0x073700
+    curl_off_t bytes = 0;
+    curl_easy_getinfo(d->m_handle, CURLINFO_SIZE_DOWNLOAD_T, &bytes);
+#else
+    double bytes = 0;
+    curl_easy_getinfo(d->m_handle, CURLINFO_SIZE_DOWNLOAD, &bytes);
+#endif
+    m_connectionStatistics.bytesReceived += bytes;
+
+#if LIBCURL_VERSION_NUM >= 0x073200
+    long httpVersion = 0;
+    curl_easy_getinfo(d->m_handle, CURLINFO_HTTP_VERSION, &httpVersion);
+    if (httpVersion == CURL_HTTP_VERSION_2_0) {
+        m_connectionStatistics.http2Requests++;
+        if (!d->m_origin.isNull())
+            m_http2Origins.add(d->m_origin);
+    }
+#endif
+}
+
+bool ResourceHandleManager::isUsingProxy() const
+{
+    // curl also takes proxies from the environment
+    return m_proxy.length() || getenv("http_proxy") || getenv("https_proxy")
+        || getenv("HTTPS_PROXY") || getenv("all_proxy") || getenv("ALL_PROXY");
+}
+
+static size_t discardCallback(void*, size_t size, size_t nmemb, void*)
+{
+    return size * nmemb;
+}
+
+void ResourceHandleManager::preconnect(const URL& url, PreconnectReason reason)
+{
+    if (reason == PreconnectReason::LinkHover && !m_hoverPreconnectEnabled)
+        return;
+
+    // The connection would go to the proxy, which is likely open already.
+    if (!url.isValid() || !url.protocolIsInHTTPFamily() || url.host().isEmpty() || isUsingProxy())
+        return;
+
+    String origin = url.protocol().lower() + "://" + url.host();
+    if (url.hasPort())
+        origin.append(":" + String::number(url.port()));
+    origin.append("/");
+
+    const double now = monotonicallyIncreasingTime();
+    auto it = m_lastPreconnectTime.find(origin);
+    if (it != m_lastPreconnectTime.end() && now - it->value < preconnectInterval)
+        return;
+    if (m_preconnects.size() >= maxPreconnects)
+        return;
+
+    m_lastPreconnectTime.removeIf([now](HashMap<String, double>::KeyValuePairType& entry) {
+        return now - entry.value >= preconnectInterval;
+    });
+    m_lastPreconnectTime.set(origin, now);
+
+    CURL* handle = curl_easy_init();
+    if (!handle)
+        return;
+
+    std::unique_ptr<Preconnect> preconnect = std::make_unique<Preconnect>();
+    preconnect->url = origin.latin1();
+    preconnect->host = url.host().latin1();
+
+    setConnectionOptions(handle, url);
+    setSSLVerifyOptions(handle, preconnect->host.data());
+    curl_easy_setopt(handle, CURLOPT_URL, preconnect->url.data());
+    curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, "OPTIONS");
+#if LIBCURL_VERSION_NUM >= 0x073700
+    curl_easy_setopt(handle, CURLOPT_REQUEST_TARGET, "*");
+#endif
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, discardCallback);
+
+    if (curl_multi_add_handle(m_curlMultiHandle, handle) != CURLM_OK) {
+        curl_easy_cleanup(handle);
+        return;
+    }
+    m_preconnects.add(handle, WTF::move(preconnect));
+
+    if (!m_downloadTimer.isActive())
+        m_downloadTimer.startOneShot(0); // immediately
+}
+
+void ResourceHandleManager::finishPreconnect(CURL* handle)
+{
+    m_connectionStatistics.preconnects++;
+    countNewConnections(handle);
+
+    // The connection stays in the multi handle's cache
+    curl_multi_remove_handle(m_curlMultiHandle, handle);
+    curl_easy_cleanup(handle);
+    m_preconnects.remove(handle);
+}
+
 void ResourceHandleManager::removeFromCurl(ResourceHandle* job)
 {
     ResourceHandleInternal* d = job->getInternal();
@@ -822,6 +1052,11 @@ void ResourceHandleManager::removeFromCurl(ResourceHandle* job)
     if (!d->m_handle)
         return;
     m_runningJobs--;
+    if (!d->m_origin.isNull()) {
+        auto it = m_runningJobsPerOrigin.find(d->m_origin);
+        if (!--it->value)
+            m_runningJobsPerOrigin.remove(it);
+    }
     curl_multi_remove_handle(m_curlMultiHandle, d->m_handle);
     curl_easy_cleanup(d->m_handle);
     d->m_handle = 0;
@@ -939,6 +1174,13 @@ void ResourceHandleManager::setupPOST(ResourceHandle* job, struct curl_slist** h
 
 void ResourceHandleManager::add(ResourceHandle* job)
 {
+    if (CurlRecordReplay::singleton().add(job))
+        return;
+
+    const URL& url = job->firstRequest().url();
+    if (url.protocolIsInHTTPFamily())
+        job->getInternal()->m_origin = url.protocol() + "://" + url.host() + ':' + String::number(url.port());
+
     // we can be called from within curl, so to avoid re-entrancy issues
     // schedule this job to be added the next time we enter curl download loop
     job->ref();
@@ -960,20 +1202,52 @@ bool ResourceHandleManager::removeScheduledJob(ResourceHandle* job)
     return false;
 }
 
-bool ResourceHandleManager::startScheduledJobs()
+// Jobs past a host's connections would wait inside curl, in the order they
+// were added, so they wait here instead. HTTP/2 hosts take more at once.
+bool ResourceHandleManager::hasFreeConnection(ResourceHandle* job) const
 {
-    // TODO: Create a separate stack of jobs for each domain.
+    const String& origin = job->getInternal()->m_origin;
+    if (origin.isNull())
+        return true;
 
+    const unsigned limit = m_http2Origins.contains(origin) ? maxRequestsPerHost : maxConnectionsPerHost;
+    return m_runningJobsPerOrigin.get(origin) < limit;
+}
+
+bool ResourceHandleManager::startScheduledJobs()
+{
     bool started = false;
     while (!m_resourceHandleList.isEmpty() && m_runningJobs < maxRunningJobs) {
-        ResourceHandle* job = m_resourceHandleList[0];
-        m_resourceHandleList.remove(0);
+        // The most important job that can go now, first come first served
+        // among equals.
+        size_t next = notFound;
+        for (size_t i = 0; i < m_resourceHandleList.size(); i++) {
+            ResourceHandle* job = m_resourceHandleList[i];
+            if (next != notFound && job->firstRequest().priority() <= m_resourceHandleList[next]->firstRequest().priority())
+                continue;
+            if (hasFreeConnection(job))
+                next = i;
+        }
+        if (next == notFound)
+            break;
+
+        ResourceHandle* job = m_resourceHandleList[next];
+        m_resourceHandleList.remove(next);
         startJob(job);
         started = true;
     }
     return started;
 }
 
+void ResourceHandleManager::didChangePriority(ResourceHandle* job, ResourceLoadPriority priority)
+{
+    // Queued jobs are picked by the request's priority, running ones get
+    // their stream reweighted.
+    ResourceHandleInternal* d = job->getInternal();
+    if (d->m_handle)
+        setStreamWeight(d->m_handle, priority);
+}
+
 void ResourceHandleManager::dispatchSynchronousJob(ResourceHandle* job)
 {
     URL kurl = job->firstRequest().url();
@@ -984,6 +1258,9 @@ void ResourceHandleManager::dispatchSynchronousJob(ResourceHandle* job)
         return;
     }
 
+    if (CurlRecordReplay::singleton().dispatchSynchronously(job))
+        return;
+
     ResourceHandleInternal* handle = job->getInternal();
 
     // If defersLoading is true and we call curl_easy_perform
@@ -992,18 +1269,28 @@ void ResourceHandleManager::dispatchSynchronousJob(ResourceHandle* job)
     handle->m_defersLoading = false;
 
     initializeHandle(job);
+    CurlRecordReplay::singleton().willStart(job);
+
+    double timeout = wk_sync_timeout;
+    const double requestTimeout = job->firstRequest().timeoutInterval();
+    if (requestTimeout > 0 && requestTimeout < ResourceRequest::defaultTimeoutInterval() && (!timeout || requestTimeout < timeout))
+        timeout = requestTimeout;
+    if (timeout)
+        curl_easy_setopt(handle->m_handle, CURLOPT_TIMEOUT_MS, static_cast<long>(timeout * 1000));
 
-    // curl_easy_perform blocks until the transfert is finished.
-    CURLcode ret =  curl_easy_perform(handle->m_handle);
+    CURLcode ret = performSynchronously(handle->m_handle);
+    updateConnectionStatistics(job);
 
     if (ret != CURLE_OK) {
         URL tmpurl(URL(), handle->m_url);
         ResourceError error(tmpurl.host(), ret, String(handle->m_url), String(curl_easy_strerror(ret)));
         error.setSSLErrors(handle->m_sslErrors);
         handle->client()->didFail(job, error);
+        CurlRecordReplay::singleton().didFail(job);
     } else {
         if (handle->client())
             handle->client()->didReceiveResponse(job, handle->m_response);
+        CurlRecordReplay::singleton().didFinishLoading(job);
     }
 
 #if ENABLE(WEB_TIMING)
@@ -1013,6 +1300,36 @@ void ResourceHandleManager::dispatchSynchronousJob(ResourceHandle* job)
     curl_easy_cleanup(handle->m_handle);
 }
 
+// Runs the transfer on a multi handle of its own, so that connections are
+// kept for the next synchronous load, and lets the embedder repaint while
+// waiting. The main multi handle isn't touched: its callbacks would run
+// other pages' loads while this one's script is on the stack.
+CURLcode ResourceHandleManager::performSynchronously(CURL* handle)
+{
+    CURLMcode ret = curl_multi_add_handle(m_synchronousMultiHandle, handle);
+    if (ret != CURLM_OK)
+        return curl_easy_perform(handle);
+
+    CURLcode result = CURLE_OK;
+    while (true) {
+        int runningHandles = 0;
+        curl_multi_perform(m_synchronousMultiHandle, &runningHandles);
+
+        int messagesInQueue;
+        CURLMsg* msg = curl_multi_info_read(m_synchronousMultiHandle, &messagesInQueue);
+        if (msg && msg->msg == CURLMSG_DONE) {
+            result = msg->data.result;
+            break;
+        }
+
+        curl_multi_wait(m_synchronousMultiHandle, 0, 0, synchronousWaitMilliseconds, 0);
+        fl_sync_wait();
+    }
+
+    curl_multi_remove_handle(m_synchronousMultiHandle, handle);
+    return result;
+}
+
 void ResourceHandleManager::startJob(ResourceHandle* job)
 {
     URL url = job->firstRequest().url();
@@ -1025,8 +1342,16 @@ void ResourceHandleManager::startJob(ResourceHandle* job)
 
     initializeHandle(job);
 
+    ResourceHandleInternal* d = job->getInternal();
+    curl_easy_setopt(d->m_handle, CURLOPT_ENCODING, CurlContentDecoder::acceptEncoding());
+    curl_easy_setopt(d->m_handle, CURLOPT_HTTP_CONTENT_DECODING, 0L);
+    d->m_decodesContent = true;
+    CurlRecordReplay::singleton().willStart(job);
+
     m_runningJobs++;
-    CURLMcode ret = curl_multi_add_handle(m_curlMultiHandle, job->getInternal()->m_handle);
+    if (!d->m_origin.isNull())
+        m_runningJobsPerOrigin.add(d->m_origin, 0).iterator->value++;
+    CURLMcode ret = curl_multi_add_handle(m_curlMultiHandle, d->m_handle);
     // don't call perform, because events must be async
     // timeout will occur and do curl_multi_perform
     if (ret && ret != CURLM_CALL_MULTI_PERFORM) {
@@ -1076,6 +1401,40 @@ void ResourceHandleManager::applyAuthenticationToRequest(ResourceHandle* handle,
     curl_easy_setopt(d->m_handle, CURLOPT_USERPWD, userpass.utf8().data());
 }
 
+// Whether curl may reuse a connection depends on these, so requests and
+// preconnects have to set them alike.
+void ResourceHandleManager::setConnectionOptions(CURL* handle, const URL& url)
+{
+    // Fifth handles certs differently; ignore CA checks.
+    curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 0);
+
+    curl_easy_setopt(handle, CURLOPT_SSL_VERIFYHOST, 2L);
+    curl_easy_setopt(handle, CURLOPT_SHARE, m_curlShareHandle);
+    curl_easy_setopt(handle, CURLOPT_DNS_CACHE_TIMEOUT, 60 * 5); // 5 minutes
+    curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, 30);
+
+#if LIBCURL_VERSION_NUM >= 0x072f00
+    // Negotiated over ALPN, plain http stays on 1.1. Wait for a connection
+    // being set up to the host rather than open another next to it.
+    if (m_http2Supported) {
+        curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+    }
+#endif
+
+    // Youtube requires an insecure SSL cipher that curl disables by default.
+    // Enable it only for those sites to stay secure.
+    if (url.host().endsWith("googlevideo.com") ||
+        url.host().endsWith("youtube.com"))
+        curl_easy_setopt(handle, CURLOPT_SSL_CIPHER_LIST, "DEFAULT");
+
+    // Set proxy options if we have them.
+    if (m_proxy.length()) {
+        curl_easy_setopt(handle, CURLOPT_PROXY, m_proxy.utf8().data());
+        curl_easy_setopt(handle, CURLOPT_PROXYTYPE, m_proxyType);
+    }
+}
+
 void ResourceHandleManager::initializeHandle(ResourceHandle* job)
 {
     static const int allowedProtocols = CURLPROTO_FILE | CURLPROTO_FTP | CURLPROTO_FTPS | CURLPROTO_HTTP | CURLPROTO_HTTPS;
@@ -1114,10 +1473,9 @@ void ResourceHandleManager::initializeHandle(ResourceHandle* job)
         curl_easy_setopt(d->m_handle, CURLOPT_STDERR, m_logFile);
 #endif
 
-    // Fifth handles certs differently; ignore CA checks.
-    curl_easy_setopt(d->m_handle, CURLOPT_SSL_VERIFYPEER, 0);
+    setConnectionOptions(d->m_handle, url);
+    setStreamWeight(d->m_handle, job->firstRequest().priority());
 
-    curl_easy_setopt(d->m_handle, CURLOPT_SSL_VERIFYHOST, 2L);
     curl_easy_setopt(d->m_handle, CURLOPT_PRIVATE, job);
     curl_easy_setopt(d->m_handle, CURLOPT_ERRORBUFFER, m_curlErrorBuffer);
     curl_easy_setopt(d->m_handle, CURLOPT_WRITEFUNCTION, writeCallback);
@@ -1128,21 +1486,13 @@ void ResourceHandleManager::initializeHandle(ResourceHandle* job)
     curl_easy_setopt(d->m_handle, CURLOPT_FOLLOWLOCATION, 1);
     curl_easy_setopt(d->m_handle, CURLOPT_MAXREDIRS, 10);
     curl_easy_setopt(d->m_handle, CURLOPT_HTTPAUTH, CURLAUTH_ANY);
-    curl_easy_setopt(d->m_handle, CURLOPT_SHARE, m_curlShareHandle);
-    curl_easy_setopt(d->m_handle, CURLOPT_DNS_CACHE_TIMEOUT, 60 * 5); // 5 minutes
     curl_easy_setopt(d->m_handle, CURLOPT_PROTOCOLS, allowedProtocols);
     curl_easy_setopt(d->m_handle, CURLOPT_REDIR_PROTOCOLS, allowedProtocols);
-    curl_easy_setopt(d->m_handle, CURLOPT_CONNECTTIMEOUT, 30);
-
-    // Youtube requires an insecure SSL cipher that curl disables by default.
-    // Enable it only for those sites to stay secure.
-    if (url.host().endsWith("googlevideo.com") ||
-        url.host().endsWith("youtube.com"))
-        curl_easy_setopt(d->m_handle, CURLOPT_SSL_CIPHER_LIST, "DEFAULT");
 
     setSSLVerifyOptions(job);
 
-    // enable gzip and deflate through Accept-Encoding:
+    // Advertise and decode every encoding curl was built with. Loads not
+    // started synchronously decode on a thread instead, see startJob.
     curl_easy_setopt(d->m_handle, CURLOPT_ENCODING, "");
 
     // url must remain valid through the request
@@ -1160,7 +1510,8 @@ void ResourceHandleManager::initializeHandle(ResourceHandle* job)
         HTTPHeaderMap customHeaders = job->firstRequest().httpHeaderFields();
 
         bool hasCacheHeaders = customHeaders.contains(HTTPHeaderName::IfModifiedSince) || customHeaders.contains(HTTPHeaderName::IfNoneMatch);
-        if (!hasCacheHeaders && CurlCacheManager::getInstance().isCached(url)) {
+        // A recording needs the whole responses, not the cache's
+        if (!hasCacheHeaders && !CurlRecordReplay::singleton().isRecording() && CurlCacheManager::getInstance().isCached(url)) {
             CurlCacheManager::getInstance().addCacheEntryClient(url, job);
             HTTPHeaderMap& requestHeaders = CurlCacheManager::getInstance().requestHeaders(url);
 
@@ -1195,9 +1546,6 @@ void ResourceHandleManager::initializeHandle(ResourceHandle* job)
         String str = "Accept: ";
         str.append(spoofedAccept(url.host().utf8().data()));
         headers = curl_slist_append(headers, str.latin1().data());
-
-        str = "Accept-encoding: gzip, deflate";
-        headers = curl_slist_append(headers, str.latin1().data());
     }
 
     if (spoofedLanguage) {
@@ -1226,12 +1574,6 @@ void ResourceHandleManager::initializeHandle(ResourceHandle* job)
     }
 
     applyAuthenticationToRequest(job, job->firstRequest());
-
-    // Set proxy options if we have them.
-    if (m_proxy.length()) {
-        curl_easy_setopt(d->m_handle, CURLOPT_PROXY, m_proxy.utf8().data());
-        curl_easy_setopt(d->m_handle, CURLOPT_PROXYTYPE, m_proxyType);
-    }
 #if ENABLE(WEB_TIMING)
     curl_easy_setopt(d->m_handle, CURLOPT_SOCKOPTFUNCTION, sockoptfunction);
     curl_easy_setopt(d->m_handle, CURLOPT_SOCKOPTDATA, job);
@@ -1261,8 +1603,37 @@ void ResourceHandleManager::initCookieSession()
     curl_easy_cleanup(curl);
 }
 
+void ResourceHandleManager::didReceiveDecodedData(ResourceHandle* job, PassRefPtr<SharedBuffer> buffer)
+{
+    didReceiveContent(job, buffer);
+}
+
+void ResourceHandleManager::didFinishDecoding(ResourceHandle* job)
+{
+    didFinishContent(job);
+}
+
+void ResourceHandleManager::didFailDecoding(ResourceHandle* job)
+{
+    ResourceHandleInternal* d = job->getInternal();
+
+    // Stops the transfer, if it's still running
+    cancel(job);
+
+    if (d->client()) {
+        const URL& url = job->firstRequest().url();
+        ResourceError error(url.host(), CURLE_BAD_CONTENT_ENCODING, url.string(), String(curl_easy_strerror(CURLE_BAD_CONTENT_ENCODING)));
+        d->client()->didFail(job, error);
+        CurlCacheManager::getInstance().didFail(*job);
+    }
+}
+
 void ResourceHandleManager::cancel(ResourceHandle* job)
 {
+    if (CurlRecordReplay::singleton().cancel(job))
+        return;
+
+    CurlRecordReplay::singleton().didFail(job);
     if (removeScheduledJob(job))
         return;
 
@@ -28,6 +28,7 @@
 #ifndef ResourceHandleManager_h
 #define ResourceHandleManager_h
 
+#include "DNS.h"
 #include "Frame.h"
 #include "Timer.h"
 #include "ResourceHandleClient.h"
@@ -38,12 +39,31 @@
 #endif
 
 #include <curl/curl.h>
+#include <memory>
+#include <wtf/HashMap.h>
+#include <wtf/HashSet.h>
 #include <wtf/Vector.h>
 #include <wtf/text/CString.h>
 #include <wtf/text/WTFString.h>
 
 namespace WebCore {
 
+// HTTP(S) transfers since startup, counted when they finish or fail.
+struct CurlConnectionStatistics {
+    uint64_t requests;
+    uint64_t newConnections;
+    // Transfers sent over an already open connection, including HTTP/2
+    // streams multiplexed over one.
+    uint64_t reusedConnections;
+    // Full or resumed from the shared session cache.
+    uint64_t tlsHandshakes;
+    uint64_t http2Requests;
+    // Connections opened ahead of requests. They count as new above.
+    uint64_t preconnects;
+    // Response bodies as curl passed them on, before any decoding.
+    uint64_t bytesReceived;
+};
+
 class ResourceHandleManager {
 public:
     enum ProxyType {
@@ -53,6 +73,12 @@ public:
         Socks5 = CURLPROXY_SOCKS5,
         Socks5Hostname = CURLPROXY_SOCKS5_HOSTNAME
     };
+    // Connections curl opens to one host, and requests the loader hands it
+    // per host. HTTP/2 hosts multiplex all of them over one connection, the
+    // rest wait in curl for a free one.
+    static const unsigned maxConnectionsPerHost = 6;
+    static const unsigned maxRequestsPerHost = 16;
+
     static ResourceHandleManager* sharedInstance();
     void add(ResourceHandle*);
     void cancel(ResourceHandle*);
@@ -73,6 +99,23 @@ public:
                       const String& username = "",
                       const String& password = "");
 
+    CurlConnectionStatistics connectionStatistics() const { return m_connectionStatistics; }
+
+    bool isUsingProxy() const;
+
+    // curl can't open a bare connection for later transfers to reuse, so
+    // this sends a no-op "OPTIONS *" to the URL's origin. Once per origin
+    // every few seconds, and hovered links only when enabled.
+    void preconnect(const URL&, PreconnectReason);
+    void setHoverPreconnectEnabled(bool enabled) { m_hoverPreconnectEnabled = enabled; }
+
+    void didChangePriority(ResourceHandle*, ResourceLoadPriority);
+
+    // CurlContentDecoder hands the decoded body back through these.
+    void didReceiveDecodedData(ResourceHandle*, PassRefPtr<SharedBuffer>);
+    void didFinishDecoding(ResourceHandle*);
+    void didFailDecoding(ResourceHandle*);
+
 private:
     ResourceHandleManager();
     ~ResourceHandleManager();
@@ -81,20 +124,39 @@ private:
     bool removeScheduledJob(ResourceHandle*);
     void startJob(ResourceHandle*);
     bool startScheduledJobs();
+    bool hasFreeConnection(ResourceHandle*) const;
+    CURLcode performSynchronously(CURL*);
     void applyAuthenticationToRequest(ResourceHandle*, ResourceRequest&);
 
     void initializeHandle(ResourceHandle*);
+    void setConnectionOptions(CURL*, const URL&);
+    bool countNewConnections(CURL*);
+    void updateConnectionStatistics(ResourceHandle*);
+    void finishPreconnect(CURL*);
 
     void initCookieSession();
 
     Timer m_downloadTimer;
     CURLM* m_curlMultiHandle;
+    CURLM* m_synchronousMultiHandle;
     CURLSH* m_curlShareHandle;
     char* m_cookieJarFileName;
     char m_curlErrorBuffer[CURL_ERROR_SIZE];
     Vector<ResourceHandle*> m_resourceHandleList;
     const CString m_certificatePath;
     int m_runningJobs;
+    HashMap<String, unsigned> m_runningJobsPerOrigin;
+    HashSet<String> m_http2Origins;
+    bool m_http2Supported;
+    CurlConnectionStatistics m_connectionStatistics;
+
+    struct Preconnect {
+        CString url;
+        CString host;
+    };
+    HashMap<CURL*, std::unique_ptr<Preconnect>> m_preconnects;
+    HashMap<String, double> m_lastPreconnectTime;
+    bool m_hoverPreconnectEnabled;
     
     String m_proxy;
     ProxyType m_proxyType;
@@ -34,8 +34,13 @@
 #include <openssl/pem.h>
 #include <openssl/ssl.h>
 #include <openssl/x509_vfy.h>
+#include <wtf/HashMap.h>
 #include <wtf/ListHashSet.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/Threading.h>
 #include <wtf/text/CString.h>
+#include <wtf/text/StringBuilder.h>
+#include <wtf/text/StringHash.h>
 
 int fl_check_cert(const String &str, const String &host);
 
@@ -115,31 +120,91 @@ static unsigned sslCertificateFlag(const unsigned& sslError)
 }
 
 // success of certificates extraction
-static bool pemData(X509_STORE_CTX* ctx, String &out)
+static bool pemData(X509* cert, String &out)
 {
-    STACK_OF(X509)* certs = X509_STORE_CTX_get1_chain(ctx);
-
-    X509* uCert = sk_X509_value(certs, 0);
     BIO* bio = BIO_new(BIO_s_mem());
-    int res = PEM_write_bio_X509(bio, uCert);
+    int res = PEM_write_bio_X509(bio, cert);
     if (!res) {
         BIO_free(bio);
         return false;
     }
 
-    unsigned char* certificateData;
+    char* certificateData;
     long length = BIO_get_mem_data(bio, &certificateData);
     if (length < 0) {
         BIO_free(bio);
         return false;
     }
 
-    certificateData[length] = '\0';
-    out = certificateData;
+    out = String(certificateData, length);
     BIO_free(bio);
+    return true;
+}
+
+// fl_check_cert's answers by host, certificate fingerprint and errors found,
+// so that repeat handshakes skip the PEM encoding and the embedder. Handshakes
+// happen on the loader, download and sync job threads alike.
+static const unsigned maxCachedDecisions = 256;
+
+static Mutex& decisionMutex()
+{
+    static NeverDestroyed<Mutex> mutex;
+    return mutex;
+}
+
+static HashMap<String, int>& decisions()
+{
+    static NeverDestroyed<HashMap<String, int>> map;
+    return map;
+}
 
+static int checkCertificate(X509_STORE_CTX* ctx, const String& host, unsigned errors)
+{
+    STACK_OF(X509)* certs = X509_STORE_CTX_get1_chain(ctx);
+    X509* cert = sk_X509_value(certs, 0);
+
+    String key;
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned digestLength;
+    if (X509_digest(cert, EVP_sha256(), digest, &digestLength)) {
+        StringBuilder builder;
+        builder.append(host);
+        builder.append('\n');
+        builder.append(digest, digestLength);
+        builder.append('\n');
+        builder.appendNumber(errors);
+        key = builder.toString();
+
+        MutexLocker lock(decisionMutex());
+        auto it = decisions().find(key);
+        if (it != decisions().end()) {
+            sk_X509_pop_free(certs, X509_free);
+            return it->value;
+        }
+    }
+
+    String certdata;
+    const bool encoded = pemData(cert, certdata);
     sk_X509_pop_free(certs, X509_free);
-    return true;
+    if (!encoded)
+        return 0;
+
+    const int decision = fl_check_cert(certdata, host);
+
+    if (!key.isNull()) {
+        MutexLocker lock(decisionMutex());
+        if (decisions().size() >= maxCachedDecisions)
+            decisions().clear();
+        decisions().set(key, decision);
+    }
+
+    return decision;
+}
+
+void clearCertificateDecisions()
+{
+    MutexLocker lock(decisionMutex());
+    decisions().clear();
 }
 
 static int certVerifyCallback(int ok, X509_STORE_CTX* ctx)
@@ -156,11 +221,7 @@ static int certVerifyCallback(int ok, X509_STORE_CTX* ctx)
 
     d->m_sslErrors = sslCertificateFlag(err);
 
-    String certdata;
-    if (!pemData(ctx, certdata))
-        return 0;
-
-    return fl_check_cert(certdata, host);
+    return checkCertificate(ctx, host, d->m_sslErrors);
 }
 
 static CURLcode sslctxfun(CURL* curl, void* sslctx, void* parm)
@@ -170,6 +231,22 @@ static CURLcode sslctxfun(CURL* curl, void* sslctx, void* parm)
     return CURLE_OK;
 }
 
+static int preconnectCertVerifyCallback(int, X509_STORE_CTX* ctx)
+{
+    SSL* ssl = reinterpret_cast<SSL*>(X509_STORE_CTX_get_ex_data(ctx, SSL_get_ex_data_X509_STORE_CTX_idx()));
+    SSL_CTX* sslctx = SSL_get_SSL_CTX(ssl);
+    const char* host = reinterpret_cast<const char*>(SSL_CTX_get_app_data(sslctx));
+
+    return checkCertificate(ctx, host, sslCertificateFlag(X509_STORE_CTX_get_error(ctx)));
+}
+
+static CURLcode preconnectSSLCtxFun(CURL*, void* sslctx, void* parm)
+{
+    SSL_CTX_set_app_data(reinterpret_cast<SSL_CTX*>(sslctx), parm);
+    SSL_CTX_set_verify(reinterpret_cast<SSL_CTX*>(sslctx), SSL_VERIFY_PEER, preconnectCertVerifyCallback);
+    return CURLE_OK;
+}
+
 void setSSLVerifyOptions(ResourceHandle* handle)
 {
     ResourceHandleInternal* d = handle->getInternal();
@@ -177,6 +254,12 @@ void setSSLVerifyOptions(ResourceHandle* handle)
     curl_easy_setopt(d->m_handle, CURLOPT_SSL_CTX_FUNCTION, sslctxfun);
 }
 
+void setSSLVerifyOptions(CURL* handle, const char* host)
+{
+    curl_easy_setopt(handle, CURLOPT_SSL_CTX_DATA, host);
+    curl_easy_setopt(handle, CURLOPT_SSL_CTX_FUNCTION, preconnectSSLCtxFun);
+}
+
 }
 
 #endif
@@ -28,6 +28,8 @@
 
 #include "ResourceHandle.h"
 
+#include <curl/curl.h>
+
 #include <wtf/text/WTFString.h>
 
 namespace WebCore {
@@ -43,6 +45,12 @@ typedef enum {
 } SSLCertificateFlags;
 
 void setSSLVerifyOptions(ResourceHandle*);
+// For connections opened ahead of any request. The host must outlive the
+// handshake.
+void setSSLVerifyOptions(CURL*, const char* host);
+
+// Certificate decisions are cached, drop them when the embedder's check changes.
+void clearCertificateDecisions();
 
 }
 
@@ -66,6 +66,10 @@ void prefetchDNS(const String& hostname)
     DNSResolveQueue::singleton().add(hostname);
 }
 
+void preconnectTo(const URL&, PreconnectReason)
+{
+}
+
 }
 
 #endif
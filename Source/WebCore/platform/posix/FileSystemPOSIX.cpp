@@ -71,6 +71,20 @@ bool deleteFile(const String& path)
     return !unlink(fsRep.data());
 }
 
+#if !PLATFORM(COCOA)
+bool moveFile(const String& oldPath, const String& newPath)
+{
+    CString oldFsRep = fileSystemRepresentation(oldPath);
+    CString newFsRep = fileSystemRepresentation(newPath);
+
+    if (oldFsRep.isNull() || newFsRep.isNull())
+        return false;
+
+    // Replaces newPath atomically if it exists
+    return !rename(oldFsRep.data(), newFsRep.data());
+}
+#endif
+
 PlatformFileHandle openFile(const String& path, FileOpenMode mode)
 {
     CString fsRep = fileSystemRepresentation(path);
@@ -170,6 +170,13 @@ bool deleteFile(const String& path)
     return !!DeleteFileW(filename.charactersWithNullTermination().data());
 }
 
+bool moveFile(const String& oldPath, const String& newPath)
+{
+    String oldFilename = oldPath;
+    String newFilename = newPath;
+    return !!MoveFileExW(oldFilename.charactersWithNullTermination().data(), newFilename.charactersWithNullTermination().data(), MOVEFILE_REPLACE_EXISTING);
+}
+
 bool deleteEmptyDirectory(const String& path)
 {
     String filename = path;
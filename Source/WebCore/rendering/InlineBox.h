@@ -21,6 +21,7 @@
 #ifndef InlineBox_h
 #define InlineBox_h
 
+#include "RenderArena.h"
 #include "RenderBoxModelObject.h"
 #include "RenderText.h"
 #include "TextFlags.h"
@@ -35,7 +36,7 @@ class RootInlineBox;
 // InlineBox represents a rectangle that occurs on a line.  It corresponds to
 // some RenderObject (i.e., it represents a portion of that RenderObject).
 class InlineBox {
-    WTF_MAKE_FAST_ALLOCATED;
+    MAKE_RENDER_ARENA_ALLOCATED;
 public:
     virtual ~InlineBox();
 
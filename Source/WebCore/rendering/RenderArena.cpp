@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2015 Lauri Kasanen
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "RenderArena.h"
+
+#include <string.h>
+#include <wtf/MainThread.h>
+#include <wtf/StdLibExtras.h>
+
+namespace WebCore {
+
+static const size_t minChunkSize = 4 * KB;
+static const size_t maxChunkSize = 64 * KB;
+
+RenderArena* RenderArena::s_current;
+RenderArenaStatistics RenderArena::s_statistics;
+
+RenderArena::RenderArena()
+    : m_cursor(nullptr)
+    , m_end(nullptr)
+    , m_chunks(nullptr)
+    , m_nextChunkSize(minChunkSize)
+    , m_chunkBytes(0)
+    , m_objectCount(0)
+{
+    memset(m_freeLists, 0, sizeof(m_freeLists));
+    ++s_statistics.arenaCount;
+}
+
+RenderArena::~RenderArena()
+{
+    ASSERT(!m_objectCount);
+
+    while (Chunk* chunk = m_chunks) {
+        m_chunks = chunk->next;
+        fastFree(chunk);
+    }
+    s_statistics.chunkBytes -= m_chunkBytes;
+    --s_statistics.arenaCount;
+}
+
+void* RenderArena::allocate(size_t size)
+{
+    size_t allocationSize = WTF::roundUpToMultipleOf<allocationGranule>(size + sizeof(RenderArena*));
+    bool mainThread = isMainThread();
+    RenderArena* arena = mainThread && allocationSize <= maxAllocationSize ? s_current : nullptr;
+
+    RenderArena** header;
+    if (arena)
+        header = static_cast<RenderArena**>(arena->allocateInArena(allocationSize));
+    else {
+        header = static_cast<RenderArena**>(fastMalloc(size + sizeof(RenderArena*)));
+        if (mainThread)
+            ++s_statistics.mallocAllocations;
+    }
+
+    *header = arena;
+    return header + 1;
+}
+
+void RenderArena::free(void* p, size_t size)
+{
+    if (!p)
+        return;
+
+    RenderArena** header = static_cast<RenderArena**>(p) - 1;
+    RenderArena* arena = *header;
+    if (!arena) {
+        fastFree(header);
+        return;
+    }
+
+    ASSERT(isMainThread());
+    arena->freeInArena(header, WTF::roundUpToMultipleOf<allocationGranule>(size + sizeof(RenderArena*)));
+}
+
+inline void* RenderArena::allocateInArena(size_t allocationSize)
+{
+    ASSERT(allocationSize <= maxAllocationSize);
+
+    // Objects keep the arena alive after the document has let go of it.
+    if (!m_objectCount++)
+        ref();
+
+    ++s_statistics.arenaAllocations;
+    s_statistics.liveBytes += allocationSize;
+
+    FreeObject*& freeList = m_freeLists[allocationSize / allocationGranule];
+    if (FreeObject* object = freeList) {
+        freeList = object->next;
+        ++s_statistics.freeListAllocations;
+        return object;
+    }
+
+    if (static_cast<size_t>(m_end - m_cursor) < allocationSize)
+        allocateChunk(allocationSize);
+
+    void* result = m_cursor;
+    m_cursor += allocationSize;
+    return result;
+}
+
+inline void RenderArena::freeInArena(void* p, size_t allocationSize)
+{
+    ASSERT(allocationSize <= maxAllocationSize);
+    ASSERT(m_objectCount);
+
+    FreeObject* object = static_cast<FreeObject*>(p);
+    FreeObject*& freeList = m_freeLists[allocationSize / allocationGranule];
+    object->next = freeList;
+    freeList = object;
+
+    s_statistics.liveBytes -= allocationSize;
+
+    if (!--m_objectCount)
+        deref();
+}
+
+void RenderArena::allocateChunk(size_t allocationSize)
+{
+    // The rest of the current chunk is too small for this object, but may fit a smaller one.
+    size_t remaining = m_end - m_cursor;
+    if (remaining >= 2 * allocationGranule) {
+        FreeObject* object = reinterpret_cast<FreeObject*>(m_cursor);
+        FreeObject*& freeList = m_freeLists[remaining / allocationGranule];
+        object->next = freeList;
+        freeList = object;
+    }
+
+    // Small documents stay small, big ones make fewer, bigger chunks.
+    size_t chunkSize = std::max(m_nextChunkSize, sizeof(Chunk) + allocationSize);
+    m_nextChunkSize = std::min(m_nextChunkSize * 2, maxChunkSize);
+
+    Chunk* chunk = static_cast<Chunk*>(fastMalloc(chunkSize));
+    chunk->next = m_chunks;
+    m_chunks = chunk;
+
+    m_cursor = reinterpret_cast<char*>(chunk + 1);
+    m_end = reinterpret_cast<char*>(chunk) + chunkSize;
+
+    m_chunkBytes += chunkSize;
+    ++s_statistics.chunkAllocations;
+    s_statistics.chunkBytes += chunkSize;
+}
+
+RenderArenaScope::RenderArenaScope(RenderArena* arena)
+    : m_arena(arena)
+    , m_previous(RenderArena::s_current)
+{
+    ASSERT(isMainThread());
+    RenderArena::s_current = arena;
+}
+
+RenderArenaScope::~RenderArenaScope()
+{
+    RenderArena::s_current = m_previous;
+}
+
+} // namespace WebCore
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2015 Lauri Kasanen
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RenderArena_h
+#define RenderArena_h
+
+#include <wtf/FastMalloc.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Ref.h>
+#include <wtf/RefCounted.h>
+#include <wtf/RefPtr.h>
+
+namespace WebCore {
+
+struct RenderArenaStatistics {
+    uint64_t arenaAllocations; // Objects handed out by arenas.
+    uint64_t freeListAllocations; // Of those, the ones that reused a freed object.
+    uint64_t mallocAllocations; // Objects allocated outside any arena, or too big for one.
+    uint64_t chunkAllocations; // The arenas' own fastMalloc calls.
+    unsigned arenaCount; // Including arenas the document let go of, that still have objects.
+    size_t chunkBytes;
+    size_t liveBytes;
+};
+
+// A document's renderers, line boxes and style data are bump allocated from its arena,
+// with a free list per size class so freed objects get reused. Every object starts with
+// a pointer to the arena it came from, so it can be freed from anywhere.
+// The document lets go of its arena when the render tree is destroyed. The arena keeps
+// itself alive while it still has objects, and frees all its chunks at once after the last.
+class RenderArena : public RefCounted<RenderArena> {
+    WTF_MAKE_NONCOPYABLE(RenderArena); WTF_MAKE_FAST_ALLOCATED;
+public:
+    static Ref<RenderArena> create() { return adoptRef(*new RenderArena); }
+    ~RenderArena();
+
+    static void* allocate(size_t);
+    static void free(void*, size_t);
+
+    static RenderArenaStatistics statistics() { return s_statistics; }
+
+private:
+    friend class RenderArenaScope;
+
+    RenderArena();
+
+    void* allocateInArena(size_t);
+    void freeInArena(void*, size_t);
+    void allocateChunk(size_t);
+
+    struct FreeObject {
+        FreeObject* next;
+    };
+
+    struct Chunk {
+        Chunk* next;
+    };
+
+    static const size_t allocationGranule = 8;
+    static const size_t maxAllocationSize = 1024;
+
+    FreeObject* m_freeLists[maxAllocationSize / allocationGranule + 1];
+    char* m_cursor;
+    char* m_end;
+    Chunk* m_chunks;
+    size_t m_nextChunkSize;
+    size_t m_chunkBytes;
+    size_t m_objectCount;
+
+    static RenderArena* s_current;
+    static RenderArenaStatistics s_statistics;
+};
+
+// Objects allocated on the main thread while a scope is active come from its arena.
+// Style recalc and layout open one for their document. A null arena uses fastMalloc,
+// for objects that live longer than any document.
+class RenderArenaScope {
+    WTF_MAKE_NONCOPYABLE(RenderArenaScope);
+public:
+    explicit RenderArenaScope(RenderArena*);
+    ~RenderArenaScope();
+
+private:
+    RefPtr<RenderArena> m_arena;
+    RenderArena* m_previous;
+};
+
+} // namespace WebCore
+
+#define MAKE_RENDER_ARENA_ALLOCATED \
+public: \
+    void* operator new(size_t, void* p) { return p; } \
+    \
+    void* operator new(size_t size) \
+    { \
+        return ::WebCore::RenderArena::allocate(size); \
+    } \
+    \
+    void operator delete(void* p, size_t size) \
+    { \
+        ::WebCore::RenderArena::free(p, size); \
+    } \
+    \
+    void* operator new(size_t, NotNullTag, void* location) \
+    { \
+        ASSERT(location); \
+        return location; \
+    } \
+private: \
+typedef int __thisIsHereToForceASemicolonAfterThisMacro
+
+#endif // RenderArena_h
@@ -378,6 +378,11 @@ void RenderImage::paintReplaced(PaintInfo& paintInfo, const LayoutPoint& paintOf
 
     Page* page = frame().page();
 
+    // Images painted while they load have scrolled into view, so they go
+    // ahead of those further down the page.
+    if (paintInfo.phase == PaintPhaseForeground && cachedImage() && cachedImage()->isLoading() && cachedImage()->loadPriority() < ResourceLoadPriority::Medium)
+        cachedImage()->didChangePriority(ResourceLoadPriority::Medium);
+
     if (!imageResource().hasImage() || imageResource().errorOccurred()) {
         if (paintInfo.phase == PaintPhaseSelection)
             return;
@@ -94,6 +94,8 @@ Ref<RenderStyle> RenderStyle::create()
 
 Ref<RenderStyle> RenderStyle::createDefaultStyle()
 {
+    // The default style's data is shared by every style until modified.
+    RenderArenaScope noRenderArena(nullptr);
     return adoptRef(*new RenderStyle(true));
 }
 
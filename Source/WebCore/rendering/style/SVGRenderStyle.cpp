@@ -45,6 +45,7 @@ static const SVGRenderStyle& defaultSVGStyle()
 
 Ref<SVGRenderStyle> SVGRenderStyle::createDefaultStyle()
 {
+    RenderArenaScope noRenderArena(nullptr);
     return adoptRef(*new SVGRenderStyle(CreateDefault));
 }
 
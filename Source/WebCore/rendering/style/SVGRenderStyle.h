@@ -29,6 +29,7 @@
 #include "ExceptionCodePlaceholder.h"
 #include "GraphicsTypes.h"
 #include "Path.h"
+#include "RenderArena.h"
 #include "RenderStyleConstants.h"
 #include "SVGPaint.h"
 #include "SVGRenderStyleDefs.h"
@@ -40,6 +41,7 @@ class IntRect;
 class RenderObject;
 
 class SVGRenderStyle : public RefCounted<SVGRenderStyle> {    
+    MAKE_RENDER_ARENA_ALLOCATED;
 public:
     static Ref<SVGRenderStyle> createDefaultStyle();
     static Ref<SVGRenderStyle> create() { return adoptRef(*new SVGRenderStyle); }
@@ -30,6 +30,7 @@
 #define SVGRenderStyleDefs_h
 
 #include "Length.h"
+#include "RenderArena.h"
 #include "SVGLength.h"
 #include "SVGPaint.h"
 #include "ShadowData.h"
@@ -116,6 +117,7 @@ namespace WebCore {
 
     // Inherited/Non-Inherited Style Datastructures
     class StyleFillData : public RefCounted<StyleFillData> {
+        MAKE_RENDER_ARENA_ALLOCATED;
     public:
         static Ref<StyleFillData> create() { return adoptRef(*new StyleFillData); }
         Ref<StyleFillData> copy() const;
@@ -140,6 +142,7 @@ namespace WebCore {
     };
 
     class StyleStrokeData : public RefCounted<StyleStrokeData> {
+        MAKE_RENDER_ARENA_ALLOCATED;
     public:
         static Ref<StyleStrokeData> create() { return adoptRef(*new StyleStrokeData); }
         Ref<StyleStrokeData> copy() const;
@@ -170,6 +173,7 @@ namespace WebCore {
     };
 
     class StyleStopData : public RefCounted<StyleStopData> {
+        MAKE_RENDER_ARENA_ALLOCATED;
     public:
         static Ref<StyleStopData> create() { return adoptRef(*new StyleStopData); }
         Ref<StyleStopData> copy() const;
@@ -189,6 +193,7 @@ namespace WebCore {
     };
 
     class StyleTextData : public RefCounted<StyleTextData> {
+        MAKE_RENDER_ARENA_ALLOCATED;
     public:
         static Ref<StyleTextData> create() { return adoptRef(*new StyleTextData); }
         Ref<StyleTextData> copy() const;
@@ -208,6 +213,7 @@ namespace WebCore {
 
     // Note: the rule for this class is, *no inheritance* of these props
     class StyleMiscData : public RefCounted<StyleMiscData> {
+        MAKE_RENDER_ARENA_ALLOCATED;
     public:
         static Ref<StyleMiscData> create() { return adoptRef(*new StyleMiscData); }
         Ref<StyleMiscData> copy() const;
@@ -231,6 +237,7 @@ namespace WebCore {
     };
 
     class StyleShadowSVGData : public RefCounted<StyleShadowSVGData> {
+        MAKE_RENDER_ARENA_ALLOCATED;
     public:
         static Ref<StyleShadowSVGData> create() { return adoptRef(*new StyleShadowSVGData); }
         Ref<StyleShadowSVGData> copy() const;
@@ -250,6 +257,7 @@ namespace WebCore {
 
     // Non-inherited resources
     class StyleResourceData : public RefCounted<StyleResourceData> {
+        MAKE_RENDER_ARENA_ALLOCATED;
     public:
         static Ref<StyleResourceData> create() { return adoptRef(*new StyleResourceData); }
         Ref<StyleResourceData> copy() const;
@@ -271,6 +279,7 @@ namespace WebCore {
 
     // Inherited resources
     class StyleInheritedResourceData : public RefCounted<StyleInheritedResourceData> {
+        MAKE_RENDER_ARENA_ALLOCATED;
     public:
         static Ref<StyleInheritedResourceData> create() { return adoptRef(*new StyleInheritedResourceData); }
         Ref<StyleInheritedResourceData> copy() const;
@@ -292,6 +301,7 @@ namespace WebCore {
 
     // Positioning and sizing properties.
     class StyleLayoutData : public RefCounted<StyleLayoutData> {
+        MAKE_RENDER_ARENA_ALLOCATED;
     public:
         static Ref<StyleLayoutData> create() { return adoptRef(*new StyleLayoutData); }
         Ref<StyleLayoutData> copy() const;
@@ -28,12 +28,14 @@
 #include "Color.h"
 #include "FillLayer.h"
 #include "OutlineValue.h"
+#include "RenderArena.h"
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefCounted.h>
 
 namespace WebCore {
 
 class StyleBackgroundData : public RefCounted<StyleBackgroundData> {
+    MAKE_RENDER_ARENA_ALLOCATED;
 public:
     static Ref<StyleBackgroundData> create() { return adoptRef(*new StyleBackgroundData); }
     Ref<StyleBackgroundData> copy() const;
@@ -26,6 +26,7 @@
 #define StyleBoxData_h
 
 #include "Length.h"
+#include "RenderArena.h"
 #include "RenderStyleConstants.h"
 #include <wtf/RefCounted.h>
 #include <wtf/PassRefPtr.h>
@@ -33,6 +34,7 @@
 namespace WebCore {
 
 class StyleBoxData : public RefCounted<StyleBoxData> {
+    MAKE_RENDER_ARENA_ALLOCATED;
 public:
     static Ref<StyleBoxData> create() { return adoptRef(*new StyleBoxData); }
     Ref<StyleBoxData> copy() const;
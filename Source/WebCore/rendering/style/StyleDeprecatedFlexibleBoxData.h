@@ -25,12 +25,14 @@
 #ifndef StyleDeprecatedFlexibleBoxData_h
 #define StyleDeprecatedFlexibleBoxData_h
 
+#include "RenderArena.h"
 #include <wtf/RefCounted.h>
 #include <wtf/PassRefPtr.h>
 
 namespace WebCore {
 
 class StyleDeprecatedFlexibleBoxData : public RefCounted<StyleDeprecatedFlexibleBoxData> {
+    MAKE_RENDER_ARENA_ALLOCATED;
 public:
     static Ref<StyleDeprecatedFlexibleBoxData> create() { return adoptRef(*new StyleDeprecatedFlexibleBoxData); }
     Ref<StyleDeprecatedFlexibleBoxData> copy() const;
@@ -27,12 +27,14 @@
 #define StyleFilterData_h
 
 #include "FilterOperations.h"
+#include "RenderArena.h"
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefCounted.h>
 
 namespace WebCore {
 
 class StyleFilterData : public RefCounted<StyleFilterData> {
+    MAKE_RENDER_ARENA_ALLOCATED;
 public:
     static Ref<StyleFilterData> create() { return adoptRef(*new StyleFilterData); }
     Ref<StyleFilterData> copy() const;
@@ -27,6 +27,7 @@
 #define StyleFlexibleBoxData_h
 
 #include "Length.h"
+#include "RenderArena.h"
 
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefCounted.h>
@@ -34,6 +35,7 @@
 namespace WebCore {
 
 class StyleFlexibleBoxData : public RefCounted<StyleFlexibleBoxData> {
+    MAKE_RENDER_ARENA_ALLOCATED;
 public:
     static Ref<StyleFlexibleBoxData> create() { return adoptRef(*new StyleFlexibleBoxData); }
     Ref<StyleFlexibleBoxData> copy() const;
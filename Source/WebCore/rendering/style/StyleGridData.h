@@ -30,6 +30,7 @@
 
 #include "GridCoordinate.h"
 #include "GridTrackSize.h"
+#include "RenderArena.h"
 #include "RenderStyleConstants.h"
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefCounted.h>
@@ -42,6 +43,7 @@ typedef HashMap<String, Vector<unsigned>> NamedGridLinesMap;
 typedef HashMap<unsigned, Vector<String>, WTF::IntHash<unsigned>, WTF::UnsignedWithZeroKeyHashTraits<unsigned>> OrderedNamedGridLinesMap;
 
 class StyleGridData : public RefCounted<StyleGridData> {
+    MAKE_RENDER_ARENA_ALLOCATED;
 public:
     static Ref<StyleGridData> create() { return adoptRef(*new StyleGridData); }
     Ref<StyleGridData> copy() const;
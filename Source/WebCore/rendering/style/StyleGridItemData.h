@@ -34,6 +34,7 @@
 #if ENABLE(CSS_GRID_LAYOUT)
 
 #include "GridPosition.h"
+#include "RenderArena.h"
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefCounted.h>
 #include <wtf/Vector.h>
@@ -41,6 +42,7 @@
 namespace WebCore {
 
 class StyleGridItemData : public RefCounted<StyleGridItemData> {
+    MAKE_RENDER_ARENA_ALLOCATED;
 public:
     static Ref<StyleGridItemData> create() { return adoptRef(*new StyleGridItemData); }
     Ref<StyleGridItemData> copy() const;
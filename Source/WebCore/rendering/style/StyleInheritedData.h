@@ -28,6 +28,7 @@
 #include "Color.h"
 #include "FontCascade.h"
 #include "Length.h"
+#include "RenderArena.h"
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefCounted.h>
 #include <wtf/RefPtr.h>
@@ -35,6 +36,7 @@
 namespace WebCore {
 
 class StyleInheritedData : public RefCounted<StyleInheritedData> {
+    MAKE_RENDER_ARENA_ALLOCATED;
 public:
     static Ref<StyleInheritedData> create() { return adoptRef(*new StyleInheritedData); }
     Ref<StyleInheritedData> copy() const;
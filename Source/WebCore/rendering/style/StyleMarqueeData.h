@@ -26,6 +26,7 @@
 #define StyleMarqueeData_h
 
 #include "Length.h"
+#include "RenderArena.h"
 #include "RenderStyleConstants.h"
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefCounted.h>
@@ -33,6 +34,7 @@
 namespace WebCore {
 
 class StyleMarqueeData : public RefCounted<StyleMarqueeData> {
+    MAKE_RENDER_ARENA_ALLOCATED;
 public:
     static Ref<StyleMarqueeData> create() { return adoptRef(*new StyleMarqueeData); }
     Ref<StyleMarqueeData> copy() const;
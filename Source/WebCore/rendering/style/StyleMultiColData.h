@@ -27,6 +27,7 @@
 
 #include "BorderValue.h"
 #include "Length.h"
+#include "RenderArena.h"
 #include "RenderStyleConstants.h"
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefCounted.h>
@@ -36,6 +37,7 @@ namespace WebCore {
 // CSS3 Multi Column Layout
 
 class StyleMultiColData : public RefCounted<StyleMultiColData> {
+    MAKE_RENDER_ARENA_ALLOCATED;
 public:
     static Ref<StyleMultiColData> create() { return adoptRef(*new StyleMultiColData); }
     Ref<StyleMultiColData> copy() const;
@@ -32,6 +32,7 @@
 #include <wtf/text/AtomicString.h>
 
 #if ENABLE(IOS_TEXT_AUTOSIZING)
+#include "RenderArena.h"
 #include "TextSizeAdjustment.h"
 #endif
 
@@ -46,6 +47,7 @@ class StyleImage;
 // By grouping them together, we save space, and only allocate this object when someone
 // actually uses one of these properties.
 class StyleRareInheritedData : public RefCounted<StyleRareInheritedData> {
+    MAKE_RENDER_ARENA_ALLOCATED;
 public:
     static Ref<StyleRareInheritedData> create() { return adoptRef(*new StyleRareInheritedData); }
     Ref<StyleRareInheritedData> copy() const;
@@ -29,6 +29,7 @@
 #if ENABLE(CSS_SCROLL_SNAP)
 
 #include "LengthSize.h"
+#include "RenderArena.h"
 #include <wtf/RefCounted.h>
 #include <wtf/Vector.h>
 
@@ -49,6 +50,7 @@ inline bool operator!=(const ScrollSnapPoints& a, const ScrollSnapPoints& b) { r
 LengthSize defaultScrollSnapDestination();
 
 class StyleScrollSnapPoints : public RefCounted<StyleScrollSnapPoints> {
+    MAKE_RENDER_ARENA_ALLOCATED;
 public:
     static Ref<StyleScrollSnapPoints> create() { return adoptRef(*new StyleScrollSnapPoints); }
     Ref<StyleScrollSnapPoints> copy() const;
@@ -27,12 +27,14 @@
 
 #include "BorderData.h"
 #include "LengthBox.h"
+#include "RenderArena.h"
 #include <wtf/RefCounted.h>
 #include <wtf/PassRefPtr.h>
 
 namespace WebCore {
 
 class StyleSurroundData : public RefCounted<StyleSurroundData> {
+    MAKE_RENDER_ARENA_ALLOCATED;
 public:
     static Ref<StyleSurroundData> create() { return adoptRef(*new StyleSurroundData); }
     Ref<StyleSurroundData> copy() const;
@@ -26,6 +26,7 @@
 #define StyleTransformData_h
 
 #include "Length.h"
+#include "RenderArena.h"
 #include "TransformOperations.h"
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefCounted.h>
@@ -33,6 +34,7 @@
 namespace WebCore {
 
 class StyleTransformData : public RefCounted<StyleTransformData> {
+    MAKE_RENDER_ARENA_ALLOCATED;
 public:
     static Ref<StyleTransformData> create() { return adoptRef(*new StyleTransformData); }
     Ref<StyleTransformData> copy() const;
@@ -26,6 +26,7 @@
 #define StyleVisualData_h
 
 #include "LengthBox.h"
+#include "RenderArena.h"
 #include "RenderStyleConstants.h"
 #include <wtf/RefCounted.h>
 #include <wtf/PassRefPtr.h>
@@ -33,6 +34,7 @@
 namespace WebCore {
 
 class StyleVisualData : public RefCounted<StyleVisualData> {
+    MAKE_RENDER_ARENA_ALLOCATED;
 public:
     static Ref<StyleVisualData> create() { return adoptRef(*new StyleVisualData); }
     Ref<StyleVisualData> copy() const;
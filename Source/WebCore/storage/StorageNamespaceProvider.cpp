@@ -60,15 +60,19 @@ void StorageNamespaceProvider::removePage(Page& page)
 
 RefPtr<StorageArea> StorageNamespaceProvider::localStorageArea(Document& document)
 {
-#if PLATFORM(FLTK)
-    auto& storageNamespace = transientLocalStorageNamespace(*document.topOrigin());
-#else
-    auto& storageNamespace = document.securityOrigin()->canAccessLocalStorage(document.topOrigin()) ? localStorageNamespace() : transientLocalStorageNamespace(*document.topOrigin());
-#endif
+    auto& storageNamespace = hasPersistentLocalStorage() && document.securityOrigin()->canAccessLocalStorage(document.topOrigin()) ? localStorageNamespace() : transientLocalStorageNamespace(*document.topOrigin());
 
     return storageNamespace.storageArea(document.securityOrigin());
 }
 
+void StorageNamespaceProvider::prefetchLocalStorageArea(SecurityOrigin& securityOrigin)
+{
+    if (!hasPersistentLocalStorage() || !securityOrigin.canAccessLocalStorage(&securityOrigin))
+        return;
+
+    localStorageNamespace().storageArea(&securityOrigin);
+}
+
 StorageNamespace& StorageNamespaceProvider::localStorageNamespace()
 {
     if (!m_localStorageNamespace)
@@ -48,12 +48,20 @@ public:
     virtual RefPtr<StorageNamespace> createSessionStorageNamespace(Page&, unsigned quota) = 0;
     RefPtr<StorageArea> localStorageArea(Document&);
 
+    // Creates the persistent local StorageArea for the origin ahead of the first
+    // document access, so its import from disk can run while the page loads.
+    void prefetchLocalStorageArea(SecurityOrigin&);
+
     void addPage(Page&);
     void removePage(Page&);
 
 protected:
     StorageNamespace* optionalLocalStorageNamespace() { return m_localStorageNamespace.get(); }
 
+    // Ports that keep local storage in memory only return false, and get
+    // per top-level origin transient namespaces instead.
+    virtual bool hasPersistentLocalStorage() const { return true; }
+
 private:
     StorageNamespace& localStorageNamespace();
     StorageNamespace& transientLocalStorageNamespace(SecurityOrigin&);
@@ -35,7 +35,9 @@
 #include <WebCore/platform/sql/SQLiteStatement.h>
 #include <WebCore/platform/sql/SQLiteTransaction.h>
 #include <WebCore/platform/SuddenTermination.h>
+#include <wtf/CurrentTime.h>
 #include <wtf/MainThread.h>
+#include <wtf/NeverDestroyed.h>
 
 namespace WebCore {
 
@@ -47,6 +49,33 @@ static const double StorageSyncInterval = 1.0;
 // much harder to starve the rest of LocalStorage and the OS's IO subsystem in general.
 static const int MaxiumItemsToSync = 100;
 
+static Mutex& statisticsMutex()
+{
+    static NeverDestroyed<Mutex> mutex;
+    return mutex;
+}
+
+static StorageAreaSyncStatistics& mutableStatistics()
+{
+    static StorageAreaSyncStatistics statistics;
+    return statistics;
+}
+
+static void adjustSyncBacklog(int delta)
+{
+    if (!delta)
+        return;
+
+    MutexLocker locker(statisticsMutex());
+    mutableStatistics().syncBacklog += delta;
+}
+
+StorageAreaSyncStatistics StorageAreaSync::statistics()
+{
+    MutexLocker locker(statisticsMutex());
+    return mutableStatistics();
+}
+
 inline StorageAreaSync::StorageAreaSync(PassRefPtr<StorageSyncManager> storageSyncManager, PassRefPtr<StorageAreaImpl> storageArea, const String& databaseIdentifier)
     : m_syncTimer(*this, &StorageAreaSync::syncTimerFired)
     , m_itemsCleared(false)
@@ -115,7 +144,8 @@ void StorageAreaSync::scheduleItemForSync(const String& key, const String& value
     ASSERT(isMainThread());
     ASSERT(!m_finalSyncScheduled);
 
-    m_changedItems.set(key, value);
+    if (m_changedItems.set(key, value).isNewEntry)
+        adjustSyncBacklog(1);
     if (!m_syncTimer.isActive()) {
         m_syncTimer.startOneShot(StorageSyncInterval);
 
@@ -130,6 +160,7 @@ void StorageAreaSync::scheduleClear()
     ASSERT(isMainThread());
     ASSERT(!m_finalSyncScheduled);
 
+    adjustSyncBacklog(-static_cast<int>(m_changedItems.size()));
     m_changedItems.clear();
     m_itemsCleared = true;
     if (!m_syncTimer.isActive()) {
@@ -176,6 +207,8 @@ void StorageAreaSync::syncTimerFired()
             return;
         }
 
+        const int backlogBefore = m_changedItems.size() + m_itemsPendingSync.size();
+
         if (m_itemsCleared) {
             m_itemsPendingSync.clear();
             m_clearItemsWhileSyncing = true;
@@ -202,6 +235,10 @@ void StorageAreaSync::syncTimerFired()
                 m_changedItems.remove(pending_it->key);
         }
 
+        // Without a partial sync, m_changedItems is cleared below.
+        const int backlogAfter = (partialSync ? m_changedItems.size() : 0) + m_itemsPendingSync.size();
+        adjustSyncBacklog(backlogAfter - backlogBefore);
+
         if (!m_syncScheduled) {
             m_syncScheduled = true;
 
@@ -260,6 +297,10 @@ void StorageAreaSync::openDatabase(OpenDatabaseParamType openingStrategy)
         return;
     }
 
+    // SQLiteDatabase::open() puts the database in WAL mode, where a normal
+    // synchronous level is still safe against corruption and avoids an fsync per sync.
+    m_database.setSynchronous(SQLiteDatabase::SyncNormal);
+
     migrateItemTableIfNeeded();
 
     if (!m_database.executeCommand("CREATE TABLE IF NOT EXISTS ItemTable (key TEXT UNIQUE ON CONFLICT REPLACE, value BLOB NOT NULL ON CONFLICT FAIL)")) {
@@ -272,6 +313,40 @@ void StorageAreaSync::openDatabase(OpenDatabaseParamType openingStrategy)
     StorageTracker::tracker().setOriginDetails(m_databaseIdentifier, databaseFilename);
 }
 
+void StorageAreaSync::closeDatabase()
+{
+    ASSERT(!isMainThread());
+
+    m_insertStatement = nullptr;
+    m_removeStatement = nullptr;
+    m_database.close();
+}
+
+bool StorageAreaSync::prepareSyncStatements()
+{
+    ASSERT(!isMainThread());
+    ASSERT(m_database.isOpen());
+
+    if (m_insertStatement && m_removeStatement)
+        return true;
+
+    auto insert = std::make_unique<SQLiteStatement>(m_database, ASCIILiteral("INSERT INTO ItemTable VALUES (?, ?)"));
+    if (insert->prepare() != SQLITE_OK) {
+        LOG_ERROR("Failed to prepare insert statement - cannot write to local storage database");
+        return false;
+    }
+
+    auto remove = std::make_unique<SQLiteStatement>(m_database, ASCIILiteral("DELETE FROM ItemTable WHERE key=?"));
+    if (remove->prepare() != SQLITE_OK) {
+        LOG_ERROR("Failed to prepare delete statement - cannot write to local storage database");
+        return false;
+    }
+
+    m_insertStatement = WTF::move(insert);
+    m_removeStatement = WTF::move(remove);
+    return true;
+}
+
 void StorageAreaSync::migrateItemTableIfNeeded()
 {
     if (!m_database.tableExists("ItemTable"))
@@ -320,6 +395,8 @@ void StorageAreaSync::performImport()
     ASSERT(!isMainThread());
     ASSERT(!m_database.isOpen());
 
+    const double startTime = monotonicallyIncreasingTime();
+
     openDatabase(SkipIfNonExistent);
     if (!m_database.isOpen()) {
         markImported();
@@ -349,6 +426,15 @@ void StorageAreaSync::performImport()
 
     m_storageArea->importItems(itemMap);
 
+    const double importTime = monotonicallyIncreasingTime() - startTime;
+    {
+        MutexLocker locker(statisticsMutex());
+        StorageAreaSyncStatistics& statistics = mutableStatistics();
+        statistics.importCount++;
+        statistics.totalImportTime += importTime;
+        statistics.maxImportTime = std::max(statistics.maxImportTime, importTime);
+    }
+
     markImported();
 }
 
@@ -375,8 +461,14 @@ void StorageAreaSync::blockUntilImportComplete()
         return;
 
     MutexLocker locker(m_importLock);
-    while (!m_importComplete)
-        m_importCondition.wait(m_importLock);
+    if (!m_importComplete) {
+        const double startTime = monotonicallyIncreasingTime();
+        while (!m_importComplete)
+            m_importCondition.wait(m_importLock);
+
+        MutexLocker statisticsLocker(statisticsMutex());
+        mutableStatistics().blockedTime += monotonicallyIncreasingTime() - startTime;
+    }
     m_storageArea = 0;
 }
 
@@ -404,7 +496,7 @@ void StorageAreaSync::sync(bool clearItems, const HashMap<String, String>& items
     // to write new items created after the request to delete the db.
     if (m_syncCloseDatabase) {
         m_syncCloseDatabase = false;
-        m_database.close();
+        closeDatabase();
         return;
     }
     
@@ -425,17 +517,8 @@ void StorageAreaSync::sync(bool clearItems, const HashMap<String, String>& items
         }
     }
 
-    SQLiteStatement insert(m_database, "INSERT INTO ItemTable VALUES (?, ?)");
-    if (insert.prepare() != SQLITE_OK) {
-        LOG_ERROR("Failed to prepare insert statement - cannot write to local storage database");
-        return;
-    }
-
-    SQLiteStatement remove(m_database, "DELETE FROM ItemTable WHERE key=?");
-    if (remove.prepare() != SQLITE_OK) {
-        LOG_ERROR("Failed to prepare delete statement - cannot write to local storage database");
+    if (!prepareSyncStatements())
         return;
-    }
 
     HashMap<String, String>::const_iterator end = items.end();
 
@@ -443,7 +526,7 @@ void StorageAreaSync::sync(bool clearItems, const HashMap<String, String>& items
     transaction.begin();
     for (HashMap<String, String>::const_iterator it = items.begin(); it != end; ++it) {
         // Based on the null-ness of the second argument, decide whether this is an insert or a delete.
-        SQLiteStatement& query = it->value.isNull() ? remove : insert;
+        SQLiteStatement& query = it->value.isNull() ? *m_removeStatement : *m_insertStatement;
 
         query.bindText(1, it->key);
 
@@ -452,14 +535,17 @@ void StorageAreaSync::sync(bool clearItems, const HashMap<String, String>& items
             query.bindBlob(2, it->value);
 
         int result = query.step();
+        query.reset();
         if (result != SQLITE_DONE) {
             LOG_ERROR("Failed to update item in the local storage database - %i", result);
             break;
         }
-
-        query.reset();
     }
     transaction.commit();
+
+    MutexLocker locker(statisticsMutex());
+    mutableStatistics().syncCount++;
+    mutableStatistics().syncedItemCount += items.size();
 }
 
 void StorageAreaSync::performSync()
@@ -482,6 +568,7 @@ void StorageAreaSync::performSync()
     }
 
     sync(clearItems, items);
+    adjustSyncBacklog(-static_cast<int>(items.size()));
 
     {
         MutexLocker locker(m_syncLock);
@@ -514,7 +601,7 @@ void StorageAreaSync::deleteEmptyDatabase()
     int count = query.getColumnInt(0);
     if (!count) {
         query.finalize();
-        m_database.close();
+        closeDatabase();
         if (StorageTracker::tracker().isActive()) {
             StringImpl* databaseIdentifierCopy = &m_databaseIdentifier.impl()->isolatedCopy().leakRef();
             callOnMainThread([databaseIdentifierCopy] {
@@ -34,9 +34,24 @@
 namespace WebCore {
 
 class Frame;
+class SQLiteStatement;
 class StorageAreaImpl;
 class StorageSyncManager;
 
+// Process-wide counters, summed over all persistent local storage areas.
+struct StorageAreaSyncStatistics {
+    unsigned importCount;
+    double totalImportTime;
+    double maxImportTime;
+    // Time the main thread spent waiting for an import to finish.
+    double blockedTime;
+
+    // Changed items not yet written to disk.
+    unsigned syncBacklog;
+    unsigned syncCount;
+    unsigned syncedItemCount;
+};
+
 class StorageAreaSync : public ThreadSafeRefCounted<StorageAreaSync> {
 public:
     static Ref<StorageAreaSync> create(PassRefPtr<StorageSyncManager>, PassRefPtr<StorageAreaImpl>, const String& databaseIdentifier);
@@ -51,6 +66,8 @@ public:
 
     void scheduleSync();
 
+    static StorageAreaSyncStatistics statistics();
+
 private:
     StorageAreaSync(PassRefPtr<StorageSyncManager>, PassRefPtr<StorageAreaImpl>, const String& databaseIdentifier);
 
@@ -66,6 +83,10 @@ private:
     // The database handle will only ever be opened and used on the background thread.
     SQLiteDatabase m_database;
 
+    // Kept prepared across syncs, finalized before the database is closed.
+    std::unique_ptr<SQLiteStatement> m_insertStatement;
+    std::unique_ptr<SQLiteStatement> m_removeStatement;
+
     // The following members are subject to thread synchronization issues.
 public:
     // Called from the background thread
@@ -81,6 +102,8 @@ private:
 
     void syncTimerFired();
     void openDatabase(OpenDatabaseParamType openingStrategy);
+    void closeDatabase();
+    bool prepareSyncStatements();
     void sync(bool clearItems, const HashMap<String, String>& items);
 
     const String m_databaseIdentifier;
@@ -106,6 +106,16 @@ RefPtr<StorageNamespace> WebStorageNamespaceProvider::createLocalStorageNamespac
     return StorageNamespaceImpl::getOrCreateLocalStorageNamespace(m_localStorageDatabasePath, quota);
 }
 
+bool WebStorageNamespaceProvider::hasPersistentLocalStorage() const
+{
+#if PLATFORM(FLTK)
+    // Without a database directory, local storage stays private to each top-level origin.
+    return !m_localStorageDatabasePath.isEmpty();
+#else
+    return true;
+#endif
+}
+
 RefPtr<StorageNamespace> WebStorageNamespaceProvider::createTransientLocalStorageNamespace(SecurityOrigin&, unsigned quota)
 {
     // FIXME: A smarter implementation would create a special namespace type instead of just piggy-backing off
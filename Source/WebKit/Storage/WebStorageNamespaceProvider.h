@@ -48,6 +48,8 @@ private:
     virtual RefPtr<WebCore::StorageNamespace> createLocalStorageNamespace(unsigned quota) override;
     virtual RefPtr<WebCore::StorageNamespace> createTransientLocalStorageNamespace(WebCore::SecurityOrigin&, unsigned quota) override;
 
+    virtual bool hasPersistentLocalStorage() const override;
+
     const String m_localStorageDatabasePath;
 };
 
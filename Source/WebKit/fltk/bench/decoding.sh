@@ -0,0 +1,81 @@
+#!/bin/sh
+# Checks that a gzip-encoded 401 body reaches the page decoded. A
+# cross-origin XHR without credentials continues past the authentication
+# challenge, so it gets the 401's own body.
+# Usage: decoding.sh [path to webkitbench]
+
+bench=${1:-./webkitbench}
+dir=$(mktemp -d)
+trap 'kill $server 2>/dev/null; rm -rf "$dir"' EXIT
+
+python3 - "$dir" <<'EOF' &
+import gzip, http.server, os, sys, threading
+
+dir = sys.argv[1]
+body = b"decoded 401 body"
+reported = threading.Event()
+
+class handler(http.server.BaseHTTPRequestHandler):
+    def log_message(self, *args):
+        pass
+
+    def send(self, code, data, headers={}):
+        self.send_response(code)
+        for k, v in headers.items():
+            self.send_header(k, v)
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def do_GET(self):
+        port = self.server.server_address[1]
+        if self.path == "/":
+            page = """<script>
+var x = new XMLHttpRequest();
+x.onloadend = function() {
+    var r = new XMLHttpRequest();
+    r.open("GET", "/result?" + encodeURIComponent(x.status + " " + x.responseText));
+    r.send();
+};
+x.open("GET", "http://localhost:%d/auth");
+x.send();
+</script>
+<script src="/wait"></script>""" % port
+            self.send(200, page.encode(), {"Content-Type": "text/html"})
+        elif self.path == "/auth":
+            self.send(401, gzip.compress(body), {
+                "Content-Type": "text/plain",
+                "Content-Encoding": "gzip",
+                "WWW-Authenticate": 'Basic realm="decoding"',
+                "Access-Control-Allow-Origin": "*"})
+        elif self.path == "/wait":
+            # Holds the page's load event until the XHR has reported
+            reported.wait(10)
+            self.send(200, b"", {"Content-Type": "text/javascript"})
+        elif self.path.startswith("/result?"):
+            with open(os.path.join(dir, "result"), "w") as f:
+                f.write(self.path[8:])
+            reported.set()
+            self.send(200, b"")
+        else:
+            self.send(404, b"")
+
+server = http.server.ThreadingHTTPServer(("127.0.0.1", 0), handler)
+with open(os.path.join(dir, "port"), "w") as f:
+    f.write(str(server.server_address[1]))
+server.serve_forever()
+EOF
+server=$!
+
+while [ ! -s "$dir/port" ]; do sleep 0.1; done
+
+timeout 30 "$bench" "http://127.0.0.1:$(cat "$dir/port")/" > /dev/null
+
+expected="401%20decoded%20401%20body"
+result=$(cat "$dir/result" 2>/dev/null)
+if [ "$result" = "$expected" ]; then
+	echo "PASS"
+else
+	echo "FAIL: got '$result', expected '$expected'"
+	exit 1
+fi
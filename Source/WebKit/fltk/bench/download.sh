@@ -0,0 +1,79 @@
+#!/bin/sh
+# Checks a segmented download from a server that answers a range request
+# with the whole file. The download fails, and its resume has to start
+# over with one transfer, so the result must match the file exactly.
+# Usage: download.sh [path to webkitbench]
+
+bench=${1:-./webkitbench}
+dir=$(mktemp -d)
+trap 'kill $server 2>/dev/null; rm -rf "$dir"' EXIT
+
+python3 - "$dir" <<'EOF' &
+import http.server, os, random, sys, threading, time
+
+dir = sys.argv[1]
+# Large enough to be split into segments
+data = random.Random(1).randbytes(6 * 1024 * 1024)
+with open(os.path.join(dir, "expected"), "wb") as f:
+    f.write(data)
+
+ignored = threading.Lock()
+ignoredrange = [False]
+
+class handler(http.server.BaseHTTPRequestHandler):
+    def log_message(self, *args):
+        pass
+
+    def do_GET(self):
+        start, end = 0, len(data) - 1
+        partial = False
+        r = self.headers.get("Range")
+        if r and r.startswith("bytes="):
+            first, last = r[6:].split("-")
+            start = int(first)
+            if last:
+                end = int(last)
+            partial = True
+
+        # Ignore the first range past the start, late enough that the first
+        # segment has finished by then
+        if partial and start > 0:
+            with ignored:
+                ignore = not ignoredrange[0]
+                ignoredrange[0] = True
+            if ignore:
+                time.sleep(1)
+                start, end = 0, len(data) - 1
+                partial = False
+
+        self.send_response(206 if partial else 200)
+        self.send_header("Accept-Ranges", "bytes")
+        self.send_header("Content-Length", str(end - start + 1))
+        if partial:
+            self.send_header("Content-Range", "bytes %d-%d/%d" % (start, end, len(data)))
+        self.end_headers()
+        try:
+            self.wfile.write(data[start:end + 1])
+        except OSError:
+            pass
+
+server = http.server.ThreadingHTTPServer(("127.0.0.1", 0), handler)
+with open(os.path.join(dir, "port"), "w") as f:
+    f.write(str(server.server_address[1]))
+server.serve_forever()
+EOF
+server=$!
+
+while [ ! -s "$dir/port" ]; do sleep 0.1; done
+
+if ! timeout 60 "$bench" -d "$dir/file" "http://127.0.0.1:$(cat "$dir/port")/file"; then
+	echo "FAIL: the download didn't complete"
+	exit 1
+fi
+
+if cmp -s "$dir/expected" "$dir/file"; then
+	echo "PASS"
+else
+	echo "FAIL: the downloaded file differs"
+	exit 1
+fi
@@ -0,0 +1,40 @@
+/*
+	(C) Lauri Kasanen
+	Under the GPLv3.
+
+	Runs a download for webkitbench -d, outside of any view, so that
+	scripts can check the file it writes.
+*/
+
+#include "config.h"
+
+#include "downloadcheck.h"
+#include "download.h"
+
+#include <FL/Fl.H>
+#include <stdio.h>
+
+bool downloadTo(const char *url, const char *file) {
+
+	download d(url, file);
+
+	unsigned resumes = 0;
+	while (!d.isFinished()) {
+		if (d.isFailed()) {
+			if (resumes == 3)
+				break;
+			resumes++;
+			d.resume();
+			continue;
+		}
+		Fl::wait(0.05);
+	}
+
+	time_t start;
+	long long size, received;
+	d.getStats(&start, &size, &received);
+	printf("Downloaded %lld of %lld bytes, resumed %u times\n",
+		received, size, resumes);
+
+	return d.isFinished();
+}
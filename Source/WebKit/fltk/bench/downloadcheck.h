@@ -0,0 +1,13 @@
+/*
+	(C) Lauri Kasanen
+	Under the GPLv3.
+*/
+
+#ifndef downloadcheck_h
+#define downloadcheck_h
+
+// Downloads the url to the file, resuming it up to three times if it
+// fails. Returns whether the download completed.
+bool downloadTo(const char *url, const char *file);
+
+#endif
@@ -0,0 +1,14 @@
+#!/bin/sh
+# Runs the filter primitive benchmark at several sizes.
+# Usage: filters.sh [path to webkitbench]
+
+bench=${1:-./webkitbench}
+page="file://$(cd "$(dirname "$0")" && pwd)/filters.html"
+
+for primitive in colormatrix saturate huerotate componenttransfer \
+	composite displacementmap morphology blur; do
+	for size in 256 512 1024; do
+		echo "$primitive ${size}x$size"
+		"$bench" -p "$page?primitive=$primitive&size=$size"
+	done
+done
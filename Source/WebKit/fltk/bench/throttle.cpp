@@ -0,0 +1,238 @@
+/*
+	(C) Lauri Kasanen
+	Under the GPLv3.
+
+	A proxy for webkitbench that limits the bandwidth of page loads. HTTPS
+	is tunneled with CONNECT, plain HTTP is forwarded to the host named in
+	the request. Only the responses are throttled.
+*/
+
+#include "throttle.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+static unsigned rate;
+static double nextfree;
+static pthread_mutex_t ratelock = PTHREAD_MUTEX_INITIALIZER;
+
+static double now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Books len bytes on the shared link, and waits for their turn.
+static void throttle(const size_t len) {
+
+	pthread_mutex_lock(&ratelock);
+	const double t = now();
+	if (nextfree < t)
+		nextfree = t;
+	const double wait = nextfree - t;
+	nextfree += len / (double) rate;
+	pthread_mutex_unlock(&ratelock);
+
+	if (wait > 0)
+		usleep(wait * 1000000);
+}
+
+static bool writeall(const int fd, const char *buf, size_t len) {
+
+	while (len) {
+		const ssize_t sent = write(fd, buf, len);
+		if (sent <= 0)
+			return false;
+		buf += sent;
+		len -= sent;
+	}
+	return true;
+}
+
+static int connectto(const char *host, const char *port) {
+
+	struct addrinfo hints, *res;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	if (getaddrinfo(host, port, &hints, &res))
+		return -1;
+
+	int fd = -1;
+	for (struct addrinfo *ai = res; ai; ai = ai->ai_next) {
+		fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+		if (fd < 0)
+			continue;
+		if (!connect(fd, ai->ai_addr, ai->ai_addrlen))
+			break;
+		close(fd);
+		fd = -1;
+	}
+
+	freeaddrinfo(res);
+	return fd;
+}
+
+// The request goes out with "Connection: close", so that curl doesn't send
+// its next request, maybe for another host, down the same tunnel.
+static size_t rewritehead(const char *head, const size_t headlen, char *out) {
+
+	const char *line = head;
+	const char *end = head + headlen;
+	size_t len = 0;
+	bool first = true;
+
+	while (line < end) {
+		const char *eol = (const char *) memmem(line, end - line, "\r\n", 2);
+		eol = eol ? eol + 2 : end;
+
+		if (strncasecmp(line, "Connection:", 11) &&
+			strncasecmp(line, "Proxy-Connection:", 17)) {
+			memcpy(out + len, line, eol - line);
+			len += eol - line;
+		}
+		if (first) {
+			memcpy(out + len, "Connection: close\r\n", 19);
+			len += 19;
+			first = false;
+		}
+		line = eol;
+	}
+
+	return len;
+}
+
+static void *serve(void *arg) {
+
+	const int client = (intptr_t) arg;
+	int server = -1;
+	char buf[16384];
+	char out[sizeof(buf) + 32];
+	size_t len = 0;
+	const char *headend = NULL;
+
+	while (!headend && len < sizeof(buf) - 1) {
+		const ssize_t got = read(client, buf + len, sizeof(buf) - 1 - len);
+		if (got <= 0)
+			goto done;
+		len += got;
+		buf[len] = '\0';
+		headend = strstr(buf, "\r\n\r\n");
+	}
+	if (!headend)
+		goto done;
+	headend += 4;
+
+	char method[16], target[2048], host[1024], port[8];
+	if (sscanf(buf, "%15s %2047s", method, target) != 2)
+		goto done;
+
+	strcpy(port, "80");
+	if (!strcmp(method, "CONNECT")) {
+		if (sscanf(target, "%1023[^:]:%7s", host, port) != 2)
+			goto done;
+	} else if (sscanf(target, "http://%1023[^:/]:%7[0-9]", host, port) < 1) {
+		goto done;
+	}
+
+	server = connectto(host, port);
+	if (server < 0)
+		goto done;
+
+	if (!strcmp(method, "CONNECT")) {
+		static const char ok[] = "HTTP/1.1 200 Connection established\r\n\r\n";
+		if (!writeall(client, ok, sizeof(ok) - 1) ||
+			!writeall(server, headend, buf + len - headend))
+			goto done;
+	} else {
+		const size_t headlen = rewritehead(buf, headend - buf, out);
+		if (!writeall(server, out, headlen) ||
+			!writeall(server, headend, buf + len - headend))
+			goto done;
+	}
+
+	struct pollfd fds[2];
+	fds[0].fd = client;
+	fds[1].fd = server;
+	fds[0].events = fds[1].events = POLLIN;
+
+	while (poll(fds, 2, -1) > 0) {
+		if (fds[0].revents) {
+			const ssize_t got = read(client, buf, sizeof(buf));
+			if (got <= 0 || !writeall(server, buf, got))
+				break;
+		}
+		if (fds[1].revents) {
+			// Small reads keep the connections' turns interleaved
+			const ssize_t got = read(server, buf, 4096);
+			if (got <= 0)
+				break;
+			throttle(got);
+			if (!writeall(client, buf, got))
+				break;
+		}
+	}
+
+done:
+	if (server >= 0)
+		close(server);
+	close(client);
+	return NULL;
+}
+
+static void *listener(void *arg) {
+
+	const int fd = (intptr_t) arg;
+
+	while (1) {
+		const int client = accept(fd, NULL, NULL);
+		if (client < 0)
+			continue;
+
+		pthread_t tid;
+		if (pthread_create(&tid, NULL, serve, (void *) (intptr_t) client))
+			close(client);
+		else
+			pthread_detach(tid);
+	}
+
+	return NULL;
+}
+
+unsigned short startThrottle(const unsigned bytespersec) {
+
+	rate = bytespersec;
+
+	const int fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0)
+		return 0;
+
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t addrlen = sizeof(addr);
+
+	pthread_t tid;
+	if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) ||
+		listen(fd, 64) ||
+		getsockname(fd, (struct sockaddr *) &addr, &addrlen) ||
+		pthread_create(&tid, NULL, listener, (void *) (intptr_t) fd)) {
+		close(fd);
+		return 0;
+	}
+	pthread_detach(tid);
+
+	return ntohs(addr.sin_port);
+}
@@ -0,0 +1,13 @@
+/*
+	(C) Lauri Kasanen
+	Under the GPLv3.
+*/
+
+#ifndef throttle_h
+#define throttle_h
+
+// Starts a local HTTP proxy that passes responses on at most this many
+// bytes per second, over all connections together. Returns its port, or 0.
+unsigned short startThrottle(const unsigned bytespersec);
+
+#endif
@@ -3,13 +3,232 @@
 	Under the GPLv3.
 
 	Sample app for webkitfltk that exits as soon as a page is fully loaded.
-	Use for timed DOM/SVG/rendering benchmarks.
+	Use for timed DOM/SVG/rendering benchmarks. Prints the time from
+	starting the load to the first paint after it finished, and how the
+	render tree was allocated.
+
+	With -p, the loaded page is repainted with 1, 2, 4... paint threads
+	up to the core count, printing the average paint time for each, both
+	painting the page every time and replaying the cached display lists.
+
+	With -t <kB/s>, the page is loaded through a local proxy limited to
+	that bandwidth. The time to the first paint of page content is printed
+	too, to compare how soon the page becomes useful.
+
+	With -R <archive>, the responses of the load are recorded into the
+	archive. With -r <archive>, the load is replayed from it instead of the
+	network, each response after -l <ms> of latency (-1: as recorded), and
+	-t sets the replay's bandwidth instead of starting the proxy.
+
+	With -n <runs>, the page is loaded that many times, dropping the caches
+	in between, and the load, first paint, layout, script and paint times
+	are summarized over the runs.
+
+	Also prints how the malloc heap is used after the load, how many
+	connections the requests needed, and what decompressing them cost.
+
+	With -d <file>, the url is downloaded to the file instead, resuming it
+	if it fails, and the exit status tells whether it completed.
 */
 
 #include "webkit.h"
+#include "downloadcheck.h"
+#include "throttle.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
 
 static bool loaded = false;
+static bool paintbench = false;
+static bool nonempty = false, firstpainted = false;
 static Fl_Window *win;
+static double loadstart;
+
+static const char *url = "http://google.com";
+static const char *replay = NULL;
+static int latency = 0;
+static unsigned throttle = 0;
+static unsigned runs = 1, run = 0;
+
+enum {
+	LOAD,
+	FIRSTPAINT,
+	LAYOUT,
+	SCRIPT,
+	PAINT,
+	METRICS
+};
+static const char * const metricnames[METRICS] = {
+	"Load", "First paint", "Layout", "Script", "Paint"
+};
+// Per run, negative if it didn't happen
+static double *results[METRICS];
+static wk_timing_stats runstart;
+
+static double now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double painttime(webview *v) {
+	const unsigned reps = 20;
+
+	// Warm up caches, and record the display lists if they're kept
+	v->drawWeb();
+
+	const double start = now();
+	for (unsigned i = 0; i < reps; i++)
+		v->drawWeb();
+	return (now() - start) * 1000 / reps;
+}
+
+static void paintscaling(webview *v) {
+	const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+	for (long threads = 1; threads <= cores; threads *= 2) {
+		wk_set_paint_threads(threads);
+
+		wk_set_paint_cache(false);
+		const double paint = painttime(v);
+
+		wk_set_paint_cache(true);
+		const double replay = painttime(v);
+
+		printf("%2ld threads: %.2f ms per paint, %.2f ms per replay\n",
+			threads, paint, replay);
+	}
+
+	wk_set_paint_cache(false);
+}
+
+static int cmpdouble(const void *a, const void *b) {
+	const double x = *(const double *) a, y = *(const double *) b;
+	return x < y ? -1 : x > y;
+}
+
+static void summarize() {
+	double *vals = (double *) calloc(runs, sizeof(double));
+
+	printf("Over %u runs, in ms:    min  median    mean  stddev     max\n", runs);
+	for (unsigned m = 0; m < METRICS; m++) {
+		unsigned n = 0;
+		double sum = 0;
+		for (unsigned i = 0; i < runs; i++) {
+			if (results[m][i] < 0)
+				continue;
+			vals[n++] = results[m][i];
+			sum += results[m][i];
+		}
+		if (!n)
+			continue;
+
+		qsort(vals, n, sizeof(double), cmpdouble);
+		const double mean = sum / n;
+		double var = 0;
+		for (unsigned i = 0; i < n; i++)
+			var += (vals[i] - mean) * (vals[i] - mean);
+		const double median = n % 2 ? vals[n / 2] :
+					(vals[n / 2 - 1] + vals[n / 2]) / 2;
+
+		printf("%-20s %7.1f %7.1f %7.1f %7.1f %7.1f\n", metricnames[m],
+			vals[0], median, mean, n > 1 ? sqrt(var / (n - 1)) : 0,
+			vals[n - 1]);
+	}
+
+	free(vals);
+}
+
+static void arenastats() {
+	wk_render_arena_stats s;
+	wk_get_render_arena_stats(&s);
+
+	printf("Render arenas: %llu objects (%llu reused) in %llu chunks, "
+		"%llu mallocs, %lu kB live of %lu kB\n",
+		s.arena_allocs, s.reused, s.chunks, s.mallocs,
+		s.live_bytes / 1024, s.chunk_bytes / 1024);
+}
+
+static void memstats() {
+	wk_memory_stats s;
+	wk_get_memory_stats(&s);
+
+	printf("Heap: %lu kB committed of %lu kB reserved, %lu kB fragmented\n"
+		"\tsmall %lu kB used, %lu kB free; medium %lu kB used, %lu kB free\n"
+		"\tlarge %lu kB used, %lu kB free; huge %lu kB\n",
+		s.committed / 1024, s.reserved / 1024, s.fragmentation / 1024,
+		s.small_used / 1024, s.small_free / 1024,
+		s.medium_used / 1024, s.medium_free / 1024,
+		s.large_used / 1024, s.large_free / 1024, s.huge_used / 1024);
+}
+
+static void netstats() {
+	wk_network_stats s;
+	wk_get_network_stats(&s);
+
+	printf("Network: %llu requests (%llu HTTP/2), %llu new connections, "
+		"%llu reused, %llu TLS handshakes, %llu preconnects, %llu kB\n",
+		s.requests, s.http2_requests, s.new_connections,
+		s.reused_connections, s.tls_handshakes, s.preconnects,
+		s.bytes_received / 1024);
+}
+
+static void decodingstats() {
+	wk_decoding_stats s;
+	wk_get_decoding_stats(&s);
+
+	printf("Decoding: %llu responses, %llu kB to %llu kB in %.1f ms\n",
+		s.responses, s.encoded_bytes / 1024, s.decoded_bytes / 1024,
+		s.decode_ms);
+}
+
+static void bufferstats() {
+	wk_buffer_stats s;
+	wk_get_buffer_stats(&s);
+
+	printf("Buffers: %llu kB copied, %llu kB shared, %llu kB flattened\n",
+		s.bytes_copied / 1024, s.bytes_shared / 1024,
+		s.bytes_flattened / 1024);
+}
+
+static void startrun() {
+	loaded = nonempty = firstpainted = false;
+	results[FIRSTPAINT][run] = -1;
+
+	wk_get_timing_stats(&runstart);
+	loadstart = now();
+}
+
+static void nextrun(void *v) {
+	// Start the archive over, and the caches cold
+	if (replay)
+		wk_set_replay(replay, latency, throttle);
+	wk_drop_caches();
+
+	startrun();
+	((webview *) v)->load(url);
+}
+
+static void endrun() {
+	wk_timing_stats s;
+	wk_get_timing_stats(&s);
+
+	results[LOAD][run] = (now() - loadstart) * 1000;
+	results[LAYOUT][run] = s.layout_ms - runstart.layout_ms;
+	results[SCRIPT][run] = s.script_ms - runstart.script_ms;
+	results[PAINT][run] = s.paint_ms - runstart.paint_ms;
+
+	printf("Loaded in %.1f ms: %llu layouts %.1f ms, %llu scripts %.1f ms, "
+		"%llu paints %.1f ms\n",
+		results[LOAD][run],
+		s.layouts - runstart.layouts, results[LAYOUT][run],
+		s.scripts - runstart.scripts, results[SCRIPT][run],
+		s.paints - runstart.paints, results[PAINT][run]);
+}
 
 class myview: public webview {
 public:
@@ -18,8 +237,32 @@ public:
 	void draw() override {
 		webview::draw();
 
-		// If we drew after the page was loaded, time to exit
-		if (loaded) win->hide();
+		if (nonempty && !firstpainted) {
+			results[FIRSTPAINT][run] = (now() - loadstart) * 1000;
+			printf("First paint in %.1f ms\n", results[FIRSTPAINT][run]);
+			firstpainted = true;
+		}
+
+		// If we drew after the page was loaded, the run is done
+		if (loaded) {
+			endrun();
+			if (++run < runs) {
+				loaded = false;
+				Fl::add_timeout(0, nextrun, this);
+				return;
+			}
+
+			if (runs > 1)
+				summarize();
+			arenastats();
+			memstats();
+			netstats();
+			decodingstats();
+			bufferstats();
+			if (paintbench)
+				paintscaling(this);
+			win->hide();
+		}
 	}
 
 };
@@ -32,23 +275,100 @@ static void progress(webview *, const float amount) {
 	}
 }
 
+static void visuallynonempty(webview *) {
+	nonempty = true;
+}
+
 int main(int argc, char **argv) {
 
+	const char *record = NULL;
+	const char *downloadfile = NULL;
+
+	while (argc > 1) {
+		unsigned used = 1;
+		if (!strcmp(argv[1], "-p")) {
+			paintbench = true;
+		} else if (!strcmp(argv[1], "-t") && argc > 2) {
+			throttle = atoi(argv[2]);
+			used = 2;
+		} else if (!strcmp(argv[1], "-R") && argc > 2) {
+			record = argv[2];
+			used = 2;
+		} else if (!strcmp(argv[1], "-r") && argc > 2) {
+			replay = argv[2];
+			used = 2;
+		} else if (!strcmp(argv[1], "-l") && argc > 2) {
+			latency = atoi(argv[2]);
+			used = 2;
+		} else if (!strcmp(argv[1], "-d") && argc > 2) {
+			downloadfile = argv[2];
+			used = 2;
+		} else if (!strcmp(argv[1], "-n") && argc > 2) {
+			runs = atoi(argv[2]);
+			if (!runs)
+				runs = 1;
+			used = 2;
+		} else {
+			break;
+		}
+
+		argv[used] = argv[0];
+		argc -= used;
+		argv += used;
+	}
+
+	for (unsigned m = 0; m < METRICS; m++)
+		results[m] = (double *) calloc(runs, sizeof(double));
+
+	if (throttle && !replay) {
+		const unsigned short port = startThrottle(throttle * 1024);
+		if (!port) {
+			printf("Failed to start the throttling proxy\n");
+			return 1;
+		}
+
+		// The network layer uses these when no proxy is set
+		char proxy[32];
+		snprintf(proxy, 32, "http://127.0.0.1:%u", port);
+		setenv("http_proxy", proxy, 1);
+		setenv("https_proxy", proxy, 1);
+		unsetenv("no_proxy");
+	}
+
 	webkitInit();
+
+	if (replay && !wk_set_replay(replay, latency, throttle)) {
+		printf("Failed to read the archive %s\n", replay);
+		return 1;
+	}
+	if (record)
+		wk_set_record(record);
+
+	if (downloadfile) {
+		if (argc > 1)
+			url = argv[1];
+		return downloadTo(url, downloadfile) ? 0 : 1;
+	}
+
 	win = new Fl_Window(800, 600);
 	v = new myview(0, 0, 800, 600);
 	win->end();
 	win->show(argc, argv);
 
 	v->progressChangedCB(progress);
+	v->visuallyNonEmptyCB(visuallynonempty);
 
 	if (argc > 1)
-		v->load(argv[1]);
-	else
-		v->load("http://google.com");
+		url = argv[1];
+	startrun();
+	v->load(url);
 
 	Fl::run();
 
+	// Flush the archive
+	if (record)
+		wk_set_record(NULL);
+
 	// Give everything the chance to cleanup
 	delete win;
 	wk_drop_caches();
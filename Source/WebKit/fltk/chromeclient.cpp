@@ -279,12 +279,15 @@ IntRect FlChromeClient::windowResizerRect() const {
 
 void FlChromeClient::invalidateRootView(const IntRect &rect) {
 
-	if (rect.width() < 2)
+	if (rect.width() < 2) {
+		view->priv->tiles.invalidateAll();
 		view->redraw();
-	else
+	} else {
+		view->priv->tiles.invalidate(rect);
 		view->damage(FL_DAMAGE_EXPOSE, rect.x() + view->x(),
 				rect.y() + view->y(),
 				rect.width(), rect.height());
+	}
 }
 
 void FlChromeClient::invalidateContentsAndRootView(const IntRect &rect) {
@@ -422,8 +425,9 @@ void FlChromeClient::loadIconForFiles(const Vector<String>&, FileIconLoader*) {
 	notImplemented();
 }
 
-void FlChromeClient::attachRootGraphicsLayer(Frame*, GraphicsLayer*) {
-	notImplemented();
+void FlChromeClient::attachRootGraphicsLayer(Frame*, GraphicsLayer *layer) {
+	view->priv->compositor.setRootLayer(layer);
+	view->redraw();
 }
 
 void FlChromeClient::setNeedsOneShotDrawingSynchronization() {
@@ -431,7 +435,13 @@ void FlChromeClient::setNeedsOneShotDrawingSynchronization() {
 }
 
 void FlChromeClient::scheduleCompositingLayerFlush() {
-	notImplemented();
+	// A full redraw, so layers may move anywhere on commit
+	view->priv->compositor.scheduleFlush();
+	view->redraw();
+}
+
+ChromeClient::CompositingTriggerFlags FlChromeClient::allowedCompositingTriggers() const {
+	return AnimationTrigger | AnimatedOpacityTrigger;
 }
 
 bool FlChromeClient::selectItemWritingDirectionIsNatural() {
@@ -89,6 +89,7 @@ public:
 	void attachRootGraphicsLayer(WebCore::Frame*, WebCore::GraphicsLayer*) override;
 	void setNeedsOneShotDrawingSynchronization() override;
 	void scheduleCompositingLayerFlush() override;
+	CompositingTriggerFlags allowedCompositingTriggers() const override;
 	bool selectItemWritingDirectionIsNatural() override;
 	bool selectItemAlignmentFollowsMenuWritingDirection() override;
 	bool hasOpenedPopup() const override;
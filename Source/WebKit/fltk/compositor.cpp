@@ -0,0 +1,102 @@
+/*
+WebkitFLTK
+Copyright (C) 2014 Lauri Kasanen
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, version 3 of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include "compositor.h"
+
+#include <GraphicsLayerTextureMapper.h>
+#include <TextureMapperLayer.h>
+
+using namespace WebCore;
+
+layercompositor::layercompositor(): root(NULL), flushpending(false),
+		reapply(false), running(false) {
+}
+
+TextureMapperLayer &layercompositor::rootLayer() {
+	return downcast<GraphicsLayerTextureMapper>(*root).layer();
+}
+
+void layercompositor::setRootLayer(GraphicsLayer *layer) {
+
+	root = layer;
+	lastanim = IntRect();
+	running = false;
+	if (!root)
+		return;
+
+	if (!texmap)
+		texmap = TextureMapper::create();
+	rootLayer().setTextureMapper(texmap.get());
+	flushpending = true;
+}
+
+void layercompositor::flush(FrameView &view) {
+
+	if (!root || !flushpending)
+		return;
+
+	flushpending = false;
+	view.flushCompositingStateIncludingSubframes();
+
+	// A commit resets the layers to their base state
+	reapply = true;
+}
+
+void layercompositor::composite(GraphicsContext &gc, const IntRect &clip) {
+
+	if (!root)
+		return;
+
+	downcast<GraphicsLayerTextureMapper>(*root).updateBackingStoreIncludingSubLayers();
+
+	TextureMapperLayer &layer = rootLayer();
+	if (reapply) {
+		reapply = false;
+		layer.applyAnimationsRecursively();
+		lastanim = unionRect(lastanim,
+				enclosingIntRect(layer.runningAnimationsBoundingRect()));
+	}
+
+	gc.save();
+	gc.clip(clip);
+
+	texmap->setGraphicsContext(&gc);
+	texmap->beginPainting();
+	layer.paint();
+	texmap->endPainting();
+	texmap->setGraphicsContext(NULL);
+
+	gc.restore();
+
+	running = layer.descendantsOrSelfHaveRunningAnimations();
+}
+
+IntRect layercompositor::tick() {
+
+	if (!root)
+		return IntRect();
+
+	TextureMapperLayer &layer = rootLayer();
+	layer.applyAnimationsRecursively();
+
+	const IntRect now = enclosingIntRect(layer.runningAnimationsBoundingRect());
+	const IntRect damage = unionRect(lastanim, now);
+	lastanim = now;
+
+	return damage;
+}
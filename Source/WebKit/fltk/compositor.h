@@ -0,0 +1,67 @@
+/*
+WebkitFLTK
+Copyright (C) 2014 Lauri Kasanen
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, version 3 of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef compositor_h
+#define compositor_h
+
+#include <platform/PlatformExportMacros.h>
+#include <FrameView.h>
+#include <GraphicsContext.h>
+#include <GraphicsLayer.h>
+#include <IntRect.h>
+#include <TextureMapper.h>
+#include <memory>
+
+namespace WebCore {
+class TextureMapperLayer;
+}
+
+// Layers WebCore composites, those with transform or opacity animations,
+// keep their backing stores. Each frame they are drawn over the page with
+// the software texture mapper, without repainting their contents.
+//
+// Animations only advance on a flush or a tick, so that every place an
+// animating layer was drawn at gets damaged before it moves on.
+class layercompositor {
+public:
+	layercompositor();
+
+	void setRootLayer(WebCore::GraphicsLayer *);
+	bool active() const { return root; }
+
+	void scheduleFlush() { flushpending = true; }
+	void flush(WebCore::FrameView &);
+
+	// Draw the layers over the page, within clip.
+	void composite(WebCore::GraphicsContext &, const WebCore::IntRect &clip);
+
+	bool animating() const { return running; }
+
+	// Advance the running animations. Returns the area to redraw: where
+	// they were on the last frame, and where they are now.
+	WebCore::IntRect tick();
+
+private:
+	WebCore::TextureMapperLayer &rootLayer();
+
+	WebCore::GraphicsLayer *root;
+	std::unique_ptr<WebCore::TextureMapper> texmap;
+	WebCore::IntRect lastanim;
+	bool flushpending, reapply, running;
+};
+
+#endif
@@ -19,15 +19,25 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "download.h"
 
+#include <HTTPHeaderNames.h>
+#include <wtf/CurrentTime.h>
 #include <wtf/text/Base64.h>
 #include <wtf/text/CString.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
 #include <string.h>
+#include <unistd.h>
 
 using namespace WTF;
 using namespace WebCore;
 
 extern void (*downloadfunc)(const char *url, const char *file);
 extern void (*downloadrefreshfunc)();
+extern unsigned wk_download_segments;
+
+// Smaller downloads aren't worth the extra connections
+static const long long segmentedMinSize = 4 * 1024 * 1024;
 
 static void saveData(const char *file, const char *data, const unsigned size) {
 	FILE *f = fopen(file, "w");
@@ -66,15 +76,49 @@ static unsigned handleData(const char *url, const char *file) {
 	return 0;
 }
 
+downloadsegment::downloadsegment(download *parent, long long start, long long end):
+		parent(parent), curl(NULL), start(start), end(end), done(0),
+		offset(start), finished(false) {
+}
+
+downloadsegment::~downloadsegment() {
+	delete curl;
+}
+
+long long downloadsegment::progress() const {
+	return done + (curl ? curl->bytesWritten() : 0);
+}
+
+void downloadsegment::didReceiveResponse() {
+	parent->split(this);
+}
+
+void downloadsegment::didReceiveDataOfLength(int) {
+	parent->refresh(false);
+}
+
+void downloadsegment::didFinish() {
+	parent->segmentFinished(this);
+}
+
+void downloadsegment::didFail() {
+	parent->segmentFailed(this);
+}
+
 download::download(const char *url, const char *file,
 			const ResourceRequest *req) {
 	this->url = strdup(url);
 	this->file = strdup(file);
 	time = ::time(NULL);
+	lastrefresh = 0;
 	received = 0;
 	size = -1;
 	failed = finished = false;
 	isData = false;
+	hasRequest = req != NULL;
+	ranges = true;
+	part = NULL;
+	fd = -1;
 
 	// Is it a data: url? data:image/octet-stream;base64,iVBORw0KG
 	if (!strncmp(url, "data:", 5)) {
@@ -83,67 +127,233 @@ download::download(const char *url, const char *file,
 		size = received = handleData(url, file);
 
 		if (size)
-			didFinish();
+			complete();
 		else
-			didFail();
+			failed = true;
 
 		return;
 	}
 
-	curl.init(this, URL(ParsedURLString, this->url));
-
 	if (req)
-		curl.addHeaders(*req);
+		request = *req;
 
-	curl.setDestination(file);
+	// Data goes to file.part, renamed when complete. It's kept on
+	// failure so that the download can be resumed.
+	if (asprintf(&part, "%s.part", file) < 0) {
+		part = NULL;
+		failed = true;
+		return;
+	}
+	fd = open(part, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		failed = true;
+		return;
+	}
 
-	curl.start();
+	segments.push_back(new downloadsegment(this, 0, -1));
+	startSegment(segments[0]);
 }
 
 download::~download() {
+	// Finish the transfers before the file goes away.
+	const unsigned max = segments.size();
+	for (unsigned i = 0; i < max; i++)
+		delete segments[i];
+
+	if (fd >= 0)
+		close(fd);
+
 	free((char *) url);
 	free((char *) file);
+	free(part);
 }
 
-void download::didReceiveResponse() {
-	if (isData)
+void download::startSegment(downloadsegment *seg) {
+
+	if (seg->curl) {
+		seg->done = seg->progress();
+		delete seg->curl;
+	}
+
+	seg->offset = seg->start + seg->done;
+
+	seg->curl = new CurlDownload;
+	seg->curl->init(seg, URL(ParsedURLString, url));
+
+	if (hasRequest)
+		seg->curl->addHeaders(request);
+
+	seg->curl->setOutputFile(fd, seg->offset);
+	seg->curl->setRange(seg->offset, seg->end);
+
+	seg->curl->start();
+}
+
+// Once the size is known, a large download whose server takes ranges is
+// split: the first transfer stops early, the rest is fetched in parallel.
+void download::split(downloadsegment *seg) {
+
+	if (size >= 0 || seg != segments[0])
+		return;
+
+	const ResourceResponse &res = seg->curl->getResponse();
+	const long long length = res.expectedContentLength();
+	if (length <= 0)
+		return;
+	size = seg->offset + length;
+
+	// Reserve the space up front, so the segments don't fragment the file.
+	// Without the room for it, the download fails now rather than at the end.
+	if (posix_fallocate(fd, 0, size) == ENOSPC) {
+		stop();
+		return;
+	}
+
+	const unsigned parts = wk_download_segments;
+	if (parts < 2 || size < segmentedMinSize || seg->end >= 0 ||
+		!res.httpHeaderField(HTTPHeaderName::AcceptRanges).contains("bytes"))
 		return;
 
-	const ResourceResponse &res = curl.getResponse();
-	size = res.expectedContentLength();
+	const long long firstend = seg->curl->setRangeEnd(size / parts - 1);
+	seg->end = firstend;
+
+	long long start = firstend + 1;
+	const long long left = size - start;
+	if (left <= 0)
+		return;
+
+	const long long each = left / (parts - 1);
+	for (unsigned i = 1; i < parts && start < size; i++) {
+		const long long end = i == parts - 1 ? size - 1 : start + each - 1;
+		downloadsegment *next = new downloadsegment(this, start, end);
+		segments.push_back(next);
+		startSegment(next);
+		start = end + 1;
+	}
 }
 
-void download::didReceiveDataOfLength(int size) {
+void download::segmentFinished(downloadsegment *seg) {
+
+	seg->finished = true;
 
-	received += size;
+	const unsigned max = segments.size();
+	for (unsigned i = 0; i < max; i++) {
+		if (!segments[i]->finished) {
+			refresh(false);
+			return;
+		}
+	}
 
-	if (downloadrefreshfunc)
-		downloadrefreshfunc();
+	if (!failed)
+		complete();
 }
 
-void download::didFinish() {
+void download::segmentFailed(downloadsegment *seg) {
+
+	// The server ignored our range, resuming has to start over
+	if (seg->offset && seg->curl->getResponse().httpStatusCode() == 200)
+		ranges = false;
+
+	// Stop the rest, they'll continue from where they were on resume()
+	const unsigned max = segments.size();
+	for (unsigned i = 0; i < max; i++) {
+		if (segments[i] != seg && !segments[i]->finished)
+			segments[i]->curl->cancel();
+	}
+
+	failed = true;
+	refresh(true);
+}
+
+void download::complete() {
+
+	if (fd >= 0) {
+		close(fd);
+		fd = -1;
+
+		if (rename(part, file)) {
+			failed = true;
+			refresh(true);
+			return;
+		}
+	}
 
 	finished = true;
 
 	if (downloadfunc)
 		downloadfunc(url, file);
-	if (downloadrefreshfunc)
-		downloadrefreshfunc();
+	refresh(true);
 }
 
-void download::didFail() {
-	failed = true;
+// Progress is reported at most every 100ms, state changes always.
+void download::refresh(const bool force) {
+
+	if (!downloadrefreshfunc)
+		return;
+
+	const double now = monotonicallyIncreasingTime();
+	if (!force && now - lastrefresh < 0.1)
+		return;
+	lastrefresh = now;
+
+	downloadrefreshfunc();
 }
 
 void download::stop() {
-	if (isData)
+	if (isData || finished)
 		return;
 
-	curl.cancel();
+	const unsigned max = segments.size();
+	for (unsigned i = 0; i < max; i++) {
+		if (!segments[i]->finished)
+			segments[i]->curl->cancel();
+	}
 	failed = true;
 
-	if (downloadrefreshfunc)
-		downloadrefreshfunc();
+	refresh(true);
+}
+
+void download::resume() {
+	if (isData || finished || !failed || fd < 0)
+		return;
+
+	if (!ranges) {
+		// A segment got the whole file instead of its range. Start over
+		// with one transfer for all of it, the server may still split.
+		if (ftruncate(fd, 0))
+			return;
+
+		const unsigned max = segments.size();
+		for (unsigned i = 1; i < max; i++)
+			delete segments[i];
+		segments.resize(1);
+
+		downloadsegment *seg = segments[0];
+		delete seg->curl;
+		seg->curl = NULL;
+		seg->finished = false;
+		seg->done = 0;
+		seg->end = -1;
+		size = -1;
+		received = 0;
+		ranges = true;
+	}
+
+	failed = false;
+
+	bool pending = false;
+	const unsigned max = segments.size();
+	for (unsigned i = 0; i < max; i++) {
+		if (segments[i]->finished)
+			continue;
+		startSegment(segments[i]);
+		pending = true;
+	}
+
+	if (!pending)
+		complete();
+	else
+		refresh(true);
 }
 
 bool download::isFailed() const {
@@ -158,5 +368,15 @@ void download::getStats(time_t *start, long long *size, long long *received) con
 
 	*start = time;
 	*size = this->size;
-	*received = this->received;
+
+	if (isData) {
+		*received = this->received;
+		return;
+	}
+
+	long long sum = 0;
+	const unsigned max = segments.size();
+	for (unsigned i = 0; i < max; i++)
+		sum += segments[i]->progress();
+	*received = sum;
 }
@@ -21,31 +21,64 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <platform/PlatformExportMacros.h>
 #include <CurlDownload.h>
 #include <ResourceRequest.h>
+#include <vector>
 
-class download: public WebCore::CurlDownloadListener {
-public:
-	download(const char *url, const char *file,
-			const WebCore::ResourceRequest *req = NULL);
-	virtual ~download();
+class download;
 
-	void stop();
+// One HTTP range of a download, with its own transfer.
+class downloadsegment: public WebCore::CurlDownloadListener {
+public:
+	downloadsegment(download *parent, long long start, long long end);
+	virtual ~downloadsegment();
 
 	void didReceiveResponse() override;
 	void didReceiveDataOfLength(int size) override;
 	void didFinish() override;
 	void didFail() override;
 
+	long long progress() const;
+
+	download *parent;
+	WebCore::CurlDownload *curl;
+	long long start, end; // inclusive, end -1 if unknown
+	long long done; // bytes written by previous transfers
+	long long offset; // where the current transfer started
+	bool finished;
+};
+
+class download {
+public:
+	download(const char *url, const char *file,
+			const WebCore::ResourceRequest *req = NULL);
+	virtual ~download();
+
+	void stop();
+	void resume();
+
 	void getStats(time_t *start, long long *size, long long *received) const;
 	bool isFailed() const;
 	bool isFinished() const;
 
 	const char *url, *file;
 private:
-	WebCore::CurlDownload curl;
+	friend class downloadsegment;
+
+	void startSegment(downloadsegment *);
+	void split(downloadsegment *);
+	void segmentFinished(downloadsegment *);
+	void segmentFailed(downloadsegment *);
+	void complete();
+	void refresh(const bool force);
+
+	std::vector<downloadsegment *> segments;
+	WebCore::ResourceRequest request;
+	char *part;
+	int fd;
 	time_t time;
+	double lastrefresh;
 	long long size, received;
 	bool failed, finished;
-	bool isData;
+	bool isData, hasRequest, ranges;
 };
 
 #endif
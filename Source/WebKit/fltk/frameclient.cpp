@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <Credential.h>
 #include <wtf/text/CString.h>
 #include <DocumentLoader.h>
+#include <DOMWrapperWorld.h>
 #include <FrameNetworkingContext.h>
 #include <ErrorsFLTK.h>
 #include <MainFrame.h>
@@ -34,6 +35,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <ResourceError.h>
 #include <ResourceLoader.h>
 #include <ResourceRequest.h>
+#include <SecurityOrigin.h>
+#include <Settings.h>
+#include <StorageNamespaceProvider.h>
 
 #include <FL/fl_ask.H>
 
@@ -222,6 +226,18 @@ void FlFrameLoaderClient::dispatchDidReceiveIcon() {
 }
 
 void FlFrameLoaderClient::dispatchDidStartProvisionalLoad() {
+	if (frame != &view->priv->page->mainFrame() ||
+		!frame->settings().localStorageEnabled())
+		return;
+
+	DocumentLoader * const loader = frame->loader().provisionalDocumentLoader();
+	if (!loader)
+		return;
+
+	// Start importing the site's localStorage now, so the first access
+	// from the page doesn't have to wait for the disk.
+	RefPtr<SecurityOrigin> origin = SecurityOrigin::create(loader->url());
+	view->priv->page->storageNamespaceProvider().prefetchLocalStorageArea(*origin);
 }
 
 void FlFrameLoaderClient::dispatchDidReceiveTitle(const StringWithDirection&) {
@@ -307,6 +323,13 @@ void FlFrameLoaderClient::dispatchDidFinishLoad() {
 		view->priv->loadStateChanged(view);
 }
 
+void FlFrameLoaderClient::dispatchDidLayout(LayoutMilestones milestones) {
+	if (!(milestones & DidFirstVisuallyNonEmptyLayout) || !frame->isMainFrame())
+		return;
+	if (view->priv->visuallyNonEmpty)
+		view->priv->visuallyNonEmpty(view);
+}
+
 Frame* FlFrameLoaderClient::dispatchCreatePage(const NavigationAction &act) {
 
 	if (popupfunc) {
@@ -746,8 +769,12 @@ String FlFrameLoaderClient::overrideMediaType() const {
 	return String();
 }
 
-void FlFrameLoaderClient::dispatchDidClearWindowObjectInWorld(DOMWrapperWorld&) {
-	notImplemented();
+void FlFrameLoaderClient::dispatchDidClearWindowObjectInWorld(DOMWrapperWorld &world) {
+	// Native functions are only offered to the page itself, not to its iframes
+	if (&world != &mainThreadNormalWorld() || frame != &view->priv->page->mainFrame())
+		return;
+
+	installJSBindings(view, *frame);
 }
 
 void FlFrameLoaderClient::registerForIconNotification(bool listen) {
@@ -68,6 +68,7 @@ public:
 	void dispatchDidFailLoad(const WebCore::ResourceError&) override;
 	void dispatchDidFinishDocumentLoad() override;
 	void dispatchDidFinishLoad() override;
+	void dispatchDidLayout(WebCore::LayoutMilestones) override;
 
 	WebCore::Frame* dispatchCreatePage(const WebCore::NavigationAction&) override;
 	void dispatchShow() override;
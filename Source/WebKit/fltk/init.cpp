@@ -21,21 +21,32 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <ApplicationCacheStorage.h>
 #include <CrossOriginPreflightResultCache.h>
+#include <CurlCacheManager.h>
+#include <CurlContentDecoder.h>
+#include <CurlRecordReplay.h>
 #include <FontCache.h>
+#include <FrameView.h>
 #include <GCController.h>
 #include <IconDatabase.h>
 #include <IconDatabaseClient.h>
 #include <ImageSource.h>
+#include <JSMainThreadExecState.h>
 #include <Logging.h>
 #include <MemoryCache.h>
 #include <Page.h>
 #include <PageCache.h>
 #include <PageGroup.h>
+#include <RenderArena.h>
 #include <ResourceHandle.h>
+#include <ResourceHandleManager.h>
+#include <SSLHandle.h>
+#include <SharedBuffer.h>
 #include <TextEncodingRegistry.h>
+#include <StorageAreaSync.h>
 #include "webkit.h"
 
 #include "platformstrategy.h"
+#include "trace.h"
 
 #include <runtime/InitializeThreading.h>
 #include <wtf/MainThread.h>
@@ -65,7 +76,15 @@ const char *(*spoofedLanguage)(const char *) = NULL;
 
 const char *wk_stream_exec = NULL;
 const char *wk_cookiepath = NULL;
+const char *wk_localstoragedir = NULL;
 int wheelspeed = 100;
+unsigned wk_paint_threads = 1;
+bool wk_paint_cache = false;
+bool wk_layer_compositing = true;
+unsigned wk_download_segments = 4;
+unsigned wk_sync_timeout = 60;
+unsigned long long wk_paint_count = 0;
+double wk_paint_time = 0;
 
 void webkitInit() {
 	static bool init = false;
@@ -155,6 +174,8 @@ void wk_drop_caches() {
 
 	// Run GC
 	WebCore::gcController().garbageCollectNow();
+
+	WTF::releaseFastMallocFreeMemory();
 }
 
 char *wk_urlencode(const char *in) {
@@ -165,6 +186,7 @@ char *wk_urlencode(const char *in) {
 
 void wk_set_ssl_func(int (*func)(const char *, const char *)) {
 	sslfunc = func;
+	clearCertificateDecisions();
 }
 
 void wk_set_ssl_err_func(void (*func)(webview *, const char *, const bool)) {
@@ -196,6 +218,10 @@ void wk_set_new_download_func(void (*func)()) {
 	newdownloadfunc = func;
 }
 
+void wk_set_download_segments(const unsigned num) {
+	wk_download_segments = num ? num : 1;
+}
+
 void wk_set_bgtab_func(void (*func)(const char*)) {
 	bgtabfunc = func;
 }
@@ -322,6 +348,14 @@ void wk_set_cache_max(const unsigned bytes) {
 	WebCore::ApplicationCacheStorage::singleton().setMaximumSize(bytes);
 }
 
+void wk_set_disk_cache_dir(const char *dir) {
+	CurlCacheManager::getInstance().setCacheDirectory(dir);
+}
+
+void wk_set_disk_cache_max(const unsigned long bytes) {
+	CurlCacheManager::getInstance().setStorageSizeLimit(bytes);
+}
+
 void wk_set_tz_func(int (*func)()) {
 	spoofedTZ = func;
 }
@@ -347,6 +381,153 @@ void wk_set_cookie_path(const char *path) {
 	asprintf((char **) &wk_cookiepath, "%s/cookies.dat", path);
 }
 
+void wk_set_paint_threads(const unsigned threads) {
+	wk_paint_threads = threads ? threads : 1;
+}
+
+void wk_set_paint_cache(const bool on) {
+	wk_paint_cache = on;
+}
+
+void wk_set_layer_compositing(const bool on) {
+	wk_layer_compositing = on;
+}
+
+void wk_set_localstorage_dir(const char *dir) {
+	free((char *) wk_localstoragedir);
+	wk_localstoragedir = dir ? strdup(dir) : NULL;
+}
+
+void wk_get_storage_stats(struct wk_storage_stats *out) {
+	const StorageAreaSyncStatistics stats = StorageAreaSync::statistics();
+
+	out->imports = stats.importCount;
+	out->import_time = stats.totalImportTime;
+	out->max_import_time = stats.maxImportTime;
+	out->blocked_time = stats.blockedTime;
+	out->sync_backlog = stats.syncBacklog;
+	out->syncs = stats.syncCount;
+	out->synced_items = stats.syncedItemCount;
+}
+
+void wk_get_network_stats(struct wk_network_stats *out) {
+	const CurlConnectionStatistics stats =
+		ResourceHandleManager::sharedInstance()->connectionStatistics();
+
+	out->requests = stats.requests;
+	out->new_connections = stats.newConnections;
+	out->reused_connections = stats.reusedConnections;
+	out->tls_handshakes = stats.tlsHandshakes;
+	out->http2_requests = stats.http2Requests;
+	out->preconnects = stats.preconnects;
+	out->bytes_received = stats.bytesReceived;
+}
+
+void wk_get_buffer_stats(struct wk_buffer_stats *out) {
+	const SharedBufferStatistics stats = SharedBuffer::statistics();
+
+	out->bytes_copied = stats.bytesCopied;
+	out->bytes_shared = stats.bytesShared;
+	out->bytes_flattened = stats.bytesFlattened;
+}
+
+void wk_get_decoding_stats(struct wk_decoding_stats *out) {
+	const ContentDecodingStatistics stats = CurlContentDecoder::statistics();
+
+	out->responses = stats.responses;
+	out->encoded_bytes = stats.encodedBytes;
+	out->decoded_bytes = stats.decodedBytes;
+	out->decode_ms = stats.decodeTime * 1000;
+}
+
+void wk_get_timing_stats(struct wk_timing_stats *out) {
+	const LayoutStatistics layout = FrameView::layoutStatistics();
+	const ScriptStatistics script = JSMainThreadExecState::statistics();
+
+	out->layouts = layout.layouts;
+	out->layout_ms = layout.layoutTime * 1000;
+	out->scripts = script.entries;
+	out->script_ms = script.scriptTime * 1000;
+	out->paints = wk_paint_count;
+	out->paint_ms = wk_paint_time * 1000;
+}
+
+void wk_set_record(const char *archive) {
+	if (archive)
+		CurlRecordReplay::singleton().startRecording(String::fromUTF8(archive));
+	else
+		CurlRecordReplay::singleton().stop();
+}
+
+bool wk_set_replay(const char *archive, const int latency_ms, const unsigned kbps) {
+	if (!archive) {
+		CurlRecordReplay::singleton().stop();
+		return true;
+	}
+
+	return CurlRecordReplay::singleton().startReplaying(String::fromUTF8(archive),
+			latency_ms, kbps * 1024);
+}
+
+void wk_set_hover_preconnect(const bool on) {
+	ResourceHandleManager::sharedInstance()->setHoverPreconnectEnabled(on);
+}
+
+void wk_set_sync_timeout(const unsigned seconds) {
+	wk_sync_timeout = seconds;
+}
+
+void wk_get_render_arena_stats(struct wk_render_arena_stats *out) {
+	const RenderArenaStatistics stats = RenderArena::statistics();
+
+	out->arena_allocs = stats.arenaAllocations;
+	out->reused = stats.freeListAllocations;
+	out->mallocs = stats.mallocAllocations;
+	out->chunks = stats.chunkAllocations;
+	out->arenas = stats.arenaCount;
+	out->chunk_bytes = stats.chunkBytes;
+	out->live_bytes = stats.liveBytes;
+}
+
+void wk_get_memory_stats(struct wk_memory_stats *out) {
+	const WTF::FastMallocHeapStatistics stats = WTF::fastMallocHeapStatistics();
+
+	out->small_used = stats.smallInUse;
+	out->small_free = stats.smallFree;
+	out->small_committed = stats.smallCommitted;
+	out->medium_used = stats.mediumInUse;
+	out->medium_free = stats.mediumFree;
+	out->medium_committed = stats.mediumCommitted;
+	out->large_used = stats.largeInUse;
+	out->large_free = stats.largeFree;
+	out->huge_used = stats.xLargeInUse;
+
+	out->reserved = stats.reserved;
+	out->committed = stats.smallCommitted + stats.mediumCommitted +
+				stats.largeInUse + stats.largeFree + stats.xLargeInUse;
+	out->fragmentation = stats.smallCommitted + stats.mediumCommitted -
+				stats.smallInUse - stats.smallFree -
+				stats.mediumInUse - stats.mediumFree;
+
+	static_assert(WK_MEMORY_SIZE_CLASSES == WTF::fastMallocSizeClassCount,
+			"size classes must match fastMalloc");
+	unsigned i;
+	for (i = 0; i < WK_MEMORY_SIZE_CLASSES; i++)
+		out->size_classes[i] = stats.sizeClassInUse[i];
+}
+
+void wk_set_memory_scavenger(const float delay, const unsigned long retained) {
+	WTF::setFastMallocScavengerParameters(delay, retained);
+}
+
+bool wk_start_trace(const char *path) {
+	return startTrace(path);
+}
+
+void wk_stop_trace() {
+	stopTrace();
+}
+
 void wk_set_image_max(const unsigned size) {
 #if ENABLE(IMAGE_DECODER_DOWN_SAMPLING)
 	ImageSource::setMaxPixelsPerDecodedImage(size * size);
@@ -0,0 +1,222 @@
+/*
+WebkitFLTK
+Copyright (C) 2014 Lauri Kasanen
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, version 3 of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include "jsbridge.h"
+#include "webviewpriv.h"
+
+#include <DOMWrapperWorld.h>
+#include <JSDOMWindow.h>
+#include <ScriptController.h>
+#include <bindings/ScriptValue.h>
+#include <runtime/ArrayBuffer.h>
+#include <runtime/ArrayBufferView.h>
+#include <runtime/Error.h>
+#include <runtime/FunctionPrototype.h>
+#include <runtime/InternalFunction.h>
+#include <runtime/JSArrayBuffer.h>
+#include <runtime/JSArrayBufferView.h>
+#include <runtime/JSCInlines.h>
+#include <runtime/JSLock.h>
+#include <runtime/JSONObject.h>
+
+using namespace JSC;
+using namespace WTF;
+using namespace WebCore;
+
+// A window.name() function. The binding is looked up by name on each call,
+// so replacing it takes effect on pages already loaded.
+class FlJSFunction: public InternalFunction {
+public:
+	typedef InternalFunction Base;
+
+	static FlJSFunction *create(VM &vm, JSGlobalObject *global, const String &name,
+					webview *view) {
+		FlJSFunction * const f = new (NotNull, allocateCell<FlJSFunction>(vm.heap))
+				FlJSFunction(vm, createStructure(vm, global,
+						global->functionPrototype()), view);
+		f->finishCreation(vm, name);
+		return f;
+	}
+
+	static Structure *createStructure(VM &vm, JSGlobalObject *global, JSValue proto) {
+		return Structure::create(vm, global, proto,
+				TypeInfo(ObjectType, StructureFlags), info());
+	}
+
+	webview *view() const { return m_view; }
+
+	DECLARE_INFO;
+
+protected:
+	static CallType getCallData(JSCell *, CallData &);
+
+private:
+	FlJSFunction(VM &vm, Structure *structure, webview *view):
+			InternalFunction(vm, structure), m_view(view) {
+	}
+
+	webview *m_view;
+};
+
+const ClassInfo FlJSFunction::s_info = { "Function", &Base::s_info, 0,
+						CREATE_METHOD_TABLE(FlJSFunction) };
+
+static const jsbinding *findJSBinding(const webview *view, const char *name) {
+
+	for (const jsbinding &b: view->priv->jsbindings) {
+		if (!strcmp(b.name, name))
+			return &b;
+	}
+
+	return NULL;
+}
+
+static EncodedJSValue JSC_HOST_CALL callJSBinding(ExecState *exec) {
+
+	FlJSFunction * const callee = jsCast<FlJSFunction *>(exec->callee());
+	webview * const view = callee->view();
+	const jsbinding * const b = findJSBinding(view, callee->name(exec).utf8().data());
+	if (!b)
+		return JSValue::encode(jsUndefined());
+
+	const unsigned argc = exec->argumentCount();
+	std::vector<jsarg> args(argc);
+
+	// Keep the strings and buffers alive over the call
+	std::vector<CString> strings;
+	std::vector<RefPtr<ArrayBufferView> > views;
+	std::vector<RefPtr<ArrayBuffer> > buffers;
+	strings.reserve(argc);
+
+	unsigned i;
+	for (i = 0; i < argc; i++) {
+		const JSValue v = exec->uncheckedArgument(i);
+		jsarg &a = args[i];
+		memset(&a, 0, sizeof(jsarg));
+
+		if (v.isUndefined()) {
+			a.type = WK_JS_UNDEFINED;
+		} else if (v.isNull()) {
+			a.type = WK_JS_NULL;
+		} else if (v.isBoolean()) {
+			a.type = WK_JS_BOOL;
+			a.num = v.asBoolean();
+		} else if (v.isNumber()) {
+			a.type = WK_JS_NUMBER;
+			a.num = v.asNumber();
+		} else if (v.isString()) {
+			a.type = WK_JS_STRING;
+			strings.push_back(asString(v)->value(exec).utf8());
+			a.str = strings.back().data();
+			a.len = strings.back().length();
+		} else if (JSArrayBufferView * const tv = jsDynamicCast<JSArrayBufferView *>(v)) {
+			// This pins small typed arrays that still live in the GC heap
+			// to a buffer of their own, so the pointer stays put.
+			RefPtr<ArrayBufferView> impl = tv->impl();
+			a.type = WK_JS_BUFFER;
+			if (impl) {
+				a.buf = impl->baseAddress();
+				a.len = impl->byteLength();
+				views.push_back(impl.release());
+			}
+		} else if (JSArrayBuffer * const ab = jsDynamicCast<JSArrayBuffer *>(v)) {
+			a.type = WK_JS_BUFFER;
+			a.buf = ab->impl()->data();
+			a.len = ab->impl()->byteLength();
+			buffers.push_back(ab->impl());
+		} else {
+			a.type = WK_JS_OBJECT;
+			strings.push_back(JSONStringify(exec, v, 0).utf8());
+			if (exec->hadException())
+				return JSValue::encode(jsUndefined());
+			a.str = strings.back().data();
+			a.len = strings.back().length();
+		}
+	}
+
+	char * const ret = b->func(view, args.data(), argc, b->data);
+	if (!ret)
+		return JSValue::encode(jsUndefined());
+
+	const JSValue result = JSONParse(exec, String::fromUTF8(ret));
+	free(ret);
+	if (!result)
+		return throwVMError(exec, createSyntaxError(exec,
+				"Native function returned invalid JSON"));
+
+	return JSValue::encode(result);
+}
+
+CallType FlJSFunction::getCallData(JSCell *, CallData &callData) {
+	callData.native.function = callJSBinding;
+	return CallTypeHost;
+}
+
+static void defineJSBinding(webview *view, JSDOMWindow *window, const char *name) {
+
+	VM &vm = window->vm();
+	const String fname = String::fromUTF8(name);
+
+	window->putDirect(vm, Identifier::fromString(&vm, fname),
+			FlJSFunction::create(vm, window, fname, view), DontEnum);
+}
+
+void installJSBindings(webview *view, Frame &frame) {
+
+	if (view->priv->jsbindings.empty())
+		return;
+
+	JSDOMWindow * const window = frame.script().globalObject(mainThreadNormalWorld());
+	JSLockHolder lock(window->vm());
+
+	for (const jsbinding &b: view->priv->jsbindings)
+		defineJSBinding(view, window, b.name);
+}
+
+void installJSBinding(webview *view, Frame &frame, const char *name) {
+
+	if (!frame.script().existingWindowShell(mainThreadNormalWorld()))
+		return;
+
+	JSDOMWindow * const window = frame.script().globalObject(mainThreadNormalWorld());
+	JSLockHolder lock(window->vm());
+
+	defineJSBinding(view, window, name);
+}
+
+char *executeJSForResult(Frame &frame, const char *str) {
+
+	const Deprecated::ScriptValue ret = frame.script().executeScript(String::fromUTF8(str), true);
+	if (ret.hasNoValue())
+		return NULL;
+
+	JSDOMWindow * const window = frame.script().globalObject(mainThreadNormalWorld());
+	ExecState * const exec = window->globalExec();
+	JSLockHolder lock(exec);
+
+	const String json = JSONStringify(exec, ret.jsValue(), 0);
+	if (exec->hadException()) {
+		exec->clearException();
+		return NULL;
+	}
+	if (json.isNull())
+		return NULL;
+
+	return strdup(json.utf8().data());
+}
@@ -0,0 +1,40 @@
+/*
+WebkitFLTK
+Copyright (C) 2014 Lauri Kasanen
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, version 3 of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef jsbridge_h
+#define jsbridge_h
+
+#include "webview.h"
+
+#include <platform/PlatformExportMacros.h>
+#include <Frame.h>
+
+struct jsbinding {
+	char *name;
+	jsfunc func;
+	void *data;
+};
+
+// Define the view's native functions on the frame's window object.
+void installJSBindings(webview *, WebCore::Frame &);
+// Define or replace one, if the frame already has a window object.
+void installJSBinding(webview *, WebCore::Frame &, const char *name);
+
+// Run the script in the frame, and return its result as malloced JSON.
+char *executeJSForResult(WebCore::Frame &, const char *);
+
+#endif
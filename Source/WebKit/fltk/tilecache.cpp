@@ -0,0 +1,201 @@
+/*
+WebkitFLTK
+Copyright (C) 2014 Lauri Kasanen
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, version 3 of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "config.h"
+#include "tilecache.h"
+
+#include <FrameView.h>
+#include <GraphicsContext.h>
+#include <Page.h>
+#include <wtf/ParallelJobs.h>
+
+using namespace WebCore;
+
+static const unsigned tilesize = 256;
+
+struct tilejob {
+	cairo_surface_t **recordings;
+	cairo_surface_t **surfaces;
+	const IntRect *rects;
+	unsigned first, stride, count;
+};
+
+// A recording may only be replayed by one thread at a time, cairo
+// builds its index lazily during the replay.
+static void rastertiles(tilejob *job) {
+	for (unsigned i = job->first; i < job->count; i += job->stride) {
+		const IntRect &r = job->rects[i];
+
+		cairo_t *cr = cairo_create(job->surfaces[i]);
+		cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+		cairo_paint(cr);
+
+		cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+		cairo_translate(cr, -r.x(), -r.y());
+		cairo_set_source_surface(cr, job->recordings[i], 0, 0);
+		cairo_paint(cr);
+		cairo_destroy(cr);
+	}
+}
+
+static cairo_surface_t *record(Frame *f, const IntRect &r) {
+	const cairo_rectangle_t extents = { (double) r.x(), (double) r.y(),
+					(double) r.width(), (double) r.height() };
+	cairo_surface_t *rec = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA,
+								&extents);
+
+	cairo_t *cr = cairo_create(rec);
+	{
+		GraphicsContext gc(cr);
+		gc.applyDeviceScaleFactor(f->page()->deviceScaleFactor());
+		f->view()->paint(&gc, r);
+	}
+	cairo_destroy(cr);
+
+	return rec;
+}
+
+tilecache::tilecache(): recorded(0), replayed(0), w(0), h(0), cols(0), rows(0) {
+}
+
+tilecache::~tilecache() {
+	droprecordings();
+
+	const unsigned num = surfs.size();
+	for (unsigned i = 0; i < num; i++)
+		cairo_surface_destroy(surfs[i]);
+}
+
+void tilecache::droprecordings() {
+	const unsigned num = tiles.size();
+	for (unsigned i = 0; i < num; i++) {
+		if (tiles[i].recording)
+			cairo_surface_destroy(tiles[i].recording);
+		tiles[i].recording = NULL;
+		tiles[i].dirty = true;
+	}
+}
+
+void tilecache::resize(const unsigned inw, const unsigned inh) {
+	if (inw == w && inh == h)
+		return;
+
+	droprecordings();
+
+	w = inw;
+	h = inh;
+	cols = (w + tilesize - 1) / tilesize;
+	rows = (h + tilesize - 1) / tilesize;
+
+	const tile empty = { NULL, true };
+	tiles.assign(cols * rows, empty);
+}
+
+void tilecache::invalidate(const IntRect &in) {
+	IntRect r = in;
+	r.intersect(IntRect(0, 0, w, h));
+	if (r.isEmpty())
+		return;
+
+	const unsigned maxx = (r.maxX() - 1) / tilesize;
+	const unsigned maxy = (r.maxY() - 1) / tilesize;
+	for (unsigned y = r.y() / tilesize; y <= maxy; y++) {
+		for (unsigned x = r.x() / tilesize; x <= maxx; x++)
+			tiles[y * cols + x].dirty = true;
+	}
+}
+
+void tilecache::invalidateAll() {
+	const unsigned num = tiles.size();
+	for (unsigned i = 0; i < num; i++)
+		tiles[i].dirty = true;
+}
+
+void tilecache::paint(Frame *f, cairo_t *target, const IntRect &inclip,
+			const unsigned threads, const bool keep) {
+
+	IntRect clip = inclip;
+	clip.intersect(IntRect(0, 0, w, h));
+	recorded = replayed = 0;
+	if (clip.isEmpty())
+		return;
+
+	Vector<IntRect> rects;
+	Vector<cairo_surface_t *> recordings;
+
+	const unsigned maxx = (clip.maxX() - 1) / tilesize;
+	const unsigned maxy = (clip.maxY() - 1) / tilesize;
+	for (unsigned y = clip.y() / tilesize; y <= maxy; y++) {
+		for (unsigned x = clip.x() / tilesize; x <= maxx; x++) {
+			tile &t = tiles[y * cols + x];
+			const IntRect full(x * tilesize, y * tilesize,
+					std::min(tilesize, w - x * tilesize),
+					std::min(tilesize, h - y * tilesize));
+			IntRect part = full;
+			part.intersect(clip);
+
+			if (keep && t.recording && !t.dirty) {
+				replayed++;
+			} else {
+				if (t.recording)
+					cairo_surface_destroy(t.recording);
+
+				// A kept recording has to cover the whole tile
+				t.recording = record(f, keep ? full : part);
+				t.dirty = false;
+				recorded++;
+			}
+
+			rects.append(part);
+			recordings.append(t.recording);
+		}
+	}
+
+	const unsigned count = rects.size();
+	while (surfs.size() < count)
+		surfs.push_back(cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+						tilesize, tilesize));
+
+	// The target may have attached snapshots to the tile surfaces when they
+	// were last composited. Detach them here, not from the worker threads.
+	for (unsigned i = 0; i < count; i++)
+		cairo_surface_flush(surfs[i]);
+
+	ParallelJobs<tilejob> jobs(&rastertiles, std::min(std::max(threads, 1U), count));
+	const unsigned numjobs = jobs.numberOfJobs();
+	for (unsigned i = 0; i < numjobs; i++) {
+		tilejob &job = jobs.parameter(i);
+		job.recordings = recordings.data();
+		job.surfaces = &surfs[0];
+		job.rects = rects.data();
+		job.first = i;
+		job.stride = numjobs;
+		job.count = count;
+	}
+	jobs.execute();
+
+	for (unsigned i = 0; i < count; i++) {
+		const IntRect &r = rects[i];
+		cairo_set_source_surface(target, surfs[i], r.x(), r.y());
+		cairo_rectangle(target, r.x(), r.y(), r.width(), r.height());
+		cairo_fill(target);
+	}
+
+	if (!keep)
+		droprecordings();
+}
@@ -0,0 +1,62 @@
+/*
+WebkitFLTK
+Copyright (C) 2014 Lauri Kasanen
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, version 3 of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef tilecache_h
+#define tilecache_h
+
+#include <platform/PlatformExportMacros.h>
+#include <Frame.h>
+#include <IntRect.h>
+#include <cairo.h>
+#include <vector>
+
+// A grid of view-aligned tiles. Each tile keeps the cairo recording of its
+// last paint, which serves as its display list: tiles that were not
+// invalidated since are replayed without walking the render tree again.
+// Recording happens on the main thread, rasterization on up to n threads.
+class tilecache {
+public:
+	tilecache();
+	~tilecache();
+
+	void resize(const unsigned w, const unsigned h);
+	void invalidate(const WebCore::IntRect &);
+	void invalidateAll();
+
+	// Paint the clip area to target. Without keep, nothing is reused and
+	// the recordings are dropped after rasterizing.
+	void paint(WebCore::Frame *, cairo_t *target, const WebCore::IntRect &clip,
+			const unsigned threads, const bool keep);
+
+	// Tiles recorded and replayed from cache in the last paint
+	unsigned recorded, replayed;
+
+private:
+	struct tile {
+		cairo_surface_t *recording;
+		bool dirty;
+	};
+
+	void droprecordings();
+
+	std::vector<tile> tiles;
+	std::vector<cairo_surface_t *> surfs;
+	unsigned w, h, cols, rows;
+};
+
+#endif
@@ -0,0 +1,294 @@
+/*
+WebkitFLTK
+Copyright (C) 2014 Lauri Kasanen
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, version 3 of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include "trace.h"
+#include "webviewpriv.h"
+
+#include <InspectorController.h>
+#include <inspector/InspectorAgentBase.h>
+#include <inspector/InspectorFrontendChannel.h>
+#include <inspector/InspectorValues.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/HashMap.h>
+#include <wtf/Stopwatch.h>
+#include <wtf/text/CString.h>
+
+#include <algorithm>
+#include <stdio.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace Inspector;
+using namespace WebCore;
+using namespace WTF;
+
+static FILE *tracefile = NULL;
+static double tracestart;
+static unsigned tracetid;
+
+static std::vector<webview *> views;
+
+static void writeEvent(Ref<InspectorObject> &&event) {
+
+	event->setInteger("pid", getpid());
+	fprintf(tracefile, ",\n%s", event->toJSONString().utf8().data());
+}
+
+// Receives one view's protocol events. Each view is its own track, with
+// the agents' stopwatch offset to the start of the trace. The stopwatch is
+// never reset, so it starts from where the view's last trace left it.
+class tracechannel: public FrontendChannel {
+public:
+	tracechannel(const double stopwatchstart) {
+		tid = ++tracetid;
+		offset = monotonicallyIncreasingTime() - tracestart - stopwatchstart;
+
+		Ref<InspectorObject> args = InspectorObject::create();
+		args->setString("name", String::format("webview %u", tid));
+
+		Ref<InspectorObject> event = InspectorObject::create();
+		event->setString("name", "thread_name");
+		event->setString("ph", "M");
+		event->setInteger("tid", tid);
+		event->setObject("args", WTF::move(args));
+		writeEvent(WTF::move(event));
+	}
+
+	bool sendMessageToFrontend(const String &message) override;
+
+private:
+	Ref<InspectorObject> createEvent(const String &name, const char *cat,
+					const char *ph, double time) const {
+		Ref<InspectorObject> event = InspectorObject::create();
+		event->setString("name", name);
+		event->setString("cat", cat);
+		event->setString("ph", ph);
+		event->setDouble("ts", (offset + time) * 1000000);
+		event->setInteger("tid", tid);
+		return event;
+	}
+
+	void timelineRecord(const InspectorObject &record);
+	void networkEvent(const String &method, const InspectorObject &params);
+
+	unsigned tid;
+	double offset;
+	HashMap<String, String> requests;
+};
+
+static std::unordered_map<const webview *, tracechannel *> channels;
+
+void tracechannel::timelineRecord(const InspectorObject &record) {
+
+	String type;
+	double start, end;
+	if (!record.getString("type", type) || !record.getDouble("startTime", start))
+		return;
+
+	const bool complete = record.getDouble("endTime", end);
+	Ref<InspectorObject> event = createEvent(type, "timeline", complete ? "X" : "i", start);
+	if (complete)
+		event->setDouble("dur", (end - start) * 1000000);
+	else
+		event->setString("s", "t");
+
+	RefPtr<InspectorObject> data;
+	if (record.getObject("data", data))
+		event->setObject("args", WTF::move(data));
+	writeEvent(WTF::move(event));
+
+	RefPtr<InspectorArray> children;
+	if (!record.getArray("children", children))
+		return;
+
+	const unsigned max = children->length();
+	unsigned i;
+	for (i = 0; i < max; i++) {
+		RefPtr<InspectorObject> child;
+		if (children->get(i)->asObject(child))
+			timelineRecord(*child);
+	}
+}
+
+// Requests become async slices, from being sent to finishing or failing.
+void tracechannel::networkEvent(const String &method, const InspectorObject &params) {
+
+	String id;
+	double time;
+	if (!params.getString("requestId", id) || !params.getDouble("timestamp", time))
+		return;
+
+	if (method == "Network.requestWillBeSent") {
+		RefPtr<InspectorObject> request;
+		String url;
+		if (!params.getObject("request", request) || !request->getString("url", url))
+			return;
+		requests.set(id, url);
+
+		Ref<InspectorObject> event = createEvent(url, "network", "b", time);
+		event->setString("id", id);
+		event->setObject("args", WTF::move(request));
+		writeEvent(WTF::move(event));
+		return;
+	}
+
+	if (method == "Network.requestServedFromMemoryCache") {
+		String url;
+		if (!params.getString("documentURL", url))
+			return;
+		Ref<InspectorObject> event = createEvent(url, "network", "i", time);
+		event->setString("s", "t");
+		writeEvent(WTF::move(event));
+		return;
+	}
+
+	const auto it = requests.find(id);
+	if (it == requests.end())
+		return;
+
+	if (method == "Network.responseReceived") {
+		Ref<InspectorObject> event = createEvent(it->value, "network", "n", time);
+		event->setString("id", id);
+
+		RefPtr<InspectorObject> response;
+		if (params.getObject("response", response)) {
+			Ref<InspectorObject> args = InspectorObject::create();
+			RefPtr<InspectorValue> value;
+			if (response->getValue("status", value))
+				args->setValue("status", WTF::move(value));
+			if (response->getValue("mimeType", value))
+				args->setValue("mimeType", WTF::move(value));
+			event->setObject("args", WTF::move(args));
+		}
+		writeEvent(WTF::move(event));
+	} else if (method == "Network.loadingFinished" ||
+			method == "Network.loadingFailed") {
+		Ref<InspectorObject> event = createEvent(it->value, "network", "e", time);
+		event->setString("id", id);
+
+		String error;
+		if (params.getString("errorText", error)) {
+			Ref<InspectorObject> args = InspectorObject::create();
+			args->setString("error", error);
+			event->setObject("args", WTF::move(args));
+		}
+		writeEvent(WTF::move(event));
+		requests.remove(it);
+	}
+}
+
+bool tracechannel::sendMessageToFrontend(const String &message) {
+
+	RefPtr<InspectorValue> value;
+	RefPtr<InspectorObject> msg;
+	if (!InspectorValue::parseJSON(message, value) || !value->asObject(msg))
+		return true;
+
+	// Replies to our own commands carry an id, events do not
+	String method;
+	RefPtr<InspectorObject> params;
+	if (!msg->getString("method", method) || !msg->getObject("params", params))
+		return true;
+
+	if (method == "Timeline.eventRecorded") {
+		RefPtr<InspectorObject> record;
+		if (params->getObject("record", record))
+			timelineRecord(*record);
+	} else if (method.startsWith("Network.")) {
+		networkEvent(method, *params);
+	}
+
+	return true;
+}
+
+static void traceView(webview *view) {
+
+	InspectorController &ic = view->priv->page->inspectorController();
+	if (ic.hasFrontend())
+		return;
+
+	tracechannel * const c = new tracechannel(ic.executionStopwatch()->elapsedTime());
+	channels[view] = c;
+
+	ic.connectFrontend(c, false);
+	ic.dispatchMessageFromFrontend("{\"id\":1,\"method\":\"Timeline.start\"}");
+	ic.dispatchMessageFromFrontend("{\"id\":2,\"method\":\"Network.enable\"}");
+}
+
+static void untraceView(webview *view) {
+
+	const auto it = channels.find(view);
+	if (it == channels.end())
+		return;
+
+	InspectorController &ic = view->priv->page->inspectorController();
+	ic.dispatchMessageFromFrontend("{\"id\":3,\"method\":\"Timeline.stop\"}");
+	ic.dispatchMessageFromFrontend("{\"id\":4,\"method\":\"Network.disable\"}");
+	ic.disconnectFrontend(DisconnectReason::InspectorDestroyed);
+
+	delete it->second;
+	channels.erase(it);
+}
+
+bool startTrace(const char *path) {
+
+	if (tracefile || !path)
+		return false;
+
+	tracefile = fopen(path, "w");
+	if (!tracefile)
+		return false;
+
+	tracestart = monotonicallyIncreasingTime();
+	tracetid = 0;
+
+	fprintf(tracefile, "[{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+			"\"args\":{\"name\":\"WebkitFLTK\"}}", getpid());
+
+	for (webview *view: views)
+		traceView(view);
+
+	return true;
+}
+
+void stopTrace() {
+
+	if (!tracefile)
+		return;
+
+	for (webview *view: views)
+		untraceView(view);
+
+	fputs("\n]\n", tracefile);
+	fclose(tracefile);
+	tracefile = NULL;
+}
+
+void traceAttach(webview *view) {
+
+	views.push_back(view);
+	if (tracefile)
+		traceView(view);
+}
+
+void traceDetach(webview *view) {
+
+	untraceView(view);
+	views.erase(std::remove(views.begin(), views.end(), view), views.end());
+}
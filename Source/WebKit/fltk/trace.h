@@ -0,0 +1,35 @@
+/*
+WebkitFLTK
+Copyright (C) 2014 Lauri Kasanen
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, version 3 of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef trace_h
+#define trace_h
+
+#include "webview.h"
+
+// Tracing drives each view's inspector in-process: it connects as the
+// frontend, starts the timeline and network agents, and writes what they
+// report as Chrome trace events.
+
+bool startTrace(const char *path);
+void stopTrace();
+
+// Every view registers, so that a trace covers views created before it
+// started, and views created while it runs.
+void traceAttach(webview *);
+void traceDetach(webview *);
+
+#endif
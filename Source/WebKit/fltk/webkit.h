@@ -44,7 +44,8 @@ void wk_set_uploaddir_func(const char * (*func)());
 // Where to open files for downloading?
 void wk_set_downloaddir_func(const char * (*func)());
 
-// SSL control - return 1 if this cert is ok, 0 to abort
+// SSL control - return 1 if this cert is ok, 0 to abort. The answer is
+// remembered per host and cert until the func is set again.
 void wk_set_ssl_func(int (*func)(const char *, const char *));
 
 // Inform the browser of which tab needs a scary SSL warning
@@ -65,13 +66,17 @@ void wk_set_download_refresh_func(void (*func)());
 // Callback for when a new download has been started
 void wk_set_new_download_func(void (*func)());
 
+// Fetch large downloads over this many parallel connections, if the server
+// supports ranges. Default 4, 1 disables.
+void wk_set_download_segments(const unsigned num);
+
 // Page requests a popup to this address
 void wk_set_popup_func(webview *(*func)(const char*));
 
 // Please open this address in a background tab
 void wk_set_bgtab_func(void (*func)(const char*));
 
-// Drop RAM caches
+// Drop RAM caches, and return the freed heap memory to the OS
 void wk_drop_caches();
 
 // Set streaming program and args, default none
@@ -95,9 +100,141 @@ Fl_RGB_Image *wk_get_favicon(const char *url, const unsigned targetsize = 16);
 void wk_set_cache_dir(const char *dir);
 void wk_set_cache_max(const unsigned bytes);
 
+// HTTP disk cache, shared by all webviews and kept over runs. Identical
+// bodies are stored once, whichever URLs they came from. Off until a dir
+// is set; set the max, default 50 MB, before it.
+void wk_set_disk_cache_dir(const char *dir);
+void wk_set_disk_cache_max(const unsigned long bytes);
+
+// Rasterize large repaints in tiles on this many threads. Default 1, no tiling.
+void wk_set_paint_threads(const unsigned threads);
+// Keep each tile's recorded display list, and replay it instead of
+// painting the page again while the tile's content is unchanged. Default off.
+void wk_set_paint_cache(const bool on);
+// Composite layers with transform and opacity animations separately, so that
+// animating them doesn't repaint the page. Default on, affects new webviews.
+void wk_set_layer_compositing(const bool on);
+
+// Persistent localStorage. Without a dir, it's kept in RAM per site.
+// Set before creating any webviews.
+void wk_set_localstorage_dir(const char *dir);
+
+struct wk_storage_stats {
+	unsigned imports;
+	double import_time, max_import_time; // seconds
+	double blocked_time; // main thread waiting for imports, seconds
+
+	unsigned sync_backlog; // items not yet on disk
+	unsigned syncs, synced_items;
+};
+void wk_get_storage_stats(struct wk_storage_stats *out);
+
+// HTTP(S) requests since startup. HTTP/2 is used where the server offers it
+// over TLS, multiplexing requests to a host over one connection.
+struct wk_network_stats {
+	unsigned long long requests;
+	unsigned long long new_connections;
+	unsigned long long reused_connections; // requests over an open connection
+	unsigned long long tls_handshakes;
+	unsigned long long http2_requests;
+	unsigned long long preconnects; // their connections count as new
+	unsigned long long bytes_received;
+};
+void wk_get_network_stats(struct wk_network_stats *out);
+
+// Bytes the loader's buffers copied, against those they passed on by
+// reference. Received data is copied out of curl once, and ideally only
+// copied again when merged for a decoder that needs it in one piece.
+struct wk_buffer_stats {
+	unsigned long long bytes_copied;
+	unsigned long long bytes_shared;
+	unsigned long long bytes_flattened;
+};
+void wk_get_buffer_stats(struct wk_buffer_stats *out);
+
+// Compressed response bodies since startup. They're decoded on a thread of
+// their own; decode_ms is the time it spent on them.
+struct wk_decoding_stats {
+	unsigned long long responses;
+	unsigned long long encoded_bytes;
+	unsigned long long decoded_bytes;
+	double decode_ms;
+};
+void wk_get_decoding_stats(struct wk_decoding_stats *out);
+
+// Where the main thread's time went, totals since startup. Scripts count
+// the layouts they force, paints are the views' own drawing.
+struct wk_timing_stats {
+	unsigned long long layouts, scripts, paints;
+	double layout_ms, script_ms, paint_ms;
+};
+void wk_get_timing_stats(struct wk_timing_stats *out);
+
+// Record the HTTP(S) responses of all loads, bodies and timing included,
+// to an archive file. NULL stops recording.
+void wk_set_record(const char *archive);
+
+// Serve HTTP(S) loads from a recorded archive instead of the network, each
+// response after latency_ms (-1: as long as it took when recorded), with
+// the bodies sharing kbps kB/s (0: unlimited). Requests not in the archive
+// fail. Calling this again starts the archive over, NULL goes back to the
+// network. Returns false if the archive can't be read.
+bool wk_set_replay(const char *archive, const int latency_ms, const unsigned kbps);
+
+// Links marked rel=preconnect get a connection opened ahead of time. This
+// also does it for links hovered with the mouse. Default off.
+void wk_set_hover_preconnect(const bool on);
+
+// Synchronous loads (sync XHR) block their page's script. Views are still
+// repainted meanwhile, but input waits. Give up after this many seconds,
+// unless the request asks for less. Default 60, 0 waits forever.
+void wk_set_sync_timeout(const unsigned seconds);
+
+// Renderers, line boxes and style data are allocated from per-document arenas
+// during style recalc and layout. Counts are totals since startup.
+struct wk_render_arena_stats {
+	unsigned long long arena_allocs; // objects allocated from an arena
+	unsigned long long reused; // of those, reusing a freed object
+	unsigned long long mallocs; // outside an arena, or too big for one
+	unsigned long long chunks; // the arenas' own mallocs
+
+	unsigned arenas;
+	unsigned long chunk_bytes, live_bytes;
+};
+void wk_get_render_arena_stats(struct wk_render_arena_stats *out);
+
+// The malloc heap, in bytes. Small objects are up to 256 bytes, medium up
+// to 1 kB, and huge ones over 15 MB. Small and medium used memory includes
+// objects cached by threads. Committed memory that is neither used nor
+// free is fragmentation, lines and pages with only some objects in use.
+#define WK_MEMORY_SIZE_CLASSES 128
+struct wk_memory_stats {
+	unsigned long small_used, small_free, small_committed;
+	unsigned long medium_used, medium_free, medium_committed;
+	unsigned long large_used, large_free;
+	unsigned long huge_used;
+
+	unsigned long reserved, committed, fragmentation;
+
+	// Used small and medium memory, in 8-byte steps of object size
+	unsigned long size_classes[WK_MEMORY_SIZE_CLASSES];
+};
+void wk_get_memory_stats(struct wk_memory_stats *out);
+
+// Free heap memory goes back to the OS after the heap has gone this long
+// without growing, except for the retained bytes, kept for reuse.
+// Default 0.5 s and 0. wk_drop_caches releases everything at once.
+void wk_set_memory_scavenger(const float delay, const unsigned long retained);
+
 // Per-site settings
 void wk_set_persite_settings_func(void (*func)(const char*));
 
+// Record layout, style, paint, script and network activity in all views
+// to a Chrome trace-event JSON file, for about:tracing or Perfetto.
+// Returns false if the file can't be created or a trace is already running.
+bool wk_start_trace(const char *path);
+void wk_stop_trace();
+
 // Maximum image size. Default is 1024, meaning 1024^2 pixels. Larger ones get resized.
 void wk_set_image_max(const unsigned size);
 
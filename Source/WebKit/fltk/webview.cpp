@@ -18,6 +18,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "config.h"
 
 #include "kbd.h"
+#include "trace.h"
 #include "webview.h"
 #include "webviewpriv.h"
 
@@ -27,6 +28,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <FL/fl_draw.H>
 #include <FL/Fl_File_Chooser.H>
 #include <FL/Fl_Menu_Item.H>
+#include <FL/x.H>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -66,6 +68,12 @@ using namespace WebCore;
 extern int wheelspeed;
 extern const char * (*downloaddirfunc)();
 extern void (*newdownloadfunc)();
+extern const char *wk_localstoragedir;
+extern unsigned wk_paint_threads;
+extern bool wk_paint_cache;
+extern bool wk_layer_compositing;
+extern unsigned long long wk_paint_count;
+extern double wk_paint_time;
 
 webview::webview(int x, int y, int w, int h, bool noGui): Fl_Widget(x, y, w, h),
 			noGUI(noGui) {
@@ -73,6 +81,8 @@ webview::webview(int x, int y, int w, int h, bool noGui): Fl_Widget(x, y, w, h),
 	priv = new privatewebview;
 	priv->gc = NULL;
 	priv->cairo = NULL;
+	priv->cairopix = 0;
+	priv->painted = false;
 	priv->w = w;
 	priv->h = h;
 	priv->editing = priv->hoveringlink = false;
@@ -86,6 +96,7 @@ webview::webview(int x, int y, int w, int h, bool noGui): Fl_Widget(x, y, w, h),
 	priv->siteChanging = NULL;
 	priv->error = NULL;
 	priv->resourceStateChanged = NULL;
+	priv->visuallyNonEmpty = NULL;
 	priv->quietdiags = false;
 
 	Fl_Widget *wid = this;
@@ -103,7 +114,8 @@ webview::webview(int x, int y, int w, int h, bool noGui): Fl_Widget(x, y, w, h),
 
 	//clients.applicationCacheStorage
 	clients.databaseProvider = &WebDatabaseProvider::singleton();
-	clients.storageNamespaceProvider = WebStorageNamespaceProvider::create(String());
+	clients.storageNamespaceProvider = WebStorageNamespaceProvider::create(
+			wk_localstoragedir ? String::fromUTF8(wk_localstoragedir) : String());
 	//clients.userContentController
 	clients.visitedLinkStore = &WebVisitedLinkStore::singleton();
 
@@ -153,7 +165,7 @@ webview::webview(int x, int y, int w, int h, bool noGui): Fl_Widget(x, y, w, h),
 	set.setDefaultFontSize(16);
 	set.setDefaultFixedFontSize(16);
 	set.setDownloadableBinaryFontsEnabled(false);
-	set.setAcceleratedCompositingEnabled(false);
+	set.setAcceleratedCompositingEnabled(wk_layer_compositing);
 
 	priv->page->focusController().setActive(true);
 	priv->page->focusController().setFocusedFrame(&priv->page->mainFrame());
@@ -162,6 +174,26 @@ webview::webview(int x, int y, int w, int h, bool noGui): Fl_Widget(x, y, w, h),
 	resize();
 
 	clock_gettime(CLOCK_MONOTONIC, &priv->lastdraw);
+
+	traceAttach(this);
+}
+
+// Set while fl_sync_wait redraws exposed windows.
+static bool syncwaiting;
+
+static void redrawLater(void *ptr) {
+	((webview *) ptr)->redraw();
+}
+
+static void animationFrame(void *ptr) {
+
+	webview * const view = (webview *) ptr;
+	const IntRect rect = view->priv->compositor.tick();
+	if (rect.isEmpty())
+		return;
+
+	view->damage(FL_DAMAGE_EXPOSE, rect.x() + view->x(), rect.y() + view->y(),
+			rect.width(), rect.height());
 }
 
 webview::~webview() {
@@ -174,7 +206,15 @@ webview::~webview() {
 	if (priv->gc)
 		delete priv->gc;
 
+	Fl::remove_timeout(animationFrame, this);
+	Fl::remove_timeout(redrawLater, this);
+
+	traceDetach(this);
 	delete priv->page;
+
+	for (const jsbinding &b: priv->jsbindings)
+		free(b.name);
+
 	delete priv;
 }
 
@@ -192,6 +232,22 @@ void webview::draw() {
 		return;
 	}
 
+	int cx, cy, cw, ch;
+	fl_clip_box(x(), y(), w(), h(), cx, cy, cw, ch);
+	if (!cw) return;
+
+	// A script may be waiting on a synchronous load, so layout can't run.
+	// Put back what was there, and paint again once the load is done.
+	if (syncwaiting) {
+		if (!Fl::has_timeout(redrawLater, this))
+			Fl::add_timeout(0, redrawLater, this);
+
+		if (priv->cairopix && priv->painted)
+			XCopyArea(fl_display, priv->cairopix, fl_window, fl_gc,
+					cx - x(), cy - y(), cw, ch, cx, cy);
+		return;
+	}
+
 	// Don't draw at over 60 fps. Save power and penguins.
 	struct timespec now;
 	clock_gettime(CLOCK_MONOTONIC, &now);
@@ -201,15 +257,13 @@ void webview::draw() {
 	if (usecs < 16600)
 		usleep(16600 - usecs);
 
-	int cx, cy, cw, ch;
-	fl_clip_box(x(), y(), w(), h(), cx, cy, cw, ch);
-	if (!cw) return;
 	priv->clipx = cx - x();
 	priv->clipy = cy - y();
 	priv->clipw = cw;
 	priv->cliph = ch;
 
 	drawWeb(); // for now here
+	priv->painted = true;
 
 	const int tgtx = cx, tgty = cy;
 
@@ -230,11 +284,29 @@ void webview::drawWeb() {
 		return;
 
 	f->view()->updateLayoutAndStyleIfNeededRecursive();
+	const double paintstart = monotonicallyIncreasingTime();
+	priv->compositor.flush(*f->view());
+
+	// Without the cache, small updates aren't worth the recording overhead.
+	const IntRect clip(priv->clipx, priv->clipy, priv->clipw, priv->cliph);
+	if (wk_paint_cache || (wk_paint_threads > 1 && clip.width() * clip.height() > 512 * 512)) {
+		priv->tiles.paint(f, priv->cairo, clip, wk_paint_threads, wk_paint_cache);
+	} else {
+		priv->gc->applyDeviceScaleFactor(f->page()->deviceScaleFactor());
+		f->view()->paint(priv->gc, clip);
+	}
+
+	if (priv->compositor.active()) {
+		priv->compositor.composite(*priv->gc, clip);
+		if (priv->compositor.animating() && !noGUI &&
+			!Fl::has_timeout(animationFrame, this))
+			Fl::add_timeout(1 / 60.0, animationFrame, this);
+	}
 
-	priv->gc->applyDeviceScaleFactor(f->page()->deviceScaleFactor());
-	f->view()->paint(priv->gc, IntRect(priv->clipx, priv->clipy,
-						priv->clipw, priv->cliph));
 	priv->page->inspectorController().drawHighlight(*priv->gc);
+
+	wk_paint_count++;
+	wk_paint_time += monotonicallyIncreasingTime() - paintstart;
 }
 
 void webview::load(const char *url) {
@@ -296,6 +368,8 @@ void webview::resize() {
 		priv->h = h();
 	}
 
+	priv->tiles.resize(priv->w, priv->h);
+
 	if (noGUI) {
 		cairo_surface_t *surf = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, w(), h());
 		priv->cairo = cairo_create(surf);
@@ -315,6 +389,7 @@ void webview::resize() {
 		XFreePixmap(fl_display, priv->cairopix);
 	priv->cairopix = XCreatePixmap(fl_display, DefaultRootWindow(fl_display),
 					priv->w, priv->h, priv->depth);
+	priv->painted = false;
 
 	cairo_surface_t *surf = cairo_xlib_surface_create(fl_display, priv->cairopix,
 								fl_visual->visual,
@@ -746,6 +821,12 @@ void webview::stopDownload(const unsigned i) {
 	priv->downloads[i]->stop();
 }
 
+void webview::resumeDownload(const unsigned i) {
+	if (i >= priv->downloads.size())
+		return;
+	priv->downloads[i]->resume();
+}
+
 void webview::removeDownload(const unsigned i) {
 	if (i >= priv->downloads.size())
 		return;
@@ -830,6 +911,10 @@ void webview::resourceStateChangedCB(void (*func)(unsigned long id, bool finishe
 	priv->resourceStateChanged = func;
 }
 
+void webview::visuallyNonEmptyCB(void (*func)(webview *)) {
+	priv->visuallyNonEmpty = func;
+}
+
 void webview::back() {
 	if (!canBack())
 		return;
@@ -1032,6 +1117,36 @@ void webview::executeJS(const char *str) {
 	f->script().executeScript(String::fromUTF8(str), true);
 }
 
+char *webview::executeJSResult(const char *str) {
+
+	if (!str)
+		return NULL;
+
+	return executeJSForResult(priv->page->mainFrame(), str);
+}
+
+void webview::addJSFunction(const char *name, jsfunc func, void *data) {
+
+	if (!name || !func)
+		return;
+
+	std::vector<jsbinding>::iterator it;
+	for (it = priv->jsbindings.begin(); it != priv->jsbindings.end(); it++) {
+		if (!strcmp(it->name, name))
+			break;
+	}
+
+	if (it == priv->jsbindings.end()) {
+		const jsbinding b = { strdup(name), func, data };
+		priv->jsbindings.push_back(b);
+	} else {
+		it->func = func;
+		it->data = data;
+	}
+
+	installJSBinding(this, priv->page->mainFrame(), name);
+}
+
 // Settings
 
 void webview::setBool(const SettingBool item, const bool val) {
@@ -1363,3 +1478,21 @@ unsigned webview::getLinkDetails(const char *cssclass, char **hrefs, char **text
 bool webview::isNoGui() const {
 	return noGUI;
 }
+
+// Called while a synchronous load waits. Only exposed windows are redrawn:
+// input and timers would run script, and the waiting page's is mid-call.
+// Views just put back their last paint, see webview::draw.
+void fl_sync_wait() {
+
+	// Only noGUI views, nothing to redraw
+	if (!fl_display)
+		return;
+
+	XEvent ev;
+	while (XCheckTypedEvent(fl_display, Expose, &ev))
+		fl_handle(ev);
+
+	syncwaiting = true;
+	Fl::flush();
+	syncwaiting = false;
+}
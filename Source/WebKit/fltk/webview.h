@@ -46,6 +46,33 @@ enum SettingChar {
 	WK_SETTING_USER_CSS,
 };
 
+enum JSArgType {
+	WK_JS_UNDEFINED = 0,
+	WK_JS_NULL,
+	WK_JS_BOOL,
+	WK_JS_NUMBER,
+	WK_JS_STRING,
+	WK_JS_BUFFER,
+	WK_JS_OBJECT,
+};
+
+// An argument from page JS to a native function. Booleans and numbers are
+// in num. Strings are UTF-8, and objects and arrays arrive as JSON in str. Typed arrays, DataViews and
+// ArrayBuffers are not copied: buf points to their contents, and is only
+// valid until the function returns.
+struct jsarg {
+	JSArgType type;
+	double num;
+	const char *str;
+	void *buf;
+	unsigned len; // bytes in str or buf
+};
+
+class webview;
+
+// Return malloced JSON for the JS return value, or NULL for undefined.
+typedef char *(*jsfunc)(webview *, const jsarg *args, unsigned argc, void *data);
+
 class webview: public Fl_Widget {
 public:
 	webview(int x, int y, int w, int h, bool noGui = false);
@@ -81,10 +108,18 @@ public:
 	char *focusedSource() const;
 
 	void executeJS(const char *);
+	// Return the malloced JSON of the script's result. NULL if it threw,
+	// or the result has no JSON form, like undefined or a function.
+	char *executeJSResult(const char *);
+	// Make func callable as window.name() from the main frame's JS, on this
+	// and every later page. Adding a name again replaces the function.
+	void addJSFunction(const char *name, jsfunc func, void *data = NULL);
 
 	// Download handling
 	unsigned numDownloads() const;
 	void stopDownload(const unsigned);
+	// Continue a failed or stopped download from where it was
+	void resumeDownload(const unsigned);
 	void removeDownload(const unsigned);
 	bool downloadFinished(const unsigned) const;
 	bool downloadFailed(const unsigned) const;
@@ -139,6 +174,8 @@ public:
 	void siteChangingCB(void (*func)(webview *, const char *url));
 	void errorCB(void (*error)(webview *, const char *err));
 	void resourceStateChangedCB(void (*resourceStateChanged)(unsigned long id, bool finished));
+	// Called once per load, when the page first has content worth painting
+	void visuallyNonEmptyCB(void (*func)(webview *));
 
 	// Bind a callback to element action. Call after loading has finished.
 	void bindEvent(const char *element, const char *type, const char *event,
@@ -19,13 +19,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define webviewpriv_h
 
 #include "chromeclient.h"
+#include "compositor.h"
 #include "contextclient.h"
 #include "download.h"
 #include "dragclient.h"
 #include "editorclient.h"
 #include "inspectorclient.h"
 #include "frameclient.h"
+#include "jsbridge.h"
 #include "progressclient.h"
+#include "tilecache.h"
 
 #include <EventHandler.h>
 #include <GraphicsContext.h>
@@ -46,6 +49,9 @@ public:
 	cairo_surface_t *cairosurf;
 	WebCore::GraphicsContext *gc;
 	Pixmap cairopix;
+	bool painted; // cairopix holds a paint of its current size
+	tilecache tiles;
+	layercompositor compositor;
 
 	Fl_Window *window;
 	unsigned depth;
@@ -66,6 +72,8 @@ public:
 
 	std::vector<download *> downloads;
 
+	std::vector<jsbinding> jsbindings;
+
 	std::unordered_set<int> pressedkeys;
 
 	// Callbacks
@@ -78,6 +86,7 @@ public:
 	void (*siteChanging)(webview *, const char *url);
 	void (*error)(webview *, const char *err);
 	void (*resourceStateChanged)(unsigned long id, bool finished);
+	void (*visuallyNonEmpty)(webview *);
 };
 
 #endif
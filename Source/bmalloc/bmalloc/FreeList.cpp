@@ -136,5 +136,15 @@ void FreeList::removeInvalidAndDuplicateEntries(Owner owner)
     }
 }
 
+size_t FreeList::freeBytes(Owner owner)
+{
+    removeInvalidAndDuplicateEntries(owner);
+
+    size_t result = 0;
+    for (auto& range : m_vector)
+        result += range.size();
+    return result;
+}
+
 
 } // namespace bmalloc
@@ -45,6 +45,9 @@ public:
     LargeObject takeGreedy(Owner);
 
     void removeInvalidAndDuplicateEntries(Owner);
+
+    // Garbage collects the list, and returns the total size of its objects.
+    size_t freeBytes(Owner);
     
 private:
     Vector<Range> m_vector;
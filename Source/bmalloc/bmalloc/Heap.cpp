@@ -37,7 +37,13 @@ namespace bmalloc {
 
 Heap::Heap(std::lock_guard<StaticMutex>&)
     : m_largeObjects(Owner::Heap)
+    , m_objectCounts()
+    , m_smallPageCount(0)
+    , m_mediumPageCount(0)
+    , m_largeBytesInUse(0)
     , m_isAllocatingPages(false)
+    , m_scavengeSleepDuration(scavengeSleepDuration)
+    , m_scavengeRetainedBytes(0)
     , m_scavenger(*this, &Heap::concurrentScavenge)
 {
     initializeLineMetadata();
@@ -81,32 +87,40 @@ void Heap::initializeLineMetadata()
 void Heap::concurrentScavenge()
 {
     std::unique_lock<StaticMutex> lock(PerProcess<Heap>::mutex());
-    scavenge(lock, scavengeSleepDuration);
+    scavenge(lock, m_scavengeSleepDuration, m_scavengeRetainedBytes);
 }
 
-void Heap::scavenge(std::unique_lock<StaticMutex>& lock, std::chrono::milliseconds sleepDuration)
+void Heap::scavenge(std::unique_lock<StaticMutex>& lock, std::chrono::milliseconds sleepDuration, size_t retainedBytes)
 {
     waitUntilFalse(lock, sleepDuration, m_isAllocatingPages);
 
-    scavengeSmallPages(lock, sleepDuration);
-    scavengeMediumPages(lock, sleepDuration);
+    scavengeSmallPages(lock, sleepDuration, retainedBytes);
+    scavengeMediumPages(lock, sleepDuration, retainedBytes);
     scavengeLargeObjects(lock, sleepDuration);
 
     sleep(lock, sleepDuration);
 }
 
-void Heap::scavengeSmallPages(std::unique_lock<StaticMutex>& lock, std::chrono::milliseconds sleepDuration)
+void Heap::setScavengerParameters(std::lock_guard<StaticMutex>&, std::chrono::milliseconds sleepDuration, size_t retainedBytes)
 {
-    while (m_smallPages.size()) {
+    m_scavengeSleepDuration = sleepDuration;
+    m_scavengeRetainedBytes = retainedBytes;
+}
+
+void Heap::scavengeSmallPages(std::unique_lock<StaticMutex>& lock, std::chrono::milliseconds sleepDuration, size_t retainedBytes)
+{
+    while (m_smallPages.size() && freePageBytes() > retainedBytes) {
         m_vmHeap.deallocateSmallPage(lock, m_smallPages.pop());
+        --m_smallPageCount;
         waitUntilFalse(lock, sleepDuration, m_isAllocatingPages);
     }
 }
 
-void Heap::scavengeMediumPages(std::unique_lock<StaticMutex>& lock, std::chrono::milliseconds sleepDuration)
+void Heap::scavengeMediumPages(std::unique_lock<StaticMutex>& lock, std::chrono::milliseconds sleepDuration, size_t retainedBytes)
 {
-    while (m_mediumPages.size()) {
+    while (m_mediumPages.size() && freePageBytes() > retainedBytes) {
         m_vmHeap.deallocateMediumPage(lock, m_mediumPages.pop());
+        --m_mediumPageCount;
         waitUntilFalse(lock, sleepDuration, m_isAllocatingPages);
     }
 }
@@ -152,6 +166,7 @@ void Heap::refillSmallBumpRangeCache(std::lock_guard<StaticMutex>& lock, size_t
             page->ref(lock);
         }
 
+        m_objectCounts[sizeClass] += objectCount;
         rangeCache.push({ begin, objectCount });
     }
 }
@@ -189,6 +204,7 @@ void Heap::refillMediumBumpRangeCache(std::lock_guard<StaticMutex>& lock, size_t
             page->ref(lock);
         }
 
+        m_objectCounts[sizeClass] += objectCount;
         rangeCache.push({ begin, objectCount });
     }
 }
@@ -208,6 +224,7 @@ SmallPage* Heap::allocateSmallPage(std::lock_guard<StaticMutex>& lock, size_t si
             return m_smallPages.pop();
 
         m_isAllocatingPages = true;
+        ++m_smallPageCount;
         return m_vmHeap.allocateSmallPage();
     }();
 
@@ -230,6 +247,7 @@ MediumPage* Heap::allocateMediumPage(std::lock_guard<StaticMutex>& lock, size_t
             return m_mediumPages.pop();
 
         m_isAllocatingPages = true;
+        ++m_mediumPageCount;
         return m_vmHeap.allocateMediumPage();
     }();
 
@@ -338,6 +356,7 @@ void* Heap::allocateLarge(std::lock_guard<StaticMutex>&, LargeObject& largeObjec
     }
 
     largeObject.setFree(false);
+    m_largeBytesInUse += largeObject.size();
     return largeObject.begin();
 }
 
@@ -389,6 +408,7 @@ void Heap::deallocateLarge(std::lock_guard<StaticMutex>&, const LargeObject& lar
 {
     BASSERT(!largeObject.isFree());
     largeObject.setFree(true);
+    m_largeBytesInUse -= largeObject.size();
     
     LargeObject merged = largeObject.merge();
     m_largeObjects.insert(merged);
@@ -401,4 +421,35 @@ void Heap::deallocateLarge(std::lock_guard<StaticMutex>& lock, void* object)
     deallocateLarge(lock, largeObject);
 }
 
+HeapStatistics Heap::statistics(std::lock_guard<StaticMutex>&)
+{
+    HeapStatistics statistics;
+
+    statistics.smallInUse = 0;
+    statistics.mediumInUse = 0;
+    for (size_t sizeClass = 0; sizeClass < m_objectCounts.size(); ++sizeClass) {
+        size_t bytes = m_objectCounts[sizeClass] * objectSize(sizeClass);
+        statistics.sizeClassInUse[sizeClass] = bytes;
+        if (objectSize(sizeClass) <= smallMax)
+            statistics.smallInUse += bytes;
+        else
+            statistics.mediumInUse += bytes;
+    }
+
+    statistics.smallFree = m_smallPages.size() * vmPageSize;
+    statistics.smallCommitted = m_smallPageCount * vmPageSize;
+    statistics.mediumFree = m_mediumPages.size() * vmPageSize;
+    statistics.mediumCommitted = m_mediumPageCount * vmPageSize;
+
+    statistics.largeInUse = m_largeBytesInUse;
+    statistics.largeFree = m_largeObjects.freeBytes();
+
+    statistics.xLargeInUse = 0;
+    for (auto& range : m_xLargeObjects)
+        statistics.xLargeInUse += range.size();
+
+    statistics.reserved = m_vmHeap.reservedBytes() + statistics.xLargeInUse;
+    return statistics;
+}
+
 } // namespace bmalloc
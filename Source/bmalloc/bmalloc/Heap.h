@@ -28,6 +28,7 @@
 
 #include "BumpRange.h"
 #include "Environment.h"
+#include "HeapStatistics.h"
 #include "LineMetadata.h"
 #include "MediumChunk.h"
 #include "MediumLine.h"
@@ -69,7 +70,16 @@ public:
     Range& findXLarge(std::unique_lock<StaticMutex>&, void*);
     void deallocateXLarge(std::unique_lock<StaticMutex>&, void*);
 
-    void scavenge(std::unique_lock<StaticMutex>&, std::chrono::milliseconds sleepDuration);
+    // Returns free pages and large objects to the OS, pausing whenever the heap
+    // allocates pages. Up to retainedBytes of free small and medium pages stay
+    // committed for reuse.
+    void scavenge(std::unique_lock<StaticMutex>&, std::chrono::milliseconds sleepDuration, size_t retainedBytes);
+
+    // The background scavenger waits for sleepDuration without page allocation
+    // before it starts, and between steps.
+    void setScavengerParameters(std::lock_guard<StaticMutex>&, std::chrono::milliseconds sleepDuration, size_t retainedBytes);
+
+    HeapStatistics statistics(std::lock_guard<StaticMutex>&);
 
 private:
     ~Heap() = delete;
@@ -91,8 +101,10 @@ private:
     void mergeLargeRight(EndTag*&, BeginTag*&, Range&, bool& inVMHeap);
     
     void concurrentScavenge();
-    void scavengeSmallPages(std::unique_lock<StaticMutex>&, std::chrono::milliseconds);
-    void scavengeMediumPages(std::unique_lock<StaticMutex>&, std::chrono::milliseconds);
+    size_t freePageBytes() { return (m_smallPages.size() + m_mediumPages.size()) * vmPageSize; }
+
+    void scavengeSmallPages(std::unique_lock<StaticMutex>&, std::chrono::milliseconds, size_t retainedBytes);
+    void scavengeMediumPages(std::unique_lock<StaticMutex>&, std::chrono::milliseconds, size_t retainedBytes);
     void scavengeLargeObjects(std::unique_lock<StaticMutex>&, std::chrono::milliseconds);
 
     std::array<std::array<LineMetadata, SmallPage::lineCount>, smallMax / alignment> m_smallLineMetadata;
@@ -107,8 +119,17 @@ private:
     SegregatedFreeList m_largeObjects;
     Vector<Range> m_xLargeObjects;
 
+    // Objects handed to per-thread allocators, per size class
+    std::array<size_t, mediumMax / alignment> m_objectCounts;
+    size_t m_smallPageCount;
+    size_t m_mediumPageCount;
+    size_t m_largeBytesInUse;
+
     bool m_isAllocatingPages;
 
+    std::chrono::milliseconds m_scavengeSleepDuration;
+    size_t m_scavengeRetainedBytes;
+
     Environment m_environment;
 
     VMHeap m_vmHeap;
@@ -117,6 +138,7 @@ private:
 
 inline void Heap::derefSmallLine(std::lock_guard<StaticMutex>& lock, SmallLine* line)
 {
+    --m_objectCounts[SmallPage::get(line)->sizeClass()];
     if (!line->deref(lock))
         return;
     deallocateSmallLine(lock, line);
@@ -124,6 +146,7 @@ inline void Heap::derefSmallLine(std::lock_guard<StaticMutex>& lock, SmallLine*
 
 inline void Heap::derefMediumLine(std::lock_guard<StaticMutex>& lock, MediumLine* line)
 {
+    --m_objectCounts[MediumPage::get(line)->sizeClass()];
     if (!line->deref(lock))
         return;
     deallocateMediumLine(lock, line);
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2015 Lauri Kasanen
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HeapStatistics_h
+#define HeapStatistics_h
+
+#include "Sizes.h"
+#include <array>
+
+namespace bmalloc {
+
+// A snapshot of the process heap, in bytes. Small and medium objects count as
+// in use from the time a thread's allocator takes them from the heap, so they
+// include objects sitting unused in per-thread caches. Committed pages that are
+// neither in use nor free are fragmentation: partially used lines and pages.
+struct HeapStatistics {
+    size_t smallInUse;
+    size_t smallFree; // empty pages, awaiting the scavenger
+    size_t smallCommitted;
+
+    size_t mediumInUse;
+    size_t mediumFree;
+    size_t mediumCommitted;
+
+    size_t largeInUse;
+    size_t largeFree; // committed, in the heap's free list
+
+    size_t xLargeInUse;
+
+    size_t reserved; // address space, committed or not
+
+    std::array<size_t, mediumMax / alignment> sizeClassInUse;
+};
+
+} // namespace bmalloc
+
+#endif // HeapStatistics_h
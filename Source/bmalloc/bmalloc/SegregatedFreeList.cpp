@@ -52,6 +52,14 @@ LargeObject SegregatedFreeList::takeGreedy()
     return LargeObject();
 }
 
+size_t SegregatedFreeList::freeBytes()
+{
+    size_t result = 0;
+    for (auto& list : m_freeLists)
+        result += list.freeBytes(m_owner);
+    return result;
+}
+
 LargeObject SegregatedFreeList::take(size_t size)
 {
     for (auto* list = &select(size); list != m_freeLists.end(); ++list) {
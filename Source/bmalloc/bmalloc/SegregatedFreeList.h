@@ -56,6 +56,10 @@ public:
     // the returned object from the free list.
     LargeObject takeGreedy();
 
+    // Returns the total size of the free objects. Removes stale and duplicate
+    // items from the free list while counting.
+    size_t freeBytes();
+
 private:
     FreeList& select(size_t);
 
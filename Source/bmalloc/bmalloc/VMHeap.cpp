@@ -34,12 +34,14 @@ namespace bmalloc {
 
 VMHeap::VMHeap()
     : m_largeObjects(Owner::VMHeap)
+    , m_superChunkCount(0)
 {
 }
 
 void VMHeap::grow()
 {
     SuperChunk* superChunk = SuperChunk::create();
+    ++m_superChunkCount;
 #if BOS(DARWIN)
     m_zone.addSuperChunk(superChunk);
 #endif
@@ -59,6 +59,8 @@ public:
     void deallocateMediumPage(std::unique_lock<StaticMutex>&, MediumPage*);
     void deallocateLargeObject(std::unique_lock<StaticMutex>&, LargeObject&);
 
+    size_t reservedBytes() { return m_superChunkCount * superChunkSize; }
+
 private:
     LargeObject allocateLargeObject(LargeObject&, size_t);
     void grow();
@@ -66,6 +68,7 @@ private:
     Vector<SmallPage*> m_smallPages;
     Vector<MediumPage*> m_mediumPages;
     SegregatedFreeList m_largeObjects;
+    size_t m_superChunkCount;
 #if BOS(DARWIN)
     Zone m_zone;
 #endif
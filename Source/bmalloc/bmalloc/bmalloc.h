@@ -69,8 +69,26 @@ inline void scavenge()
 {
     scavengeThisThread();
 
+    // Creating the heap takes the lock, so don't hold it yet
+    Heap* heap = PerProcess<Heap>::get();
     std::unique_lock<StaticMutex> lock(PerProcess<Heap>::mutex());
-    PerProcess<Heap>::get()->scavenge(lock, std::chrono::milliseconds(0));
+    heap->scavenge(lock, std::chrono::milliseconds(0), 0);
+}
+
+// Tunes the background scavenger: how long the heap must go without growing
+// before it returns memory, and how many bytes of free pages it leaves.
+inline void setScavengerParameters(std::chrono::milliseconds sleepDuration, size_t retainedBytes)
+{
+    Heap* heap = PerProcess<Heap>::get();
+    std::lock_guard<StaticMutex> lock(PerProcess<Heap>::mutex());
+    heap->setScavengerParameters(lock, sleepDuration, retainedBytes);
+}
+
+inline HeapStatistics heapStatistics()
+{
+    Heap* heap = PerProcess<Heap>::get();
+    std::lock_guard<StaticMutex> lock(PerProcess<Heap>::mutex());
+    return heap->statistics(lock);
 }
 
 } // namespace api